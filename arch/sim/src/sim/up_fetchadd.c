@@ -0,0 +1,116 @@
+/****************************************************************************
+ * arch/sim/src/sim/up_fetchadd.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_fetchadd32, up_fetchadd16, and up_fetchadd8
+ *
+ * Description:
+ *   Perform an atomic fetch add operation on the provided 32-, 16-, or 8-
+ *   bit value.
+ *
+ * Input Parameters:
+ *   addr  - The address of value to be incremented.
+ *   value - The addend
+ *
+ * Returned Value:
+ *   The incremented value (volatile!)
+ *
+ ****************************************************************************/
+
+int32_t up_fetchadd32(volatile int32_t *addr, int32_t value)
+{
+  return atomic_fetch_add((_Atomic int32_t *)addr, value) + value;
+}
+
+int16_t up_fetchadd16(volatile int16_t *addr, int16_t value)
+{
+  return atomic_fetch_add((_Atomic int16_t *)addr, value) + value;
+}
+
+int8_t up_fetchadd8(volatile int8_t *addr, int8_t value)
+{
+  return atomic_fetch_add((_Atomic int8_t *)addr, value) + value;
+}
+
+/****************************************************************************
+ * Name: up_fetchsub32, up_fetchsub16, and up_fetchsub8
+ *
+ * Description:
+ *   Perform an atomic fetch subtract operation on the provided 32-, 16-, or
+ *   8-bit value.
+ *
+ * Input Parameters:
+ *   addr  - The address of value to be decremented.
+ *   value - The subtrahend
+ *
+ * Returned Value:
+ *   The decremented value (volatile!)
+ *
+ ****************************************************************************/
+
+int32_t up_fetchsub32(volatile int32_t *addr, int32_t value)
+{
+  return atomic_fetch_sub((_Atomic int32_t *)addr, value) - value;
+}
+
+int16_t up_fetchsub16(volatile int16_t *addr, int16_t value)
+{
+  return atomic_fetch_sub((_Atomic int16_t *)addr, value) - value;
+}
+
+int8_t up_fetchsub8(volatile int8_t *addr, int8_t value)
+{
+  return atomic_fetch_sub((_Atomic int8_t *)addr, value) - value;
+}
+
+/****************************************************************************
+ * Name: up_cmpxchg16
+ *
+ * Description:
+ *   Perform an atomic compare and exchange operation on the provided 16-bit
+ *   value.
+ *
+ * Input Parameters:
+ *   addr   - The address of 16-bit value to be exchanged.
+ *   oldval - The value that is expected at addr
+ *   newval - The value to store at addr if it still holds oldval
+ *
+ * Returned Value:
+ *   true if newval was stored; false if addr did not hold oldval.
+ *
+ ****************************************************************************/
+
+bool up_cmpxchg16(volatile int16_t *addr, int16_t oldval, int16_t newval)
+{
+  return atomic_compare_exchange_strong((_Atomic int16_t *)addr, &oldval,
+                                        newval);
+}
@@ -271,6 +271,8 @@ int  simuart_open(const char *pathname);
 void simuart_close(int fd);
 int  simuart_putc(int fd, int ch);
 int  simuart_getc(int fd);
+int  simuart_write(int fd, const char *buf, size_t size);
+int  simuart_read(int fd, char *buf, size_t size);
 bool simuart_checkc(int fd);
 int  simuart_setcflag(int fd, unsigned int cflag);
 int  simuart_getcflag(int fd, unsigned int *cflag);
@@ -166,6 +166,42 @@ int simuart_getc(int fd)
   return ret < 0 ? ret : ch;
 }
 
+/****************************************************************************
+ * Name: simuart_write
+ ****************************************************************************/
+
+int simuart_write(int fd, const char *buf, size_t size)
+{
+  int ret;
+
+  ret = write(fd, buf, size);
+  return ret < 0 ? -errno : ret;
+}
+
+/****************************************************************************
+ * Name: simuart_read
+ *
+ * Description:
+ *   Read the bytes that are available now, without waiting for more.
+ *
+ ****************************************************************************/
+
+int simuart_read(int fd, char *buf, size_t size)
+{
+  struct pollfd pfd;
+  int ret;
+
+  pfd.fd     = fd;
+  pfd.events = POLLIN;
+  if (poll(&pfd, 1, 0) != 1)
+    {
+      return 0;
+    }
+
+  ret = read(fd, buf, size);
+  return ret < 0 ? -errno : ret;
+}
+
 /****************************************************************************
  * Name: simuart_getcflag
  ****************************************************************************/
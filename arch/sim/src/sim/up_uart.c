@@ -81,6 +81,12 @@ static int  tty_ioctl(FAR struct file *filep, int cmd,
 static int  tty_receive(FAR struct uart_dev_s *dev, uint32_t *status);
 static void tty_rxint(FAR struct uart_dev_s *dev, bool enable);
 static bool tty_rxavailable(FAR struct uart_dev_s *dev);
+#ifdef CONFIG_SERIAL_BULKIO
+static size_t tty_sendbuf(FAR struct uart_dev_s *dev,
+                          FAR const char *buffer, size_t buflen);
+static size_t tty_recvbuf(FAR struct uart_dev_s *dev, FAR char *buffer,
+                          size_t buflen);
+#endif
 static void tty_send(FAR struct uart_dev_s *dev, int ch);
 static void tty_txint(FAR struct uart_dev_s *dev, bool enable);
 static bool tty_txready(FAR struct uart_dev_s *dev);
@@ -104,6 +110,10 @@ static const struct uart_ops_s g_tty_ops =
   .txint          = tty_txint,
   .txready        = tty_txready,
   .txempty        = tty_txempty,
+#ifdef CONFIG_SERIAL_BULKIO
+  .sendbuf        = tty_sendbuf,
+  .recvbuf        = tty_recvbuf,
+#endif
 };
 #endif
 
@@ -415,6 +425,59 @@ static bool tty_rxavailable(struct uart_dev_s *dev)
   return simuart_checkc(dev->isconsole ? 0 : priv->fd);
 }
 
+/****************************************************************************
+ * Name: tty_sendbuf
+ *
+ * Description:
+ *   Send a contiguous span of bytes with one host write.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SERIAL_BULKIO
+static size_t tty_sendbuf(FAR struct uart_dev_s *dev,
+                          FAR const char *buffer, size_t buflen)
+{
+  FAR struct tty_priv_s *priv = dev->priv;
+  size_t i;
+  int ret;
+
+  /* The console needs \n -> \r\n, send it one byte at a time */
+
+  if (dev->isconsole)
+    {
+      for (i = 0; i < buflen; i++)
+        {
+          tty_send(dev, buffer[i]);
+        }
+
+      return buflen;
+    }
+
+  /* Drop the data on a host error, as tty_send() does */
+
+  ret = simuart_write(priv->fd, buffer, buflen);
+  return ret > 0 ? ret : buflen;
+}
+
+/****************************************************************************
+ * Name: tty_recvbuf
+ *
+ * Description:
+ *   Receive the available bytes into a contiguous span with one host read.
+ *
+ ****************************************************************************/
+
+static size_t tty_recvbuf(FAR struct uart_dev_s *dev, FAR char *buffer,
+                          size_t buflen)
+{
+  FAR struct tty_priv_s *priv = dev->priv;
+  int ret;
+
+  ret = simuart_read(dev->isconsole ? 0 : priv->fd, buffer, buflen);
+  return ret > 0 ? ret : 0;
+}
+#endif
+
 /****************************************************************************
  * Name: tty_send
  *
@@ -0,0 +1,1505 @@
+/****************************************************************************
+ * audio/audio_mixer.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/audio/audio.h>
+#include <nuttx/audio/audio_mixer.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define MIXER_RATE        CONFIG_AUDIO_MIXER_SAMPLERATE
+#define MIXER_NCHANNELS   CONFIG_AUDIO_MIXER_CHANNELS
+#define MIXER_NTAPS       CONFIG_AUDIO_MIXER_SRC_TAPS
+#define MIXER_NPHASES     CONFIG_AUDIO_MIXER_SRC_PHASES
+
+#if (MIXER_NTAPS & 1) != 0
+#  error "CONFIG_AUDIO_MIXER_SRC_TAPS must be even"
+#endif
+
+/* Output frames mixed per pass, bounds the accumulator on the stack */
+
+#define MIXER_CHUNK       32
+
+/* Size in bytes of one output frame (16-bit samples) */
+
+#define MIXER_FRAMESIZE   (2 * MIXER_NCHANNELS)
+
+/* Unity gain of the Q15 volume */
+
+#define MIXER_GAIN_ONE    32768
+
+/* The resampler position is a Q16 count of input frames */
+
+#define MIXER_POS_ONE     (1 << 16)
+#define MIXER_POS_MASK    (MIXER_POS_ONE - 1)
+
+/* Q30 constants of the filter design */
+
+#define Q30_ONE           ((int64_t)1 << 30)
+#define Q30_2PI           INT64_C(6746518852)   /* 2 * PI */
+#define Q30_BW            INT64_C(3035933484)   /* 2 * PI * 0.45 */
+#define Q30_INVPI         INT64_C(341782638)    /* 1 / PI */
+#define Q30_0P42          INT64_C(450971566)    /* 0.42 */
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct audio_mixer_s;
+
+/* This structure describes one playback port of the mixer */
+
+struct audio_mixer_port_s
+{
+  /* This is is our appearance to the outside world. This *MUST* be the
+   * first element of the structure so that we can freely cast between
+   * types struct audio_lowerhalf and struct audio_mixer_port_s.
+   */
+
+  struct audio_lowerhalf_s export;
+
+  FAR struct audio_mixer_s *mixer; /* The mixer the port belongs to */
+  dq_queue_t pendq;                /* Input buffers not consumed yet */
+  bool       reserved;             /* The port has been reserved */
+  bool       running;              /* The port is streaming */
+  bool       paused;               /* The port is paused */
+  uint8_t    nchannels;            /* Number of input channels */
+  uint8_t    bpsamp;               /* Bits per input sample */
+  uint16_t   samprate;             /* Input sample rate */
+  int32_t    gain;                 /* Q15 volume */
+
+  /* Sample-rate converter state.  coef is NULL if the input rate matches
+   * the output rate.  Otherwise it holds MIXER_NPHASES sub-filters of
+   * MIXER_NTAPS Q15 coefficients each, and hist holds the last
+   * MIXER_NTAPS input frames twice so that the filter window is always
+   * contiguous.  The remainder of the Q16 step is carried in rem so that
+   * the conversion ratio is exact.
+   */
+
+  FAR int16_t *coef;               /* Polyphase filter bank */
+  uint32_t   step;                 /* Q16 input frames per output frame */
+  uint32_t   steprem;              /* Remainder of step, in 1/MIXER_RATE */
+  uint32_t   pos;                  /* Q16 position in the input stream */
+  uint32_t   rem;                  /* Accumulated remainder of pos */
+  uint8_t    widx;                 /* Oldest frame in hist */
+  int16_t    hist[MIXER_NCHANNELS][2 * MIXER_NTAPS];
+};
+
+/* This structure describes the internal state of the audio mixer */
+
+struct audio_mixer_s
+{
+  FAR struct audio_lowerhalf_s *lower; /* The device that plays the mix */
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  FAR void  *session;              /* Session reserved on the lower half */
+#endif
+  sem_t      exclsem;              /* Serializes the ports and the worker */
+  struct work_s work;              /* Mixing work */
+  dq_queue_t freeq;                /* Output buffers owned by the mixer */
+  int        nfree;                /* Number of buffers in freeq */
+  int        nbuffers;             /* Number of output buffers */
+  bool       started;              /* The lower half is streaming */
+  int        nports;               /* Number of ports */
+  FAR struct audio_mixer_port_s *port; /* Array of ports */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static int audio_mixer_getcaps(FAR struct audio_lowerhalf_s *dev, int type,
+                               FAR struct audio_caps_s *caps);
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                                 FAR void *session,
+                                 FAR const struct audio_caps_s *caps);
+#else
+static int audio_mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                                 FAR const struct audio_caps_s *caps);
+#endif
+static int audio_mixer_shutdown(FAR struct audio_lowerhalf_s *dev);
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_start(FAR struct audio_lowerhalf_s *dev,
+                             FAR void *session);
+#else
+static int audio_mixer_start(FAR struct audio_lowerhalf_s *dev);
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_stop(FAR struct audio_lowerhalf_s *dev,
+                            FAR void *session);
+#else
+static int audio_mixer_stop(FAR struct audio_lowerhalf_s *dev);
+#endif
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_pause(FAR struct audio_lowerhalf_s *dev,
+                             FAR void *session);
+static int audio_mixer_resume(FAR struct audio_lowerhalf_s *dev,
+                              FAR void *session);
+#else
+static int audio_mixer_pause(FAR struct audio_lowerhalf_s *dev);
+static int audio_mixer_resume(FAR struct audio_lowerhalf_s *dev);
+#endif
+#endif
+static int audio_mixer_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
+                                     FAR struct ap_buffer_s *apb);
+static int audio_mixer_cancelbuffer(FAR struct audio_lowerhalf_s *dev,
+                                    FAR struct ap_buffer_s *apb);
+static int audio_mixer_ioctl(FAR struct audio_lowerhalf_s *dev, int cmd,
+                             unsigned long arg);
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_reserve(FAR struct audio_lowerhalf_s *dev,
+                               FAR void **session);
+static int audio_mixer_release(FAR struct audio_lowerhalf_s *dev,
+                               FAR void *session);
+#else
+static int audio_mixer_reserve(FAR struct audio_lowerhalf_s *dev);
+static int audio_mixer_release(FAR struct audio_lowerhalf_s *dev);
+#endif
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static void audio_mixer_callback(FAR void *arg, uint16_t reason,
+                                 FAR struct ap_buffer_s *apb,
+                                 uint16_t status,
+                                 FAR void *session);
+#else
+static void audio_mixer_callback(FAR void *arg, uint16_t reason,
+                                 FAR struct ap_buffer_s *apb,
+                                 uint16_t status);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct audio_ops_s g_audio_mixer_ops =
+{
+  audio_mixer_getcaps,       /* getcaps        */
+  audio_mixer_configure,     /* configure      */
+  audio_mixer_shutdown,      /* shutdown       */
+  audio_mixer_start,         /* start          */
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+  audio_mixer_stop,          /* stop           */
+#endif
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+  audio_mixer_pause,         /* pause          */
+  audio_mixer_resume,        /* resume         */
+#endif
+  NULL,                      /* allocbuffer    */
+  NULL,                      /* freebuffer     */
+  audio_mixer_enqueuebuffer, /* enqueue_buffer */
+  audio_mixer_cancelbuffer,  /* cancel_buffer  */
+  audio_mixer_ioctl,         /* ioctl          */
+  NULL,                      /* read           */
+  NULL,                      /* write          */
+  audio_mixer_reserve,       /* reserve        */
+  audio_mixer_release        /* release        */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: audio_mixer_sincos
+ *
+ * Description:
+ *   Q30 sine and cosine of a small angle (|x| < 0.5) by Taylor series.
+ *   The filter design only needs them for the per-tap angle increments,
+ *   the rest is done by rotation, so libm is not required.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_sincos(int64_t x, FAR int64_t *s, FAR int64_t *c)
+{
+  int64_t x2 = (x * x) >> 30;
+  int64_t t;
+
+  t = Q30_ONE - x2 / 72;
+  t = Q30_ONE - ((x2 * t) >> 30) / 42;
+  t = Q30_ONE - ((x2 * t) >> 30) / 20;
+  t = Q30_ONE - ((x2 * t) >> 30) / 6;
+  *s = (x * t) >> 30;
+
+  t = Q30_ONE - x2 / 56;
+  t = Q30_ONE - ((x2 * t) >> 30) / 30;
+  t = Q30_ONE - ((x2 * t) >> 30) / 12;
+  *c = Q30_ONE - ((x2 * t) >> 30) / 2;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_design
+ *
+ * Description:
+ *   Design the polyphase filter bank of a port: a Blackman windowed sinc
+ *   with MIXER_NTAPS * MIXER_NPHASES points.  The cut-off is 0.45 of the
+ *   lower of the input and output rates so that upsampling removes the
+ *   images and downsampling does not alias.  Every sub-filter is
+ *   normalized to unity DC gain.
+ *
+ ****************************************************************************/
+
+static int audio_mixer_design(FAR struct audio_mixer_port_s *port)
+{
+  FAR int32_t *h;
+  int64_t theta;
+  int64_t phi;
+  int64_t st;
+  int64_t ct;
+  int64_t sp;
+  int64_t cp;
+  int64_t sm = 0;
+  int64_t cm = Q30_ONE;
+  int64_t sw = 0;
+  int64_t cw = Q30_ONE;
+  int64_t tmp;
+  int half = MIXER_NTAPS / 2;
+  int m;
+  int p;
+  int k;
+
+  if (port->coef == NULL)
+    {
+      port->coef = kmm_malloc(MIXER_NTAPS * MIXER_NPHASES *
+                              sizeof(int16_t));
+      if (port->coef == NULL)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  h = kmm_malloc(MIXER_NTAPS * MIXER_NPHASES * sizeof(int32_t));
+  if (h == NULL)
+    {
+      kmm_free(port->coef);
+      port->coef = NULL;
+      return -ENOMEM;
+    }
+
+  /* theta is the sinc angle step and phi the window angle step between
+   * two points of the prototype filter, which are 1/MIXER_NPHASES input
+   * frames apart.
+   */
+
+  tmp   = port->samprate < MIXER_RATE ? port->samprate : MIXER_RATE;
+  theta = Q30_BW * tmp / port->samprate / MIXER_NPHASES;
+  phi   = Q30_2PI / (MIXER_NTAPS * MIXER_NPHASES);
+
+  audio_mixer_sincos(theta, &st, &ct);
+  audio_mixer_sincos(phi, &sp, &cp);
+
+  /* The filter is even, so compute it once for each distance m from the
+   * center and store it on both sides.  Point (p, k) is at
+   * (half - 1 - k) + p / MIXER_NPHASES input frames from the center.
+   */
+
+  for (m = 0; m <= half * MIXER_NPHASES; m++)
+    {
+      int64_t sinc;
+      int64_t win;
+      int32_t val;
+
+      if (m == 0)
+        {
+          sinc = (theta * MIXER_NPHASES * Q30_INVPI) >> 30;
+        }
+      else
+        {
+          sinc = ((sm * MIXER_NPHASES / m) * Q30_INVPI) >> 30;
+        }
+
+      /* Blackman: 0.42 + 0.5 * cos(x) + 0.08 * cos(2x) */
+
+      win = Q30_0P42 + cw / 2 + 8 * (2 * ((cw * cw) >> 30) - Q30_ONE) / 100;
+      val = (int32_t)((sinc * win) >> 30);
+
+      if (m < half * MIXER_NPHASES)
+        {
+          p = m % MIXER_NPHASES;
+          k = half - 1 - m / MIXER_NPHASES;
+          h[p * MIXER_NTAPS + k] = val;
+        }
+
+      p = (MIXER_NPHASES - m % MIXER_NPHASES) % MIXER_NPHASES;
+      k = half - 1 + (m + p) / MIXER_NPHASES;
+      if (k < MIXER_NTAPS)
+        {
+          h[p * MIXER_NTAPS + k] = val;
+        }
+
+      /* Rotate to the next point */
+
+      tmp = (sm * ct + cm * st) >> 30;
+      cm  = (cm * ct - sm * st) >> 30;
+      sm  = tmp;
+
+      tmp = (sw * cp + cw * sp) >> 30;
+      cw  = (cw * cp - sw * sp) >> 30;
+      sw  = tmp;
+    }
+
+  /* Normalize each sub-filter to unity gain in Q15 and put the rounding
+   * residue on its largest tap.
+   */
+
+  for (p = 0; p < MIXER_NPHASES; p++)
+    {
+      FAR int32_t *hp = &h[p * MIXER_NTAPS];
+      FAR int16_t *cp16 = &port->coef[p * MIXER_NTAPS];
+      int64_t sum = 0;
+      int32_t total = 0;
+      int peak = 0;
+
+      for (k = 0; k < MIXER_NTAPS; k++)
+        {
+          sum += hp[k];
+          if (hp[k] > hp[peak])
+            {
+              peak = k;
+            }
+        }
+
+      for (k = 0; k < MIXER_NTAPS; k++)
+        {
+          cp16[k] = (int16_t)(((int64_t)hp[k] * MIXER_GAIN_ONE + sum / 2) /
+                              sum);
+          total  += cp16[k];
+        }
+
+      cp16[peak] += MIXER_GAIN_ONE - total;
+    }
+
+  kmm_free(h);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_resetsrc
+ *
+ * Description:
+ *   Forget the resampler history of a port, at the start of a stream.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_resetsrc(FAR struct audio_mixer_port_s *port)
+{
+  memset(port->hist, 0, sizeof(port->hist));
+  port->widx = 0;
+  port->pos  = 0;
+  port->rem  = 0;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_upper
+ *
+ * Description:
+ *   Forward an event to the upper half of a port.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_upper(FAR struct audio_mixer_port_s *port,
+                              uint16_t reason, FAR struct ap_buffer_s *apb)
+{
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  port->export.upper(port->export.priv, reason, apb, OK, NULL);
+#else
+  port->export.upper(port->export.priv, reason, apb, OK);
+#endif
+}
+
+/****************************************************************************
+ * Name: audio_mixer_dequeue
+ *
+ * Description:
+ *   Return a consumed input buffer to the upper half of its port.  The
+ *   stream ends with the buffer flagged AUDIO_APB_FINAL.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_dequeue(FAR struct audio_mixer_port_s *port,
+                                FAR struct ap_buffer_s *apb)
+{
+  bool final = (apb->flags & AUDIO_APB_FINAL) != 0;
+
+  dq_rem(&apb->dq_entry, &port->pendq);
+  apb_free(apb);
+  audio_mixer_upper(port, AUDIO_CALLBACK_DEQUEUE, apb);
+
+  if (final)
+    {
+      audinfo("port %p complete\n", port);
+
+      port->running = false;
+      audio_mixer_upper(port, AUDIO_CALLBACK_COMPLETE, NULL);
+    }
+}
+
+/****************************************************************************
+ * Name: audio_mixer_flush
+ *
+ * Description:
+ *   Stop a port and return all of its pending buffers.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_flush(FAR struct audio_mixer_port_s *port)
+{
+  FAR struct ap_buffer_s *apb;
+
+  while ((apb = (FAR struct ap_buffer_s *)dq_peek(&port->pendq)) != NULL)
+    {
+      dq_rem(&apb->dq_entry, &port->pendq);
+      apb_free(apb);
+      audio_mixer_upper(port, AUDIO_CALLBACK_DEQUEUE, apb);
+    }
+
+  if (port->running)
+    {
+      port->running = false;
+      audio_mixer_upper(port, AUDIO_CALLBACK_COMPLETE, NULL);
+    }
+}
+
+/****************************************************************************
+ * Name: audio_mixer_getframe
+ *
+ * Description:
+ *   Read the next input frame of a port, converted to the output channel
+ *   layout.  Returns false if the port ran out of data.
+ *
+ ****************************************************************************/
+
+static bool audio_mixer_getframe(FAR struct audio_mixer_port_s *port,
+                                 FAR int32_t *frame)
+{
+  FAR struct ap_buffer_s *apb;
+  FAR const uint8_t *ptr;
+  int framesize = port->nchannels * (port->bpsamp >> 3);
+  int32_t samp[2];
+  int ch;
+
+  for (; ; )
+    {
+      apb = (FAR struct ap_buffer_s *)dq_peek(&port->pendq);
+      if (apb == NULL)
+        {
+          return false;
+        }
+
+      if (apb->curbyte + framesize <= apb->nbytes)
+        {
+          break;
+        }
+
+      /* This buffer is done, drop any partial frame left in it */
+
+      apb->curbyte = apb->nbytes;
+      audio_mixer_dequeue(port, apb);
+      if (!port->running)
+        {
+          return false;
+        }
+    }
+
+  ptr = &apb->samp[apb->curbyte];
+  apb->curbyte += framesize;
+
+  for (ch = 0; ch < port->nchannels; ch++)
+    {
+      if (port->bpsamp == 16)
+        {
+          samp[ch] = *(FAR const int16_t *)ptr;
+          ptr += 2;
+        }
+      else
+        {
+          samp[ch] = ((int32_t)*ptr++ - 128) << 8;
+        }
+    }
+
+#if MIXER_NCHANNELS == 1
+  frame[0] = port->nchannels == 2 ? (samp[0] + samp[1]) >> 1 : samp[0];
+#else
+  frame[0] = samp[0];
+  frame[1] = port->nchannels == 2 ? samp[1] : samp[0];
+#endif
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_produce
+ *
+ * Description:
+ *   Add up to nframes output frames of a port to the accumulator.  Returns
+ *   the number of frames produced, less than nframes if the port ran out
+ *   of data.
+ *
+ ****************************************************************************/
+
+static int audio_mixer_produce(FAR struct audio_mixer_port_s *port,
+                               FAR int32_t *acc, int nframes)
+{
+  int32_t frame[MIXER_NCHANNELS];
+  int ch;
+  int n;
+
+  for (n = 0; n < nframes; n++)
+    {
+      if (port->coef == NULL)
+        {
+          if (!audio_mixer_getframe(port, frame))
+            {
+              break;
+            }
+        }
+      else
+        {
+          FAR const int16_t *coef;
+          int k;
+
+          /* Pull input frames into the history until the output instant
+           * lies between its two middle frames.
+           */
+
+          while (port->pos >= MIXER_POS_ONE)
+            {
+              if (!audio_mixer_getframe(port, frame))
+                {
+                  return n;
+                }
+
+              for (ch = 0; ch < MIXER_NCHANNELS; ch++)
+                {
+                  port->hist[ch][port->widx] = (int16_t)frame[ch];
+                  port->hist[ch][port->widx + MIXER_NTAPS] =
+                    (int16_t)frame[ch];
+                }
+
+              if (++port->widx >= MIXER_NTAPS)
+                {
+                  port->widx = 0;
+                }
+
+              port->pos -= MIXER_POS_ONE;
+            }
+
+          /* Run the sub-filter of the current fractional position */
+
+          coef = &port->coef[((port->pos * MIXER_NPHASES) >> 16) *
+                             MIXER_NTAPS];
+
+          for (ch = 0; ch < MIXER_NCHANNELS; ch++)
+            {
+              FAR const int16_t *hist = &port->hist[ch][port->widx];
+              int32_t sum = 0;
+
+              for (k = 0; k < MIXER_NTAPS; k++)
+                {
+                  sum += (int32_t)coef[k] * hist[k];
+                }
+
+              frame[ch] = sum >> 15;
+            }
+
+          port->pos += port->step;
+          port->rem += port->steprem;
+          if (port->rem >= MIXER_RATE)
+            {
+              port->rem -= MIXER_RATE;
+              port->pos++;
+            }
+        }
+
+      for (ch = 0; ch < MIXER_NCHANNELS; ch++)
+        {
+          acc[n * MIXER_NCHANNELS + ch] += (frame[ch] * port->gain) >> 15;
+        }
+    }
+
+  return n;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_fill
+ *
+ * Description:
+ *   Mix the active ports into an output buffer.  Returns the number of
+ *   frames written, zero if no port had any data.
+ *
+ ****************************************************************************/
+
+static int audio_mixer_fill(FAR struct audio_mixer_s *mixer,
+                            FAR struct ap_buffer_s *apb)
+{
+  FAR int16_t *out = (FAR int16_t *)apb->samp;
+  int32_t acc[MIXER_CHUNK * MIXER_NCHANNELS];
+  int maxframes = apb->nmaxbytes / MIXER_FRAMESIZE;
+  int nframes = 0;
+
+  while (nframes < maxframes)
+    {
+      int chunk = maxframes - nframes;
+      int done = 0;
+      int i;
+
+      if (chunk > MIXER_CHUNK)
+        {
+          chunk = MIXER_CHUNK;
+        }
+
+      memset(acc, 0, sizeof(acc));
+
+      for (i = 0; i < mixer->nports; i++)
+        {
+          FAR struct audio_mixer_port_s *port = &mixer->port[i];
+          int n;
+
+          if (port->running && !port->paused)
+            {
+              n = audio_mixer_produce(port, acc, chunk);
+              if (n > done)
+                {
+                  done = n;
+                }
+            }
+        }
+
+      /* Saturate the sum.  Ports that ran short are silent for the rest
+       * of the chunk.
+       */
+
+      for (i = 0; i < done * MIXER_NCHANNELS; i++)
+        {
+          if (acc[i] > INT16_MAX)
+            {
+              acc[i] = INT16_MAX;
+            }
+          else if (acc[i] < INT16_MIN)
+            {
+              acc[i] = INT16_MIN;
+            }
+
+          *out++ = (int16_t)acc[i];
+        }
+
+      nframes += done;
+      if (done < chunk)
+        {
+          break;
+        }
+    }
+
+  return nframes;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_ready
+ *
+ * Description:
+ *   Return true if any port has data to mix.
+ *
+ ****************************************************************************/
+
+static bool audio_mixer_ready(FAR struct audio_mixer_s *mixer)
+{
+  int i;
+
+  for (i = 0; i < mixer->nports; i++)
+    {
+      FAR struct audio_mixer_port_s *port = &mixer->port[i];
+
+      if (port->running && !port->paused && !dq_empty(&port->pendq))
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_active
+ *
+ * Description:
+ *   Return true if any port is streaming.
+ *
+ ****************************************************************************/
+
+static bool audio_mixer_active(FAR struct audio_mixer_s *mixer)
+{
+  int i;
+
+  for (i = 0; i < mixer->nports; i++)
+    {
+      if (mixer->port[i].running)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_startlower
+ *
+ * Description:
+ *   Configure the lower half for the mix format and start it.
+ *
+ ****************************************************************************/
+
+static int audio_mixer_startlower(FAR struct audio_mixer_s *mixer)
+{
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+  struct audio_caps_s caps;
+  int ret;
+
+  memset(&caps, 0, sizeof(caps));
+  caps.ac_len            = sizeof(caps);
+  caps.ac_type           = AUDIO_TYPE_OUTPUT;
+  caps.ac_channels       = MIXER_NCHANNELS;
+  caps.ac_controls.hw[0] = MIXER_RATE;
+  caps.ac_controls.b[2]  = 16;
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  ret = lower->ops->configure(lower, mixer->session, &caps);
+#else
+  ret = lower->ops->configure(lower, &caps);
+#endif
+  if (ret < 0)
+    {
+      auderr("ERROR: configure failed: %d\n", ret);
+      return ret;
+    }
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  ret = lower->ops->start(lower, mixer->session);
+#else
+  ret = lower->ops->start(lower);
+#endif
+  if (ret < 0)
+    {
+      auderr("ERROR: start failed: %d\n", ret);
+      return ret;
+    }
+
+  mixer->started = true;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_work
+ *
+ * Description:
+ *   Fill the output buffers returned by the lower half while any port has
+ *   data, and stop the lower half once every port is done and all of the
+ *   output has been played.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_work(FAR void *arg)
+{
+  FAR struct audio_mixer_s *mixer = arg;
+  FAR struct audio_lowerhalf_s *lower = mixer->lower;
+  FAR struct ap_buffer_s *apb;
+  irqstate_t flags;
+  int nframes;
+  int ret;
+
+  nxsem_wait_uninterruptible(&mixer->exclsem);
+
+  while (mixer->started && audio_mixer_ready(mixer))
+    {
+      flags = enter_critical_section();
+      apb = (FAR struct ap_buffer_s *)dq_remfirst(&mixer->freeq);
+      if (apb != NULL)
+        {
+          mixer->nfree--;
+        }
+
+      leave_critical_section(flags);
+
+      if (apb == NULL)
+        {
+          break;
+        }
+
+      nframes = audio_mixer_fill(mixer, apb);
+      if (nframes == 0)
+        {
+          flags = enter_critical_section();
+          dq_addfirst(&apb->dq_entry, &mixer->freeq);
+          mixer->nfree++;
+          leave_critical_section(flags);
+          continue;
+        }
+
+      apb->nbytes  = nframes * MIXER_FRAMESIZE;
+      apb->curbyte = 0;
+      apb->flags   = 0;
+
+      ret = lower->ops->enqueuebuffer(lower, apb);
+      if (ret < 0)
+        {
+          auderr("ERROR: enqueue failed: %d\n", ret);
+
+          flags = enter_critical_section();
+          dq_addlast(&apb->dq_entry, &mixer->freeq);
+          mixer->nfree++;
+          leave_critical_section(flags);
+          break;
+        }
+    }
+
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+  if (mixer->started && !audio_mixer_active(mixer) &&
+      mixer->nfree == mixer->nbuffers)
+    {
+      audinfo("Stopping the lower half\n");
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      lower->ops->stop(lower, mixer->session);
+#else
+      lower->ops->stop(lower);
+#endif
+      mixer->started = false;
+    }
+#endif
+
+  nxsem_post(&mixer->exclsem);
+}
+
+/****************************************************************************
+ * Name: audio_mixer_kick
+ *
+ * Description:
+ *   Schedule the mixing work, may be called from interrupt level.
+ *
+ ****************************************************************************/
+
+static void audio_mixer_kick(FAR struct audio_mixer_s *mixer)
+{
+  if (work_available(&mixer->work))
+    {
+      work_queue(LPWORK, &mixer->work, audio_mixer_work, mixer, 0);
+    }
+}
+
+/****************************************************************************
+ * Name: audio_mixer_getcaps
+ *
+ * Description: Get the audio device capabilities
+ *
+ ****************************************************************************/
+
+static int audio_mixer_getcaps(FAR struct audio_lowerhalf_s *dev, int type,
+                               FAR struct audio_caps_s *caps)
+{
+  DEBUGASSERT(caps->ac_len >= sizeof(struct audio_caps_s));
+
+  caps->ac_format.hw  = 0;
+  caps->ac_controls.w = 0;
+
+  switch (caps->ac_type)
+    {
+      case AUDIO_TYPE_QUERY:
+        caps->ac_channels = 2;
+        if (caps->ac_subtype == AUDIO_TYPE_QUERY)
+          {
+            caps->ac_controls.b[0] = AUDIO_TYPE_OUTPUT | AUDIO_TYPE_FEATURE;
+          }
+        else
+          {
+            caps->ac_controls.b[0] = AUDIO_SUBFMT_END;
+          }
+
+        break;
+
+      case AUDIO_TYPE_OUTPUT:
+
+        /* Any rate is resampled, report the standard ones */
+
+        caps->ac_channels = 2;
+        if (caps->ac_subtype == AUDIO_TYPE_QUERY)
+          {
+            caps->ac_controls.b[0] = AUDIO_SAMP_RATE_8K |
+                                     AUDIO_SAMP_RATE_11K |
+                                     AUDIO_SAMP_RATE_16K |
+                                     AUDIO_SAMP_RATE_22K |
+                                     AUDIO_SAMP_RATE_32K |
+                                     AUDIO_SAMP_RATE_44K |
+                                     AUDIO_SAMP_RATE_48K;
+          }
+
+        break;
+
+      case AUDIO_TYPE_FEATURE:
+#ifndef CONFIG_AUDIO_EXCLUDE_VOLUME
+        if (caps->ac_subtype == AUDIO_FU_UNDEF)
+          {
+            caps->ac_controls.b[0] = AUDIO_FU_VOLUME;
+          }
+#endif
+
+        break;
+
+      default:
+        caps->ac_subtype  = 0;
+        caps->ac_channels = 0;
+        break;
+    }
+
+  return caps->ac_len;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_configure
+ *
+ * Description:
+ *   Configure the format of the stream played on a port.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                                 FAR void *session,
+                                 FAR const struct audio_caps_s *caps)
+#else
+static int audio_mixer_configure(FAR struct audio_lowerhalf_s *dev,
+                                 FAR const struct audio_caps_s *caps)
+#endif
+{
+  FAR struct audio_mixer_port_s *port = (FAR struct audio_mixer_port_s *)dev;
+  FAR struct audio_mixer_s *mixer = port->mixer;
+  int ret = OK;
+
+  switch (caps->ac_type)
+    {
+#ifndef CONFIG_AUDIO_EXCLUDE_VOLUME
+      case AUDIO_TYPE_FEATURE:
+        if (caps->ac_format.hw == AUDIO_FU_VOLUME)
+          {
+            uint16_t volume = caps->ac_controls.hw[0];
+
+            if (volume > 1000)
+              {
+                return -EDOM;
+              }
+
+            port->gain = (int32_t)volume * MIXER_GAIN_ONE / 1000;
+          }
+
+        break;
+#endif
+
+      case AUDIO_TYPE_OUTPUT:
+        audinfo("channels %u rate %u width %u\n", caps->ac_channels,
+                caps->ac_controls.hw[0], caps->ac_controls.b[2]);
+
+        if ((caps->ac_channels != 1 && caps->ac_channels != 2) ||
+            (caps->ac_controls.b[2] != 8 && caps->ac_controls.b[2] != 16) ||
+            caps->ac_controls.hw[0] == 0)
+          {
+            return -ERANGE;
+          }
+
+        nxsem_wait_uninterruptible(&mixer->exclsem);
+
+        port->nchannels = caps->ac_channels;
+        port->bpsamp    = caps->ac_controls.b[2];
+        port->samprate  = caps->ac_controls.hw[0];
+        port->step      = ((uint32_t)port->samprate << 16) / MIXER_RATE;
+        port->steprem   = ((uint32_t)port->samprate << 16) % MIXER_RATE;
+
+        if (port->samprate != MIXER_RATE)
+          {
+            ret = audio_mixer_design(port);
+          }
+        else if (port->coef != NULL)
+          {
+            kmm_free(port->coef);
+            port->coef = NULL;
+          }
+
+        audio_mixer_resetsrc(port);
+        nxsem_post(&mixer->exclsem);
+        break;
+
+      default:
+        break;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_shutdown
+ *
+ * Description:
+ *   The lower half is shared by the ports, so there is nothing to do.
+ *
+ ****************************************************************************/
+
+static int audio_mixer_shutdown(FAR struct audio_lowerhalf_s *dev)
+{
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_start
+ *
+ * Description:
+ *   Start streaming on a port, and the lower half if it is idle.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_start(FAR struct audio_lowerhalf_s *dev,
+                             FAR void *session)
+#else
+static int audio_mixer_start(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct audio_mixer_port_s *port = (FAR struct audio_mixer_port_s *)dev;
+  FAR struct audio_mixer_s *mixer = port->mixer;
+  int ret = OK;
+
+  nxsem_wait_uninterruptible(&mixer->exclsem);
+
+  if (!mixer->started)
+    {
+      ret = audio_mixer_startlower(mixer);
+    }
+
+  if (ret >= 0)
+    {
+      audio_mixer_resetsrc(port);
+      port->running = true;
+      port->paused  = false;
+    }
+
+  nxsem_post(&mixer->exclsem);
+
+  audio_mixer_kick(mixer);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_stop
+ *
+ * Description:
+ *   Stop streaming on a port.  The lower half is stopped by the worker
+ *   once no port is streaming.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_AUDIO_EXCLUDE_STOP
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_stop(FAR struct audio_lowerhalf_s *dev,
+                            FAR void *session)
+#else
+static int audio_mixer_stop(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct audio_mixer_port_s *port = (FAR struct audio_mixer_port_s *)dev;
+  FAR struct audio_mixer_s *mixer = port->mixer;
+
+  nxsem_wait_uninterruptible(&mixer->exclsem);
+  audio_mixer_flush(port);
+  nxsem_post(&mixer->exclsem);
+
+  audio_mixer_kick(mixer);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: audio_mixer_pause
+ *
+ * Description: Pauses the playback of a port.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_pause(FAR struct audio_lowerhalf_s *dev,
+                             FAR void *session)
+#else
+static int audio_mixer_pause(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct audio_mixer_port_s *port = (FAR struct audio_mixer_port_s *)dev;
+
+  port->paused = true;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_resume
+ *
+ * Description: Resumes the playback of a port.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_resume(FAR struct audio_lowerhalf_s *dev,
+                              FAR void *session)
+#else
+static int audio_mixer_resume(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct audio_mixer_port_s *port = (FAR struct audio_mixer_port_s *)dev;
+
+  port->paused = false;
+  audio_mixer_kick(port->mixer);
+  return OK;
+}
+#endif /* CONFIG_AUDIO_EXCLUDE_PAUSE_RESUME */
+
+/****************************************************************************
+ * Name: audio_mixer_enqueuebuffer
+ *
+ * Description: Enqueue an Audio Pipeline Buffer for mixing.
+ *
+ ****************************************************************************/
+
+static int audio_mixer_enqueuebuffer(FAR struct audio_lowerhalf_s *dev,
+                                     FAR struct ap_buffer_s *apb)
+{
+  FAR struct audio_mixer_port_s *port = (FAR struct audio_mixer_port_s *)dev;
+  FAR struct audio_mixer_s *mixer = port->mixer;
+
+  audinfo("apb=%p curbyte=%d nbytes=%d\n", apb, apb->curbyte, apb->nbytes);
+
+  apb_reference(apb);
+
+  nxsem_wait_uninterruptible(&mixer->exclsem);
+  apb->flags |= AUDIO_APB_OUTPUT_ENQUEUED;
+  dq_addlast(&apb->dq_entry, &port->pendq);
+  nxsem_post(&mixer->exclsem);
+
+  audio_mixer_kick(mixer);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_cancelbuffer
+ *
+ * Description: Called when an enqueued buffer is being cancelled.
+ *
+ ****************************************************************************/
+
+static int audio_mixer_cancelbuffer(FAR struct audio_lowerhalf_s *dev,
+                                    FAR struct ap_buffer_s *apb)
+{
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_ioctl
+ *
+ * Description: Perform a device ioctl
+ *
+ ****************************************************************************/
+
+static int audio_mixer_ioctl(FAR struct audio_lowerhalf_s *dev, int cmd,
+                             unsigned long arg)
+{
+  return -ENOTTY;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_reserve
+ *
+ * Description: Reserves a port, one client at a time.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_reserve(FAR struct audio_lowerhalf_s *dev,
+                               FAR void **session)
+#else
+static int audio_mixer_reserve(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct audio_mixer_port_s *port = (FAR struct audio_mixer_port_s *)dev;
+  FAR struct audio_mixer_s *mixer = port->mixer;
+  int ret = OK;
+
+  nxsem_wait_uninterruptible(&mixer->exclsem);
+
+  if (port->reserved)
+    {
+      ret = -EBUSY;
+    }
+  else
+    {
+      port->reserved = true;
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      *session = port;
+#endif
+    }
+
+  nxsem_post(&mixer->exclsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_release
+ *
+ * Description: Releases a port, stopping its stream.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static int audio_mixer_release(FAR struct audio_lowerhalf_s *dev,
+                               FAR void *session)
+#else
+static int audio_mixer_release(FAR struct audio_lowerhalf_s *dev)
+#endif
+{
+  FAR struct audio_mixer_port_s *port = (FAR struct audio_mixer_port_s *)dev;
+  FAR struct audio_mixer_s *mixer = port->mixer;
+
+  nxsem_wait_uninterruptible(&mixer->exclsem);
+  audio_mixer_flush(port);
+  port->reserved = false;
+  nxsem_post(&mixer->exclsem);
+
+  audio_mixer_kick(mixer);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: audio_mixer_callback
+ *
+ * Description:
+ *   Lower-to-upper level callback.  Output buffers that the lower half is
+ *   done with go back to the free queue and the worker refills them.
+ *   This may run at interrupt level.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+static void audio_mixer_callback(FAR void *arg, uint16_t reason,
+                                 FAR struct ap_buffer_s *apb,
+                                 uint16_t status,
+                                 FAR void *session)
+#else
+static void audio_mixer_callback(FAR void *arg, uint16_t reason,
+                                 FAR struct ap_buffer_s *apb,
+                                 uint16_t status)
+#endif
+{
+  FAR struct audio_mixer_s *mixer = arg;
+  irqstate_t flags;
+
+  switch (reason)
+    {
+      case AUDIO_CALLBACK_DEQUEUE:
+        flags = enter_critical_section();
+        dq_addlast(&apb->dq_entry, &mixer->freeq);
+        mixer->nfree++;
+        leave_critical_section(flags);
+
+        audio_mixer_kick(mixer);
+        break;
+
+      case AUDIO_CALLBACK_IOERR:
+        auderr("ERROR: I/O error %u\n", status);
+        break;
+
+      default:
+        break;
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: audio_mixer_initialize
+ *
+ * Description:
+ *   Initialize the software audio mixer on top of a lower half audio
+ *   device.
+ *
+ * Input Parameters:
+ *   name   - The base name of the audio devices.
+ *   nports - The number of playback devices to create.
+ *   lower  - The lower half audio driver that plays the mix.
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int audio_mixer_initialize(FAR const char *name, int nports,
+                           FAR struct audio_lowerhalf_s *lower)
+{
+  FAR struct audio_mixer_s *mixer;
+  struct audio_buf_desc_s bufdesc;
+  FAR struct ap_buffer_s *apb;
+  char devname[32];
+  int ret;
+  int i;
+
+  DEBUGASSERT(name != NULL && nports > 0 && lower != NULL);
+
+  mixer = kmm_zalloc(sizeof(struct audio_mixer_s) +
+                     nports * sizeof(struct audio_mixer_port_s));
+  if (mixer == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  mixer->lower  = lower;
+  mixer->nports = nports;
+  mixer->port   = (FAR struct audio_mixer_port_s *)(mixer + 1);
+  nxsem_init(&mixer->exclsem, 0, 1);
+
+  lower->upper = audio_mixer_callback;
+  lower->priv  = mixer;
+
+  /* The lower half belongs to the mixer for good */
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  ret = lower->ops->reserve(lower, &mixer->session);
+#else
+  ret = lower->ops->reserve(lower);
+#endif
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  /* Allocate the output buffers */
+
+  for (i = 0; i < CONFIG_AUDIO_NUM_BUFFERS; i++)
+    {
+      memset(&bufdesc, 0, sizeof(bufdesc));
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+      bufdesc.session   = mixer->session;
+#endif
+      bufdesc.numbytes  = CONFIG_AUDIO_BUFFER_NUMBYTES;
+      bufdesc.u.pbuffer = &apb;
+
+      if (lower->ops->allocbuffer != NULL)
+        {
+          ret = lower->ops->allocbuffer(lower, &bufdesc);
+        }
+      else
+        {
+          ret = apb_alloc(&bufdesc);
+        }
+
+      if (ret < 0)
+        {
+          goto errout_with_buffers;
+        }
+
+      dq_addlast(&apb->dq_entry, &mixer->freeq);
+      mixer->nbuffers++;
+      mixer->nfree++;
+    }
+
+  /* Register the ports */
+
+  for (i = 0; i < nports; i++)
+    {
+      FAR struct audio_mixer_port_s *port = &mixer->port[i];
+
+      port->export.ops = &g_audio_mixer_ops;
+      port->mixer      = mixer;
+      port->nchannels  = MIXER_NCHANNELS;
+      port->bpsamp     = 16;
+      port->samprate   = MIXER_RATE;
+      port->step       = MIXER_POS_ONE;
+      port->gain       = MIXER_GAIN_ONE;
+
+      snprintf(devname, sizeof(devname), "%s%d", name, i);
+      ret = audio_register(devname, &port->export);
+      if (ret < 0)
+        {
+          auderr("ERROR: Failed to register %s: %d\n", devname, ret);
+
+          /* REVISIT: The ports registered already cannot be unregistered
+           * and keep the mixer alive.
+           */
+
+          if (i > 0)
+            {
+              return ret;
+            }
+
+          goto errout_with_buffers;
+        }
+    }
+
+  return OK;
+
+errout_with_buffers:
+  while ((apb = (FAR struct ap_buffer_s *)dq_remfirst(&mixer->freeq))
+         != NULL)
+    {
+      bufdesc.u.buffer = apb;
+      if (lower->ops->freebuffer != NULL)
+        {
+          lower->ops->freebuffer(lower, &bufdesc);
+        }
+      else
+        {
+          apb_free(apb);
+        }
+    }
+
+#ifdef CONFIG_AUDIO_MULTI_SESSION
+  lower->ops->release(lower, mixer->session);
+#else
+  lower->ops->release(lower);
+#endif
+
+errout:
+  nxsem_destroy(&mixer->exclsem);
+  kmm_free(mixer);
+  return ret;
+}
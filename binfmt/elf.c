@@ -46,6 +46,7 @@
 #include <errno.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/clock.h>
 #include <nuttx/binfmt/binfmt.h>
 #include <nuttx/binfmt/elf.h>
 
@@ -224,6 +225,9 @@ static void elf_dumpentrypt(FAR struct binary_s *binp,
 static int elf_loadbinary(FAR struct binary_s *binp)
 {
   struct elf_loadinfo_s loadinfo;  /* Contains globals for libelf */
+#ifdef CONFIG_DEBUG_BINFMT_INFO
+  clock_t               start = clock_systime_ticks();
+#endif
   int                   ret;
 
   binfo("Loading file: %s\n", binp->filename);
@@ -259,7 +263,8 @@ static int elf_loadbinary(FAR struct binary_s *binp)
 
   /* Return the load information */
 
-  binp->entrypt   = (main_t)(loadinfo.textalloc + loadinfo.ehdr.e_entry);
+  binp->entrypt   = (main_t)(ELF_TEXTBASE(&loadinfo) +
+                             loadinfo.ehdr.e_entry);
   binp->stacksize = CONFIG_ELF_STACKSIZE;
 
   /* Add the ELF allocation to the alloc[] only if there is no address
@@ -296,6 +301,9 @@ static int elf_loadbinary(FAR struct binary_s *binp)
 
   elf_dumpentrypt(binp, &loadinfo);
   elf_uninit(&loadinfo);
+
+  binfo("Loaded %s in %lu ms\n", binp->filename,
+        (unsigned long)TICK2MSEC(clock_systime_ticks() - start));
   return OK;
 
 errout_with_load:
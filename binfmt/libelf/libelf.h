@@ -47,6 +47,21 @@
 #include <nuttx/arch.h>
 #include <nuttx/binfmt/elf.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The run-time address of the first .text section.  Offsets like e_entry
+ * are relative to this address.  Without XIP support, the first .text
+ * section is always at the beginning of the text allocation.
+ */
+
+#ifdef CONFIG_ELF_XIP
+#  define ELF_TEXTBASE(l) ((l)->textbase)
+#else
+#  define ELF_TEXTBASE(l) ((l)->textalloc)
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -152,6 +167,22 @@ int elf_findsymtab(FAR struct elf_loadinfo_s *loadinfo);
 int elf_readsym(FAR struct elf_loadinfo_s *loadinfo, int index,
                 FAR Elf_Sym *sym);
 
+/****************************************************************************
+ * Name: elf_loadsymtab
+ *
+ * Description:
+ *   Read the entire symbol table and its string table into memory.
+ *
+ * Returned Value:
+ *   0 (OK) is returned on success and a negated errno is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ELF_LOADSYMTAB
+int elf_loadsymtab(FAR struct elf_loadinfo_s *loadinfo);
+#endif
+
 /****************************************************************************
  * Name: elf_symvalue
  *
@@ -585,6 +585,19 @@ int elf_bind(FAR struct elf_loadinfo_s *loadinfo,
       return ret;
     }
 
+#ifdef CONFIG_ELF_LOADSYMTAB
+  /* Read the symbol and string tables into memory in one pass.  This is
+   * only an optimization; if it fails, symbols are read from the file on
+   * demand.
+   */
+
+  ret = elf_loadsymtab(loadinfo);
+  if (ret < 0)
+    {
+      bwarn("WARNING: elf_loadsymtab failed: %d\n", ret);
+    }
+#endif
+
   /* Allocate an I/O buffer.  This buffer is used by elf_symname() to
    * accumulate the variable length symbol name.
    */
@@ -193,10 +193,10 @@ int elf_loaddtors(FAR struct elf_loadinfo_s *loadinfo)
                   ((FAR void *)(&loadinfo->dtors)[i]);
 
               binfo("dtor %d: %08lx + %08lx = %08lx\n",
-                    i, *ptr, (unsigned long)loadinfo->textalloc,
-                    (unsigned long)(*ptr + loadinfo->textalloc));
+                    i, *ptr, (unsigned long)ELF_TEXTBASE(loadinfo),
+                    (unsigned long)(*ptr + ELF_TEXTBASE(loadinfo)));
 
-              *ptr += loadinfo->textalloc;
+              *ptr += ELF_TEXTBASE(loadinfo);
             }
         }
       else
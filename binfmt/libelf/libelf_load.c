@@ -40,8 +40,11 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <sys/ioctl.h>
+#include <sys/statfs.h>
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
@@ -52,6 +55,8 @@
 #include <nuttx/arch.h>
 #include <nuttx/addrenv.h>
 #include <nuttx/elf.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/mm/mm.h>
 #include <nuttx/binfmt/elf.h>
 
@@ -81,6 +86,93 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: elf_xipinit
+ *
+ * Description:
+ *   Determine whether the ELF file lies on a ROMFS file system that is
+ *   backed by execute-in-place media and, if so, save the address of the
+ *   start of the file in that media.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ELF_XIP
+static void elf_xipinit(FAR struct elf_loadinfo_s *loadinfo)
+{
+  struct statfs buf;
+  FAR void *addr;
+  int ret;
+
+  loadinfo->xipbase = 0;
+
+  /* Only ROMFS is used in place.  Other file systems supporting FIOC_MMAP
+   * (such as TMPFS) are writable, so the file could be modified or
+   * deleted while the program is running.
+   */
+
+  ret = fstatfs(loadinfo->filfd, &buf);
+  if (ret < 0 || buf.f_type != ROMFS_MAGIC)
+    {
+      return;
+    }
+
+  ret = nx_ioctl(loadinfo->filfd, FIOC_MMAP,
+                 (unsigned long)((uintptr_t)&addr));
+  if (ret >= 0)
+    {
+      binfo("XIP base: %p\n", addr);
+      loadinfo->xipbase = (uintptr_t)addr;
+    }
+}
+
+/****************************************************************************
+ * Name: elf_xipsection
+ *
+ * Description:
+ *   Return true if the section can be used in place from the XIP media
+ *   rather than being copied into memory.  This is only possible for
+ *   read-only sections with data in the file that are suitably aligned and
+ *   that are not modified by any relocation.
+ *
+ ****************************************************************************/
+
+static bool elf_xipsection(FAR struct elf_loadinfo_s *loadinfo, int idx)
+{
+  FAR Elf_Shdr *shdr = &loadinfo->shdr[idx];
+  int i;
+
+  if (loadinfo->xipbase == 0 ||
+      (shdr->sh_flags & (SHF_ALLOC | SHF_WRITE)) != SHF_ALLOC ||
+      shdr->sh_type == SHT_NOBITS)
+    {
+      return false;
+    }
+
+  if (shdr->sh_addralign > 1 &&
+      ((loadinfo->xipbase + shdr->sh_offset) &
+       (shdr->sh_addralign - 1)) != 0)
+    {
+      return false;
+    }
+
+  for (i = 1; i < loadinfo->ehdr.e_shnum; i++)
+    {
+      FAR Elf_Shdr *relsec = &loadinfo->shdr[i];
+
+      if ((relsec->sh_type == SHT_REL || relsec->sh_type == SHT_RELA) &&
+          relsec->sh_info == idx)
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+#else
+#  define elf_xipinit(l)
+#  define elf_xipsection(l,i) false
+#endif
+
 /****************************************************************************
  * Name: elf_elfsize
  *
@@ -122,7 +214,7 @@ static void elf_elfsize(struct elf_loadinfo_s *loadinfo)
             {
               datasize += ELF_ALIGNUP(shdr->sh_size);
             }
-          else
+          else if (!elf_xipsection(loadinfo, i))
             {
               textsize += ELF_ALIGNUP(shdr->sh_size);
             }
@@ -175,6 +267,27 @@ static inline int elf_loadfile(FAR struct elf_loadinfo_s *loadinfo)
           continue;
         }
 
+#ifdef CONFIG_ELF_XIP
+      /* Sections that can be executed in place are not copied; just point
+       * them at the file data in the XIP media.
+       */
+
+      if (elf_xipsection(loadinfo, i))
+        {
+          binfo("%d. %08lx->%08lx (XIP)\n", i,
+                (unsigned long)shdr->sh_addr,
+                (unsigned long)(loadinfo->xipbase + shdr->sh_offset));
+
+          shdr->sh_addr = loadinfo->xipbase + shdr->sh_offset;
+          if (loadinfo->textbase == 0)
+            {
+              loadinfo->textbase = shdr->sh_addr;
+            }
+
+          continue;
+        }
+#endif
+
       /* SHF_WRITE indicates that the section address space is write-
        * able
        */
@@ -220,6 +333,13 @@ static inline int elf_loadfile(FAR struct elf_loadinfo_s *loadinfo)
 
       shdr->sh_addr = (uintptr_t)*pptr;
 
+#ifdef CONFIG_ELF_XIP
+      if (pptr == &text && loadinfo->textbase == 0)
+        {
+          loadinfo->textbase = shdr->sh_addr;
+        }
+#endif
+
       /* Setup the memory pointer for the next time through the loop */
 
       *pptr += ELF_ALIGNUP(shdr->sh_size);
@@ -265,6 +385,10 @@ int elf_load(FAR struct elf_loadinfo_s *loadinfo)
       goto errout_with_buffers;
     }
 
+  /* Check if the file can be used in place */
+
+  elf_xipinit(loadinfo);
+
   /* Determine total size to allocate */
 
   elf_elfsize(loadinfo);
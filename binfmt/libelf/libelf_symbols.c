@@ -44,6 +44,7 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/kmalloc.h>
 #include <nuttx/binfmt/elf.h>
 #include <nuttx/binfmt/symtab.h>
 
@@ -65,7 +66,8 @@
  * Name: elf_symname
  *
  * Description:
- *   Get the symbol name in loadinfo->iobuffer[].
+ *   Get the symbol name.  The name is returned in 'name' and refers either
+ *   to the in-memory string table or to loadinfo->iobuffer[].
  *
  * Returned Value:
  *   0 (OK) is returned on success and a negated errno is returned on
@@ -78,7 +80,8 @@
  ****************************************************************************/
 
 static int elf_symname(FAR struct elf_loadinfo_s *loadinfo,
-                       FAR const Elf_Sym *sym)
+                       FAR const Elf_Sym *sym,
+                       FAR const char **name)
 {
   FAR uint8_t *buffer;
   off_t  offset;
@@ -96,6 +99,22 @@ static int elf_symname(FAR struct elf_loadinfo_s *loadinfo,
       return -ESRCH;
     }
 
+#ifdef CONFIG_ELF_LOADSYMTAB
+  /* If the string table was read into memory, just point into it */
+
+  if (loadinfo->strtab != NULL)
+    {
+      if (sym->st_name >= loadinfo->shdr[loadinfo->strtabidx].sh_size)
+        {
+          berr("Symbol name offset out of range\n");
+          return -EINVAL;
+        }
+
+      *name = &loadinfo->strtab[sym->st_name];
+      return OK;
+    }
+#endif
+
   offset = loadinfo->shdr[loadinfo->strtabidx].sh_offset + sym->st_name;
 
   /* Loop until we get the entire symbol name into memory */
@@ -136,6 +155,7 @@ static int elf_symname(FAR struct elf_loadinfo_s *loadinfo,
         {
           /* Yes, the buffer contains a NUL terminator. */
 
+          *name = (FAR const char *)loadinfo->iobuffer;
           return OK;
         }
 
@@ -222,12 +242,22 @@ int elf_readsym(FAR struct elf_loadinfo_s *loadinfo, int index,
 
   /* Verify that the symbol table index lies within symbol table */
 
-  if (index < 0 || index > (symtab->sh_size / sizeof(Elf_Sym)))
+  if (index < 0 || index >= (symtab->sh_size / sizeof(Elf_Sym)))
     {
       berr("Bad relocation symbol index: %d\n", index);
       return -EINVAL;
     }
 
+#ifdef CONFIG_ELF_LOADSYMTAB
+  /* Copy the entry from the in-memory symbol table if there is one */
+
+  if (loadinfo->symtab != NULL)
+    {
+      *sym = loadinfo->symtab[index];
+      return OK;
+    }
+#endif
+
   /* Get the file offset to the symbol table entry */
 
   offset = symtab->sh_offset + sizeof(Elf_Sym) * index;
@@ -237,6 +267,78 @@ int elf_readsym(FAR struct elf_loadinfo_s *loadinfo, int index,
   return elf_read(loadinfo, (FAR uint8_t *)sym, sizeof(Elf_Sym), offset);
 }
 
+/****************************************************************************
+ * Name: elf_loadsymtab
+ *
+ * Description:
+ *   Read the entire symbol table and its string table into memory so that
+ *   symbol lookups during relocation do not need to access the file.
+ *
+ * Input Parameters:
+ *   loadinfo - Load state information
+ *
+ * Returned Value:
+ *   0 (OK) is returned on success and a negated errno is returned on
+ *   failure.  On failure, no memory remains allocated and symbols will be
+ *   read from the file on demand.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ELF_LOADSYMTAB
+int elf_loadsymtab(FAR struct elf_loadinfo_s *loadinfo)
+{
+  FAR Elf_Shdr *symtab = &loadinfo->shdr[loadinfo->symtabidx];
+  FAR Elf_Shdr *strtab = &loadinfo->shdr[loadinfo->strtabidx];
+  int ret;
+
+  /* Allocate one extra byte for the string table so that it is always
+   * NUL terminated, even if the file is corrupted.
+   */
+
+  loadinfo->symtab = (FAR Elf_Sym *)kmm_malloc(symtab->sh_size);
+  loadinfo->strtab = (FAR char *)kmm_malloc(strtab->sh_size + 1);
+  if (loadinfo->symtab == NULL || loadinfo->strtab == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  ret = elf_read(loadinfo, (FAR uint8_t *)loadinfo->symtab,
+                 symtab->sh_size, symtab->sh_offset);
+  if (ret < 0)
+    {
+      berr("Failed to read symbol table: %d\n", ret);
+      goto errout;
+    }
+
+  ret = elf_read(loadinfo, (FAR uint8_t *)loadinfo->strtab,
+                 strtab->sh_size, strtab->sh_offset);
+  if (ret < 0)
+    {
+      berr("Failed to read string table: %d\n", ret);
+      goto errout;
+    }
+
+  loadinfo->strtab[strtab->sh_size] = '\0';
+  return OK;
+
+errout:
+  if (loadinfo->symtab != NULL)
+    {
+      kmm_free(loadinfo->symtab);
+      loadinfo->symtab = NULL;
+    }
+
+  if (loadinfo->strtab != NULL)
+    {
+      kmm_free(loadinfo->strtab);
+      loadinfo->strtab = NULL;
+    }
+
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: elf_symvalue
  *
@@ -264,6 +366,7 @@ int elf_symvalue(FAR struct elf_loadinfo_s *loadinfo, FAR Elf_Sym *sym,
                  FAR const struct symtab_s *exports, int nexports)
 {
   FAR const struct symtab_s *symbol;
+  FAR const char *name;
   uintptr_t secbase;
   int ret;
 
@@ -289,7 +392,7 @@ int elf_symvalue(FAR struct elf_loadinfo_s *loadinfo, FAR Elf_Sym *sym,
       {
         /* Get the name of the undefined symbol */
 
-        ret = elf_symname(loadinfo, sym);
+        ret = elf_symname(loadinfo, sym, &name);
         if (ret < 0)
           {
             /* There are a few relocations for a few architectures that do
@@ -305,17 +408,14 @@ int elf_symvalue(FAR struct elf_loadinfo_s *loadinfo, FAR Elf_Sym *sym,
         /* Check if the base code exports a symbol of this name */
 
 #ifdef CONFIG_SYMTAB_ORDEREDBYNAME
-        symbol = symtab_findorderedbyname(exports,
-                                          (FAR char *)loadinfo->iobuffer,
-                                          nexports);
+        symbol = symtab_findorderedbyname(exports, name, nexports);
 #else
-        symbol = symtab_findbyname(exports, (FAR char *)loadinfo->iobuffer,
-                                   nexports);
+        symbol = symtab_findbyname(exports, name, nexports);
 #endif
         if (!symbol)
           {
             berr("SHN_UNDEF: Exported symbol \"%s\" not found\n",
-                 loadinfo->iobuffer);
+                 name);
             return -ENOENT;
           }
 
@@ -324,7 +424,7 @@ int elf_symvalue(FAR struct elf_loadinfo_s *loadinfo, FAR Elf_Sym *sym,
          */
 
         binfo("SHN_UNDEF: name=%s %08x+%08x=%08x\n",
-              loadinfo->iobuffer, sym->st_value, symbol->sym_value,
+              name, sym->st_value, symbol->sym_value,
               sym->st_value + symbol->sym_value);
 
         sym->st_value += ((uintptr_t)symbol->sym_value);
@@ -122,5 +122,19 @@ int elf_freebuffers(struct elf_loadinfo_s *loadinfo)
       loadinfo->buflen    = 0;
     }
 
+#ifdef CONFIG_ELF_LOADSYMTAB
+  if (loadinfo->symtab != NULL)
+    {
+      kmm_free((FAR void *)loadinfo->symtab);
+      loadinfo->symtab    = NULL;
+    }
+
+  if (loadinfo->strtab != NULL)
+    {
+      kmm_free((FAR void *)loadinfo->strtab);
+      loadinfo->strtab    = NULL;
+    }
+#endif
+
   return OK;
 }
@@ -29,6 +29,7 @@
 #include <errno.h>
 #include <stdio.h>
 
+#include <nuttx/irq.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/kthread.h>
 #include <nuttx/semaphore.h>
@@ -132,6 +133,14 @@
 
 #define NET_RPMSG_DRV_WDDELAY      (1*CLK_TCK)
 
+/* Number of received frames that may be held for the work queue */
+
+#ifndef CONFIG_NET_RPMSG_RXQUEUE
+#  define CONFIG_NET_RPMSG_RXQUEUE 0
+#endif
+
+#define NET_RPMSG_DRV_NRXQUEUE     CONFIG_NET_RPMSG_RXQUEUE
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -154,6 +163,17 @@ struct net_rpmsg_drv_s
   struct wdog_s         txpoll;   /* TX poll timer */
   struct work_s         pollwork; /* For deferring poll work to the work queue */
 
+#if NET_RPMSG_DRV_NRXQUEUE > 0
+  /* Received frames whose rpmsg buffers are held until the network has
+   * consumed them.
+   */
+
+  struct work_s         rxwork;   /* For deferring RX work to the work queue */
+  uint8_t               rxtail;   /* Next rxqueue[] slot to dispatch */
+  uint8_t               rxcount;  /* Number of frames in rxqueue[] */
+  FAR struct net_rpmsg_transfer_s *rxqueue[NET_RPMSG_DRV_NRXQUEUE];
+#endif
+
   /* This holds the information visible to the NuttX network */
 
   struct net_driver_s  dev;      /* Interface understood by the network */
@@ -178,6 +198,12 @@ static int net_rpmsg_drv_default_handler(FAR struct rpmsg_endpoint *ept,
 static int net_rpmsg_drv_sockioctl_handler(FAR struct rpmsg_endpoint *ept,
                                            FAR void *data, size_t len,
                                            uint32_t src, FAR void *priv);
+static void net_rpmsg_drv_receive(FAR struct net_driver_s *dev,
+                                  FAR struct net_rpmsg_transfer_s *msg);
+#if NET_RPMSG_DRV_NRXQUEUE > 0
+static void net_rpmsg_drv_rxdrain(FAR struct net_driver_s *dev);
+static void net_rpmsg_drv_rxwork(FAR void *arg);
+#endif
 static int net_rpmsg_drv_transfer_handler(FAR struct rpmsg_endpoint *ept,
                                           FAR void *data, size_t len,
                                           uint32_t src, FAR void *priv);
@@ -574,38 +600,29 @@ static bool net_rpmsg_drv_is_arp(FAR struct net_driver_s *dev)
 #endif
 
 /****************************************************************************
- * Name: net_rpmsg_drv_transfer_handler
+ * Name: net_rpmsg_drv_receive
  *
  * Description:
- *   An message was received indicating the availability of a new RX packet
+ *   Dispatch one received frame to the network.  The frame is processed in
+ *   place in the rpmsg RX buffer.
  *
  * Parameters:
- *   ept - Reference to the endpoint which receive the message
+ *   dev - Reference to the NuttX driver state structure
+ *   msg - The received transfer message
  *
  * Returned Value:
- *   OK on success
+ *   None
  *
  * Assumptions:
  *   The network is locked.
  *
  ****************************************************************************/
 
-static int net_rpmsg_drv_transfer_handler(FAR struct rpmsg_endpoint *ept,
-                                          FAR void *data, size_t len,
-                                          uint32_t src, FAR void *priv)
+static void net_rpmsg_drv_receive(FAR struct net_driver_s *dev,
+                                  FAR struct net_rpmsg_transfer_s *msg)
 {
-  FAR struct net_driver_s *dev = ept->priv;
-  FAR struct net_rpmsg_transfer_s *msg = data;
   FAR void *oldbuf;
 
-  /* Lock the network and serialize driver operations if necessary.
-   * NOTE: Serialization is only required in the case where the driver work
-   * is performed on an LP worker thread and where more than one LP worker
-   * thread has been configured.
-   */
-
-  net_lock();
-
   /* Check for errors and update statistics */
 
   net_rpmsg_drv_dumppacket("receive", msg->data, msg->length);
@@ -685,6 +702,154 @@ static int net_rpmsg_drv_transfer_handler(FAR struct rpmsg_endpoint *ept,
     }
 
   dev->d_buf = oldbuf;
+}
+
+#if NET_RPMSG_DRV_NRXQUEUE > 0
+/****************************************************************************
+ * Name: net_rpmsg_drv_rxdrain
+ *
+ * Description:
+ *   Dispatch all held frames to the network, in order of arrival, and
+ *   return their buffers to the remote.
+ *
+ * Parameters:
+ *   dev - Reference to the NuttX driver state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.  Holding the lock while dequeuing keeps the
+ *   frames in order when the work queue and the rpmsg callback drain the
+ *   queue at the same time.
+ *
+ ****************************************************************************/
+
+static void net_rpmsg_drv_rxdrain(FAR struct net_driver_s *dev)
+{
+  FAR struct net_rpmsg_drv_s *priv = dev->d_private;
+  FAR struct net_rpmsg_transfer_s *msg;
+  irqstate_t flags;
+
+  for (; ; )
+    {
+      flags = enter_critical_section();
+      if (priv->rxcount == 0)
+        {
+          leave_critical_section(flags);
+          break;
+        }
+
+      msg = priv->rxqueue[priv->rxtail];
+      if (++priv->rxtail >= NET_RPMSG_DRV_NRXQUEUE)
+        {
+          priv->rxtail = 0;
+        }
+
+      priv->rxcount--;
+      leave_critical_section(flags);
+
+      net_rpmsg_drv_receive(dev, msg);
+      rpmsg_release_rx_buffer(&priv->ept, msg);
+    }
+}
+
+/****************************************************************************
+ * Name: net_rpmsg_drv_rxwork
+ *
+ * Description:
+ *   Work queue handler that passes held frames to the network.
+ *
+ * Parameters:
+ *   arg - Reference to the NuttX driver state structure (cast to void*)
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void net_rpmsg_drv_rxwork(FAR void *arg)
+{
+  FAR struct net_driver_s *dev = arg;
+
+  /* Lock the network and serialize driver operations if necessary.
+   * NOTE: Serialization is only required in the case where the driver work
+   * is performed on an LP worker thread and where more than one LP worker
+   * thread has been configured.
+   */
+
+  net_lock();
+  net_rpmsg_drv_rxdrain(dev);
+  net_unlock();
+}
+#endif
+
+/****************************************************************************
+ * Name: net_rpmsg_drv_transfer_handler
+ *
+ * Description:
+ *   An message was received indicating the availability of a new RX packet
+ *
+ *   If CONFIG_NET_RPMSG_RXQUEUE is non-zero, the rpmsg buffer is held and
+ *   the frame is handed to the network on the LP work queue, so that the
+ *   rpmsg receive thread never waits for the network lock.  The buffer is
+ *   released once the network has consumed the frame.
+ *
+ * Parameters:
+ *   ept - Reference to the endpoint which receive the message
+ *
+ * Returned Value:
+ *   OK on success
+ *
+ ****************************************************************************/
+
+static int net_rpmsg_drv_transfer_handler(FAR struct rpmsg_endpoint *ept,
+                                          FAR void *data, size_t len,
+                                          uint32_t src, FAR void *priv)
+{
+  FAR struct net_driver_s *dev = ept->priv;
+  FAR struct net_rpmsg_transfer_s *msg = data;
+#if NET_RPMSG_DRV_NRXQUEUE > 0
+  FAR struct net_rpmsg_drv_s *drv = dev->d_private;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  if (drv->rxcount < NET_RPMSG_DRV_NRXQUEUE)
+    {
+      int ndx = drv->rxtail + drv->rxcount;
+
+      if (ndx >= NET_RPMSG_DRV_NRXQUEUE)
+        {
+          ndx -= NET_RPMSG_DRV_NRXQUEUE;
+        }
+
+      rpmsg_hold_rx_buffer(ept, data);
+      drv->rxqueue[ndx] = msg;
+      drv->rxcount++;
+      leave_critical_section(flags);
+
+      work_queue(LPWORK, &drv->rxwork, net_rpmsg_drv_rxwork, dev, 0);
+      return 0;
+    }
+
+  leave_critical_section(flags);
+#endif
+
+  /* Lock the network and serialize driver operations if necessary.
+   * NOTE: Serialization is only required in the case where the driver work
+   * is performed on an LP worker thread and where more than one LP worker
+   * thread has been configured.
+   */
+
+  net_lock();
+
+#if NET_RPMSG_DRV_NRXQUEUE > 0
+  /* The queue is full: catch up inline, keeping the frames in order */
+
+  net_rpmsg_drv_rxdrain(dev);
+#endif
+
+  net_rpmsg_drv_receive(dev, msg);
   net_unlock();
 
   return 0;
@@ -716,6 +881,16 @@ static void net_rpmsg_drv_device_destroy(FAR struct rpmsg_device *rdev,
 
   if (!strcmp(priv->cpuname, rpmsg_get_cpuname(rdev)))
     {
+#if NET_RPMSG_DRV_NRXQUEUE > 0
+      /* Give the held RX buffers back before the endpoint goes away */
+
+      work_cancel(LPWORK, &priv->rxwork);
+
+      net_lock();
+      net_rpmsg_drv_rxdrain(dev);
+      net_unlock();
+#endif
+
       rpmsg_destroy_ept(&priv->ept);
       dev->d_buf = NULL;
     }
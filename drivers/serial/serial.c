@@ -82,6 +82,8 @@ static void    uart_pollnotify(FAR uart_dev_t *dev, pollevent_t eventset);
 /* Write support */
 
 static int     uart_putxmitchar(FAR uart_dev_t *dev, int ch, bool oktoblock);
+static size_t  uart_putxmitbuf(FAR uart_dev_t *dev, FAR const char *buffer,
+                               size_t buflen);
 static inline ssize_t uart_irqwrite(FAR uart_dev_t *dev, FAR const char *buffer,
                                     size_t buflen);
 static int     uart_tcdrain(FAR uart_dev_t *dev, clock_t timeout);
@@ -338,6 +340,96 @@ err_out:
   return ret;
 }
 
+/************************************************************************************
+ * Name: uart_putxmitbuf
+ *
+ * Description:
+ *   Copy the leading bytes of the caller's buffer that need no output processing
+ *   into the TX buffer, as many as fit without waiting.  Returns the number of
+ *   bytes copied, which may be zero.
+ *
+ ************************************************************************************/
+
+static size_t uart_putxmitbuf(FAR uart_dev_t *dev, FAR const char *buffer,
+                              size_t buflen)
+{
+  FAR struct uart_buffer_s *txbuf = &dev->xmit;
+  bool postcr = false;
+  bool postnl = false;
+  size_t nbytes;
+  size_t nfree;
+  size_t first;
+  int head;
+
+#ifdef CONFIG_SMP
+  irqstate_t flags = enter_critical_section();
+#endif
+
+  /* The interrupt level logic may advance the tail but does not touch the
+   * head, so the space computed here can only be an underestimate.
+   */
+
+  head  = txbuf->head;
+  nfree = (txbuf->tail - head - 1 + txbuf->size) % txbuf->size;
+
+  nbytes = buflen < nfree ? buflen : nfree;
+
+  /* Which characters does uart_write() have to expand? */
+
+#ifdef CONFIG_SERIAL_TERMIOS
+  if ((dev->tc_oflag & OPOST) != 0)
+    {
+      postcr = (dev->tc_oflag & OCRNL) != 0;
+      postnl = (dev->tc_oflag & (ONLCR | ONLRET)) != 0;
+    }
+#else
+  postnl = dev->isconsole;
+#endif
+
+  if (postcr || postnl)
+    {
+      size_t i;
+
+      for (i = 0; i < nbytes; i++)
+        {
+          if ((postnl && buffer[i] == '\n') || (postcr && buffer[i] == '\r'))
+            {
+              break;
+            }
+        }
+
+      nbytes = i;
+    }
+
+  /* Copy in up to two contiguous chunks and then publish the new head */
+
+  if (nbytes > 0)
+    {
+      first = txbuf->size - head;
+      if (first > nbytes)
+        {
+          first = nbytes;
+        }
+
+      memcpy(&txbuf->buffer[head], buffer, first);
+      memcpy(txbuf->buffer, buffer + first, nbytes - first);
+
+      head += nbytes;
+      if (head >= txbuf->size)
+        {
+          head -= txbuf->size;
+        }
+
+      txbuf->head = head;
+    }
+
+#ifdef CONFIG_SMP
+  leave_critical_section(flags);
+#endif
+
+  return nbytes;
+}
+
 /************************************************************************************
  * Name: uart_putc
  ************************************************************************************/
@@ -711,8 +803,12 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
 #endif
   irqstate_t flags;
   ssize_t recvd = 0;
+  size_t nbytes;
+  int16_t head;
   int16_t tail;
+#ifdef CONFIG_SERIAL_TERMIOS
   char ch;
+#endif
   int ret;
 
   /* Only one user can access rxbuf->tail at a time */
@@ -763,29 +859,30 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
        */
 
       tail = rxbuf->tail;
-      if (rxbuf->head != tail)
+      head = rxbuf->head;
+      if (head != tail)
         {
-          /* Take the next character from the tail of the buffer */
+#ifdef CONFIG_SERIAL_TERMIOS
+          /* Do input processing if any is enabled */
 
-          ch = rxbuf->buffer[tail];
+          if (dev->tc_iflag & (INLCR | IGNCR | ICRNL))
+            {
+              /* Take the next character from the tail of the buffer */
 
-          /* Increment the tail index.  Most operations are done using the
-           * local variable 'tail' so that the final rxbuf->tail update
-           * is atomic.
-           */
+              ch = rxbuf->buffer[tail];
 
-          if (++tail >= rxbuf->size)
-            {
-              tail = 0;
-            }
+              /* Increment the tail index.  Most operations are done using
+               * the local variable 'tail' so that the final rxbuf->tail
+               * update is atomic.
+               */
 
-          rxbuf->tail = tail;
+              if (++tail >= rxbuf->size)
+                {
+                  tail = 0;
+                }
 
-#ifdef CONFIG_SERIAL_TERMIOS
-          /* Do input processing if any is enabled */
+              rxbuf->tail = tail;
 
-          if (dev->tc_iflag & (INLCR | IGNCR | ICRNL))
-            {
               /* \n -> \r or \r -> \n translation? */
 
               if ((ch == '\n') && (dev->tc_iflag & INLCR))
@@ -803,22 +900,51 @@ static ssize_t uart_read(FAR struct file *filep, FAR char *buffer, size_t buflen
                 {
                   continue;
                 }
-            }
 
-          /* Specifically not handled:
-           *
-           * All of the local modes; echo, line editing, etc.
-           * Anything to do with break or parity errors.
-           * ISTRIP - we should be 8-bit clean.
-           * IUCLC - Not Posix
-           * IXON/OXOFF - no xon/xoff flow control.
-           */
+              /* Specifically not handled:
+               *
+               * All of the local modes; echo, line editing, etc.
+               * Anything to do with break or parity errors.
+               * ISTRIP - we should be 8-bit clean.
+               * IUCLC - Not Posix
+               * IXON/OXOFF - no xon/xoff flow control.
+               */
+
+              /* Store the received character */
+
+              *buffer++ = ch;
+              recvd++;
+            }
+          else
 #endif
+            {
+              /* No input processing.  Copy as much of the contiguous data
+               * at the tail of the buffer as the caller wants.
+               */
 
-          /* Store the received character */
+              nbytes = (head > tail ? head : rxbuf->size) - tail;
+              if (nbytes > buflen - (size_t)recvd)
+                {
+                  nbytes = buflen - (size_t)recvd;
+                }
+
+              memcpy(buffer, &rxbuf->buffer[tail], nbytes);
+              buffer += nbytes;
+              recvd  += nbytes;
 
-          *buffer++ = ch;
-          recvd++;
+              /* Increment the tail index.  Most operations are done using
+               * the local variable 'tail' so that the final rxbuf->tail
+               * update is atomic.
+               */
+
+              tail += nbytes;
+              if (tail >= rxbuf->size)
+                {
+                  tail = 0;
+                }
+
+              rxbuf->tail = tail;
+            }
         }
 
 #ifdef CONFIG_DEV_SERIAL_FULLBLOCKS
@@ -1050,6 +1176,7 @@ static ssize_t uart_write(FAR struct file *filep, FAR const char *buffer,
   FAR struct inode *inode    = filep->f_inode;
   FAR uart_dev_t   *dev      = inode->i_private;
   ssize_t           nwritten = buflen;
+  size_t            nbytes;
   bool              oktoblock;
   int               ret;
   char              ch;
@@ -1122,6 +1249,22 @@ static ssize_t uart_write(FAR struct file *filep, FAR const char *buffer,
   uart_disabletxint(dev);
   for (; buflen; buflen--)
     {
+      /* Copy the run of characters that need no output processing in bulk,
+       * as much of it as the TX buffer can take without waiting.
+       */
+
+      nbytes  = uart_putxmitbuf(dev, buffer, buflen);
+      buffer += nbytes;
+      buflen -= nbytes;
+      if (buflen == 0)
+        {
+          break;
+        }
+
+      /* Then handle the next character one at a time.  This expands it or
+       * waits for space in the TX buffer as necessary.
+       */
+
       ch  = *buffer++;
       ret = OK;
 
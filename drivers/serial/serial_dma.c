@@ -41,11 +41,17 @@
 
 #include <sys/types.h>
 #include <stdint.h>
+#include <errno.h>
 #include <debug.h>
 
+#ifdef CONFIG_SMP
+#  include <nuttx/irq.h>
+#endif
+
 #include <nuttx/serial/serial.h>
 
-#if defined(CONFIG_SERIAL_TXDMA) || defined(CONFIG_SERIAL_RXDMA)
+#if defined(CONFIG_SERIAL_TXDMA) || defined(CONFIG_SERIAL_RXDMA) || \
+    defined(CONFIG_SERIAL_BULKIO)
 
 /****************************************************************************
  * Private Functions
@@ -107,11 +113,10 @@ static int uart_check_signo(const char *buf, size_t size)
  *
  ****************************************************************************/
 
-#if defined(CONFIG_SERIAL_RXDMA) && \
-   (defined(CONFIG_TTY_SIGINT) || defined(CONFIG_TTY_SIGSTP))
-static int uart_recvchars_signo(FAR uart_dev_t *dev)
+#if (defined(CONFIG_SERIAL_RXDMA) || defined(CONFIG_SERIAL_BULKIO)) && \
+    (defined(CONFIG_TTY_SIGINT) || defined(CONFIG_TTY_SIGSTP))
+static int uart_recvchars_signo(FAR struct uart_dmaxfer_s *xfer)
 {
-  FAR struct uart_dmaxfer_s *xfer = &dev->dmarx;
   int signo;
 
   /* Check if the valid DMAed data is in one or two contiguous regions */
@@ -136,105 +141,53 @@ static int uart_recvchars_signo(FAR uart_dev_t *dev)
 #endif
 
 /****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Name: uart_xmitchars_dma
+ * Name: uart_xmitspan
  *
  * Description:
- *   Set up to transfer bytes from the TX circular buffer using DMA
+ *   Describe the data in the TX circular buffer as one or two contiguous
+ *   regions.  The buffer must not be empty.
  *
  ****************************************************************************/
 
-#ifdef CONFIG_SERIAL_TXDMA
-void uart_xmitchars_dma(FAR uart_dev_t *dev)
+#if defined(CONFIG_SERIAL_TXDMA) || defined(CONFIG_SERIAL_BULKIO)
+static void uart_xmitspan(FAR struct uart_buffer_s *txbuf,
+                          FAR struct uart_dmaxfer_s *xfer)
 {
-  FAR struct uart_dmaxfer_s *xfer = &dev->dmatx;
-
-  if (dev->xmit.head == dev->xmit.tail)
+  if (txbuf->tail < txbuf->head)
     {
-      /* No data to transfer. */
-
-      return;
-    }
-
-  if (dev->xmit.tail < dev->xmit.head)
-    {
-      xfer->buffer  = &dev->xmit.buffer[dev->xmit.tail];
-      xfer->length  = dev->xmit.head - dev->xmit.tail;
+      xfer->buffer  = &txbuf->buffer[txbuf->tail];
+      xfer->length  = txbuf->head - txbuf->tail;
       xfer->nbuffer = NULL;
       xfer->nlength = 0;
     }
   else
     {
-      xfer->buffer  = &dev->xmit.buffer[dev->xmit.tail];
-      xfer->length  = dev->xmit.size - dev->xmit.tail;
-      xfer->nbuffer = dev->xmit.buffer;
-      xfer->nlength = dev->xmit.head;
+      xfer->buffer  = &txbuf->buffer[txbuf->tail];
+      xfer->length  = txbuf->size - txbuf->tail;
+      xfer->nbuffer = txbuf->buffer;
+      xfer->nlength = txbuf->head;
     }
-
-  uart_dmasend(dev);
 }
 #endif
 
 /****************************************************************************
- * Name: uart_xmitchars_done
+ * Name: uart_recvspan
  *
  * Description:
- *   Perform operations necessary at the complete of DMA including adjusting
- *   the TX circular buffer indices and waking up of any threads that may
- *   have been waiting for space to become available in the TX circular
- *   buffer.
+ *   Describe the free space in the RX circular buffer as one or two
+ *   contiguous regions, after giving the lower half a chance to apply RX
+ *   flow control.
  *
- ****************************************************************************/
-
-#ifdef CONFIG_SERIAL_TXDMA
-void uart_xmitchars_done(FAR uart_dev_t *dev)
-{
-  FAR struct uart_dmaxfer_s *xfer = &dev->dmatx;
-  size_t nbytes = xfer->nbytes;
-  struct uart_buffer_s *txbuf = &dev->xmit;
-
-  /* Skip the update if the tail position change which mean
-   * someone reset (e.g. TCOFLUSH) the xmit buffer during DMA.
-   */
-
-  if (xfer->buffer == &txbuf->buffer[txbuf->tail])
-    {
-      /* Move tail for nbytes. */
-
-      txbuf->tail  = (txbuf->tail + nbytes) % txbuf->size;
-    }
-
-  /* Reset xmit buffer. */
-
-  xfer->nbytes = 0;
-  xfer->length = xfer->nlength = 0;
-
-  /* If any bytes were removed from the buffer, inform any waiters there
-   * there is space available.
-   */
-
-  if (nbytes)
-    {
-      uart_datasent(dev);
-    }
-}
-#endif
-
-/****************************************************************************
- * Name: uart_recvchars_dma
- *
- * Description:
- *   Set up to receive bytes into the RX circular buffer using DMA
+ * Returned Value:
+ *   OK if the regions were set up, -EBUSY if the lower half activated RX
+ *   flow control, or -ENOSPC if the RX buffer is full.
  *
  ****************************************************************************/
 
-#ifdef CONFIG_SERIAL_RXDMA
-void uart_recvchars_dma(FAR uart_dev_t *dev)
+#if defined(CONFIG_SERIAL_RXDMA) || defined(CONFIG_SERIAL_BULKIO)
+static int uart_recvspan(FAR uart_dev_t *dev,
+                         FAR struct uart_dmaxfer_s *xfer)
 {
-  FAR struct uart_dmaxfer_s *xfer = &dev->dmarx;
   FAR struct uart_buffer_s *rxbuf = &dev->recv;
 #ifdef CONFIG_SERIAL_IFLOWCONTROL_WATERMARKS
   unsigned int nbuffered;
@@ -243,14 +196,6 @@ void uart_recvchars_dma(FAR uart_dev_t *dev)
   bool is_full;
   int nexthead;
 
-  /* If RX buffer is empty move tail and head to zero position */
-
-  if (rxbuf->head == rxbuf->tail)
-    {
-      rxbuf->head = 0;
-      rxbuf->tail = 0;
-    }
-
   /* Get the next head index and check if there is room to adding another
    * byte to the buffer.
    */
@@ -295,7 +240,7 @@ void uart_recvchars_dma(FAR uart_dev_t *dev)
         {
           /* Low-level driver activated RX flow control, return now. */
 
-          return;
+          return -EBUSY;
         }
     }
 
@@ -310,7 +255,7 @@ void uart_recvchars_dma(FAR uart_dev_t *dev)
         {
           /* Low-level driver activated RX flow control, return now. */
 
-          return;
+          return -EBUSY;
         }
     }
 #endif
@@ -318,11 +263,9 @@ void uart_recvchars_dma(FAR uart_dev_t *dev)
 
   if (is_full)
     {
-      /* If there is no free space in receive buffer we cannot start DMA
-       * transfer.
-       */
+      /* There is no free space in receive buffer */
 
-      return;
+      return -ENOSPC;
     }
 
   if (rxbuf->tail <= rxbuf->head)
@@ -349,43 +292,39 @@ void uart_recvchars_dma(FAR uart_dev_t *dev)
       xfer->nlength = 0;
     }
 
-  uart_dmareceive(dev);
+  return OK;
 }
 #endif
 
 /****************************************************************************
- * Name: uart_recvchars_done
+ * Name: uart_recvspan_done
  *
  * Description:
- *   Perform operations necessary at the complete of DMA including adjusting
- *   the RX circular buffer indices and waking up of any threads that may
- *   have been waiting for new data to become available in the RX circular
- *   buffer.
+ *   Account for the xfer->nbytes bytes received into the regions set up by
+ *   uart_recvspan() and wake up any readers.
  *
  ****************************************************************************/
 
-#ifdef CONFIG_SERIAL_RXDMA
-void uart_recvchars_done(FAR uart_dev_t *dev)
+#if defined(CONFIG_SERIAL_RXDMA) || defined(CONFIG_SERIAL_BULKIO)
+static void uart_recvspan_done(FAR uart_dev_t *dev,
+                               FAR struct uart_dmaxfer_s *xfer)
 {
-  FAR struct uart_dmaxfer_s *xfer = &dev->dmarx;
   FAR struct uart_buffer_s *rxbuf = &dev->recv;
   size_t nbytes = xfer->nbytes;
 #if defined(CONFIG_TTY_SIGINT) || defined(CONFIG_TTY_SIGSTP)
   int signo = 0;
 
-  /* Check if the SIGINT character is anywhere in the newly received DMA buffer. */
+  /* Check if the SIGINT character is anywhere in the newly received data. */
 
   if (dev->pid >= 0)
     {
-      signo = uart_recvchars_signo(dev);
+      signo = uart_recvchars_signo(xfer);
     }
 #endif
 
   /* Move head for nbytes. */
 
-  rxbuf->head  = (rxbuf->head + nbytes) % rxbuf->size;
-  xfer->nbytes = 0;
-  xfer->length = xfer->nlength = 0;
+  rxbuf->head = (rxbuf->head + nbytes) % rxbuf->size;
 
   /* If any bytes were added to the buffer, inform any waiters there is new
    * incoming data available.
@@ -408,4 +347,239 @@ void uart_recvchars_done(FAR uart_dev_t *dev)
 }
 #endif
 
-#endif /* CONFIG_SERIAL_TXDMA || CONFIG_SERIAL_RXDMA */
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: uart_xmitchars_dma
+ *
+ * Description:
+ *   Set up to transfer bytes from the TX circular buffer using DMA
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SERIAL_TXDMA
+void uart_xmitchars_dma(FAR uart_dev_t *dev)
+{
+  FAR struct uart_dmaxfer_s *xfer = &dev->dmatx;
+
+  if (dev->xmit.head == dev->xmit.tail)
+    {
+      /* No data to transfer. */
+
+      return;
+    }
+
+  uart_xmitspan(&dev->xmit, xfer);
+  uart_dmasend(dev);
+}
+#endif
+
+/****************************************************************************
+ * Name: uart_xmitchars_done
+ *
+ * Description:
+ *   Perform operations necessary at the complete of DMA including adjusting
+ *   the TX circular buffer indices and waking up of any threads that may
+ *   have been waiting for space to become available in the TX circular
+ *   buffer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SERIAL_TXDMA
+void uart_xmitchars_done(FAR uart_dev_t *dev)
+{
+  FAR struct uart_dmaxfer_s *xfer = &dev->dmatx;
+  size_t nbytes = xfer->nbytes;
+  struct uart_buffer_s *txbuf = &dev->xmit;
+
+  /* Skip the update if the tail position change which mean
+   * someone reset (e.g. TCOFLUSH) the xmit buffer during DMA.
+   */
+
+  if (xfer->buffer == &txbuf->buffer[txbuf->tail])
+    {
+      /* Move tail for nbytes. */
+
+      txbuf->tail  = (txbuf->tail + nbytes) % txbuf->size;
+    }
+
+  /* Reset xmit buffer. */
+
+  xfer->nbytes = 0;
+  xfer->length = xfer->nlength = 0;
+
+  /* If any bytes were removed from the buffer, inform any waiters there
+   * there is space available.
+   */
+
+  if (nbytes)
+    {
+      uart_datasent(dev);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: uart_recvchars_dma
+ *
+ * Description:
+ *   Set up to receive bytes into the RX circular buffer using DMA
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SERIAL_RXDMA
+void uart_recvchars_dma(FAR uart_dev_t *dev)
+{
+  FAR struct uart_buffer_s *rxbuf = &dev->recv;
+
+  /* If RX buffer is empty move tail and head to zero position */
+
+  if (rxbuf->head == rxbuf->tail)
+    {
+      rxbuf->head = 0;
+      rxbuf->tail = 0;
+    }
+
+  /* If there is no free space in receive buffer we cannot start DMA
+   * transfer.
+   */
+
+  if (uart_recvspan(dev, &dev->dmarx) == OK)
+    {
+      uart_dmareceive(dev);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: uart_recvchars_done
+ *
+ * Description:
+ *   Perform operations necessary at the complete of DMA including adjusting
+ *   the RX circular buffer indices and waking up of any threads that may
+ *   have been waiting for new data to become available in the RX circular
+ *   buffer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SERIAL_RXDMA
+void uart_recvchars_done(FAR uart_dev_t *dev)
+{
+  FAR struct uart_dmaxfer_s *xfer = &dev->dmarx;
+
+  uart_recvspan_done(dev, xfer);
+
+  xfer->nbytes = 0;
+  xfer->length = xfer->nlength = 0;
+}
+#endif
+
+/****************************************************************************
+ * Name: uart_xmitchars_bulk
+ *
+ * Description:
+ *   Send bytes from the TX circular buffer with the lower half sendbuf()
+ *   method, one contiguous span at a time.  Like uart_xmitchars(), this is
+ *   called from the TX interrupt handler and disables the TX interrupt once
+ *   the buffer has drained.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SERIAL_BULKIO
+void uart_xmitchars_bulk(FAR uart_dev_t *dev)
+{
+  FAR struct uart_buffer_s *txbuf = &dev->xmit;
+  struct uart_dmaxfer_s xfer;
+  size_t nbytes = 0;
+
+#ifdef CONFIG_SMP
+  irqstate_t flags = enter_critical_section();
+#endif
+
+  if (txbuf->head != txbuf->tail)
+    {
+      uart_xmitspan(txbuf, &xfer);
+
+      nbytes = dev->ops->sendbuf(dev, xfer.buffer, xfer.length);
+      if (nbytes == xfer.length && xfer.nlength > 0)
+        {
+          nbytes += dev->ops->sendbuf(dev, xfer.nbuffer, xfer.nlength);
+        }
+
+      txbuf->tail = (txbuf->tail + nbytes) % txbuf->size;
+    }
+
+  /* When all of the characters have been sent from the buffer disable the
+   * TX interrupt.
+   */
+
+  if (txbuf->head == txbuf->tail)
+    {
+      uart_disabletxint(dev);
+    }
+
+  /* If any bytes were removed from the buffer, inform any waiters that
+   * there is space available.
+   */
+
+  if (nbytes)
+    {
+      uart_datasent(dev);
+    }
+
+#ifdef CONFIG_SMP
+  leave_critical_section(flags);
+#endif
+}
+#endif
+
+/****************************************************************************
+ * Name: uart_recvchars_bulk
+ *
+ * Description:
+ *   Receive bytes into the RX circular buffer with the lower half recvbuf()
+ *   method, one contiguous span at a time.  As with RX DMA, the SIGINT and
+ *   SIGSTP characters raise their signal but are left in the buffer.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SERIAL_BULKIO
+void uart_recvchars_bulk(FAR uart_dev_t *dev)
+{
+  struct uart_dmaxfer_s xfer;
+  char discard[16];
+  int ret;
+
+  ret = uart_recvspan(dev, &xfer);
+  if (ret == -ENOSPC)
+    {
+      /* If the RX buffer is full, then the serial data is discarded, as
+       * uart_recvchars() does, so that the RX interrupt is cleared.
+       */
+
+      while (dev->ops->recvbuf(dev, discard, sizeof(discard)) > 0)
+        {
+        }
+
+      return;
+    }
+  else if (ret < 0)
+    {
+      /* The lower half activated RX flow control */
+
+      return;
+    }
+
+  xfer.nbytes = dev->ops->recvbuf(dev, xfer.buffer, xfer.length);
+  if (xfer.nbytes == xfer.length && xfer.nlength > 0)
+    {
+      xfer.nbytes += dev->ops->recvbuf(dev, xfer.nbuffer, xfer.nlength);
+    }
+
+  uart_recvspan_done(dev, &xfer);
+}
+#endif
+
+#endif /* CONFIG_SERIAL_TXDMA || CONFIG_SERIAL_RXDMA || CONFIG_SERIAL_BULKIO */
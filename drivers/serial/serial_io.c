@@ -71,6 +71,16 @@ void uart_xmitchars(FAR uart_dev_t *dev)
 {
   uint16_t nbytes = 0;
 
+#ifdef CONFIG_SERIAL_BULKIO
+  /* Let the lower half take whole spans if it can */
+
+  if (dev->ops->sendbuf != NULL)
+    {
+      uart_xmitchars_bulk(dev);
+      return;
+    }
+#endif
+
 #ifdef CONFIG_SMP
   irqstate_t flags = enter_critical_section();
 #endif
@@ -144,6 +154,16 @@ void uart_recvchars(FAR uart_dev_t *dev)
 #endif
   uint16_t nbytes = 0;
 
+#ifdef CONFIG_SERIAL_BULKIO
+  /* Let the lower half fill whole spans if it can */
+
+  if (dev->ops->recvbuf != NULL)
+    {
+      uart_recvchars_bulk(dev);
+      return;
+    }
+#endif
+
   if (nexthead >= rxbuf->size)
     {
       nexthead = 0;
@@ -110,6 +110,12 @@ static void u16550_dmatxavail(FAR struct uart_dev_s *dev);
 static void u16550_dmareceive(FAR struct uart_dev_s *dev);
 static void u16550_dmarxfree(FAR struct uart_dev_s *dev);
 #endif
+#ifdef CONFIG_SERIAL_BULKIO
+static size_t u16550_sendbuf(FAR struct uart_dev_s *dev,
+                             FAR const char *buffer, size_t buflen);
+static size_t u16550_recvbuf(FAR struct uart_dev_s *dev, FAR char *buffer,
+                             size_t buflen);
+#endif
 static void u16550_send(FAR struct uart_dev_s *dev, int ch);
 static void u16550_txint(FAR struct uart_dev_s *dev, bool enable);
 static bool u16550_txready(FAR struct uart_dev_s *dev);
@@ -146,6 +152,10 @@ static const struct uart_ops_s g_uart_ops =
   .txint          = u16550_txint,
   .txready        = u16550_txready,
   .txempty        = u16550_txempty,
+#ifdef CONFIG_SERIAL_BULKIO
+  .sendbuf        = u16550_sendbuf,
+  .recvbuf        = u16550_recvbuf,
+#endif
 };
 
 /* I/O buffers */
@@ -1191,6 +1201,64 @@ static void u16550_dmatxavail(FAR struct uart_dev_s *dev)
 }
 #endif
 
+/****************************************************************************
+ * Name: u16550_sendbuf
+ *
+ * Description:
+ *   Fill the TX FIFO from a contiguous span.  THRE means that the FIFO is
+ *   empty, so a FIFO full of bytes can be written without reading the line
+ *   status register in between.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SERIAL_BULKIO
+static size_t u16550_sendbuf(FAR struct uart_dev_s *dev,
+                             FAR const char *buffer, size_t buflen)
+{
+  FAR struct u16550_s *priv = (FAR struct u16550_s *)dev->priv;
+  size_t nbytes = 0;
+
+  if ((u16550_serialin(priv, UART_LSR_OFFSET) & UART_LSR_THRE) != 0)
+    {
+      if (buflen > CONFIG_16550_TXFIFO_SIZE)
+        {
+          buflen = CONFIG_16550_TXFIFO_SIZE;
+        }
+
+      for (; nbytes < buflen; nbytes++)
+        {
+          u16550_serialout(priv, UART_THR_OFFSET,
+                           (uart_datawidth_t)buffer[nbytes]);
+        }
+    }
+
+  return nbytes;
+}
+
+/****************************************************************************
+ * Name: u16550_recvbuf
+ *
+ * Description:
+ *   Drain the RX FIFO into a contiguous span.
+ *
+ ****************************************************************************/
+
+static size_t u16550_recvbuf(FAR struct uart_dev_s *dev, FAR char *buffer,
+                             size_t buflen)
+{
+  FAR struct u16550_s *priv = (FAR struct u16550_s *)dev->priv;
+  size_t nbytes = 0;
+
+  while (nbytes < buflen &&
+         (u16550_serialin(priv, UART_LSR_OFFSET) & UART_LSR_DR) != 0)
+    {
+      buffer[nbytes++] = (char)u16550_serialin(priv, UART_RBR_OFFSET);
+    }
+
+  return nbytes;
+}
+#endif
+
 /****************************************************************************
  * Name: u16550_send
  *
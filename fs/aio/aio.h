@@ -49,6 +49,20 @@
 #  define CONFIG_FS_NAIOC 8
 #endif
 
+/* AIO worker thread pool */
+
+#ifndef CONFIG_FS_AIO_NWORKERS
+#  define CONFIG_FS_AIO_NWORKERS 2
+#endif
+
+#ifndef CONFIG_FS_AIO_PRIORITY
+#  define CONFIG_FS_AIO_PRIORITY 100
+#endif
+
+#ifndef CONFIG_FS_AIO_STACKSIZE
+#  define CONFIG_FS_AIO_STACKSIZE 2048
+#endif
+
 #undef AIO_HAVE_PSOCK
 
 #ifdef CONFIG_NET_TCP
@@ -77,11 +91,9 @@ struct aio_container_s
 #endif
     FAR void *ptr;                 /* Generic pointer to FAR data */
   } u;
-  struct work_s aioc_work;         /* Used to defer I/O to the work thread */
+  worker_t aioc_worker;            /* Queued I/O; NULL once a worker has it */
   pid_t aioc_pid;                  /* ID of the waiting task */
-#ifdef CONFIG_PRIORITY_INHERITANCE
   uint8_t aioc_prio;               /* Priority of the waiting task */
-#endif
 };
 
 /****************************************************************************
@@ -220,11 +232,13 @@ FAR struct aiocb *aioc_decant(FAR struct aio_container_s *aioc);
  * Name: aio_queue
  *
  * Description:
- *   Schedule the asynchronous I/O on the low priority work queue
+ *   Queue the asynchronous I/O for the AIO worker threads, starting a new
+ *   worker thread if all of the existing ones are busy.
  *
  * Input Parameters:
- *   arg - Worker argument.  In this case, a pointer to an instance of
- *     struct aiocb cast to void *.
+ *   aioc   - The AIO control block container
+ *   worker - The function that performs the I/O on the worker thread.  It
+ *            receives the container as its argument.
  *
  * Returned Value:
  *   Zero (OK) on success.  Otherwise, -1 is returned and the errno is set
@@ -234,6 +248,27 @@ FAR struct aiocb *aioc_decant(FAR struct aio_container_s *aioc);
 
 int aio_queue(FAR struct aio_container_s *aioc, worker_t worker);
 
+/****************************************************************************
+ * Name: aio_dequeue
+ *
+ * Description:
+ *   Remove a queued asynchronous I/O before any worker thread starts it.
+ *   The container remains in the pending list.
+ *
+ * Input Parameters:
+ *   aioc - The AIO control block container
+ *
+ * Returned Value:
+ *   Zero (OK) if the I/O was removed; -EBUSY if a worker thread has already
+ *   started it.
+ *
+ * Assumptions:
+ *   The caller holds the lock on the pending asynchronous I/O list.
+ *
+ ****************************************************************************/
+
+int aio_dequeue(FAR struct aio_container_s *aioc);
+
 /****************************************************************************
  * Name: aio_signal
  *
@@ -117,14 +117,13 @@ int aio_cancel(int fildes, FAR struct aiocb *aiocbp)
           if (aioc)
             {
               /* Yes... attempt to cancel the I/O.  There are two
-               * possibilities:* (1) the work has already been started and
-               * is no longer queued, or (2) the work has not been started
-               * and is still in the work queue.  Only the second case can
-               * be canceled.  work_cancel() will return -ENOENT in the
-               * first case.
+               * possibilities:* (1) the work has already been started by
+               * a worker thread, or (2) the work has not been started and
+               * is still queued.  Only the second case can be canceled.
+               * aio_dequeue() will return -EBUSY in the first case.
                */
 
-              status = work_cancel(LPWORK, &aioc->aioc_work);
+              status = aio_dequeue(aioc);
               if (status >= 0)
                 {
                   /* Remove the container from the list of pending transfers */
@@ -172,20 +171,19 @@ int aio_cancel(int fildes, FAR struct aiocb *aiocbp)
           if (aioc)
             {
               /* Yes... attempt to cancel the I/O.  There are two
-               * possibilities:* (1) the work has already been started and
-               * is no longer queued, or (2) the work has not been started
-               * and is still in the work queue.  Only the second case can
-               * be canceled.  work_cancel() will return -ENOENT in the
-               * first case.
+               * possibilities:* (1) the work has already been started by
+               * a worker thread, or (2) the work has not been started and
+               * is still queued.  Only the second case can be canceled.
+               * aio_dequeue() will return -EBUSY in the first case.  Either
+               * way, continue the search after this container.
                */
 
-              status = work_cancel(LPWORK, &aioc->aioc_work);
+              next   = (FAR struct aio_container_s *)aioc->aioc_link.flink;
+              status = aio_dequeue(aioc);
               if (status >= 0)
                 {
                   /* Remove the container from the list of pending transfers */
 
-                  next   =
-                    (FAR struct aio_container_s *)aioc->aioc_link.flink;
                   pid    = aioc->aioc_pid;
                   aiocbp = aioc_decant(aioc);
                   DEBUGASSERT(aiocbp);
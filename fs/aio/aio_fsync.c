@@ -77,9 +77,7 @@ static void aio_fsync_worker(FAR void *arg)
   FAR struct aio_container_s *aioc = (FAR struct aio_container_s *)arg;
   FAR struct aiocb *aiocbp;
   pid_t pid;
-#ifdef CONFIG_PRIORITY_INHERITANCE
-  uint8_t prio;
-#endif
+  FAR struct file *filep;
   int ret;
 
   /* Get the information from the container, decant the AIO control block,
@@ -89,14 +87,12 @@ static void aio_fsync_worker(FAR void *arg)
 
   DEBUGASSERT(aioc && aioc->aioc_aiocbp);
   pid    = aioc->aioc_pid;
-#ifdef CONFIG_PRIORITY_INHERITANCE
-  prio   = aioc->aioc_prio;
-#endif
+  filep  = aioc->u.aioc_filep;
   aiocbp = aioc_decant(aioc);
 
-  /* Perform the fsync using u.aioc_filep */
+  /* Perform the fsync using the file structure */
 
-  ret = file_fsync(aioc->u.aioc_filep);
+  ret = file_fsync(filep);
   if (ret < 0)
     {
       ferr("ERROR: file_fsync failed: %d\n", ret);
@@ -111,11 +107,6 @@ static void aio_fsync_worker(FAR void *arg)
 
   aio_signal(pid, aiocbp);
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
-  /* Restore the low priority worker thread default priority */
-
-  lpwork_restorepriority(prio);
-#endif
 }
 
 /****************************************************************************
@@ -41,28 +41,148 @@
 
 #include <sched.h>
 #include <aio.h>
+#include <assert.h>
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/kthread.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/wqueue.h>
 
 #include "aio/aio.h"
 
 #ifdef CONFIG_FS_AIO
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* This counting semaphore is posted once for each queued I/O.  The worker
+ * threads wait on it.  An I/O that is canceled before a worker takes it
+ * leaves an extra count behind; the worker that consumes it will simply
+ * find nothing to do.
+ */
+
+static sem_t g_aio_worksem = SEM_INITIALIZER(0);
+
+/* The following are protected by aio_lock() */
+
+static uint8_t g_aio_nworkers;   /* Number of worker threads started */
+static uint8_t g_aio_nidle;      /* Number of idle worker threads */
+static uint8_t g_aio_nqueued;    /* Number of I/Os not taken by a worker */
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: aio_lock_nocancel
+ *
+ * Description:
+ *   Take the AIO lock from a worker thread.  Worker threads are kernel
+ *   threads and cannot be canceled, so the lock cannot fail.
+ *
+ ****************************************************************************/
+
+static void aio_lock_nocancel(void)
+{
+  int ret;
+
+  do
+    {
+      ret = aio_lock();
+      DEBUGASSERT(ret == OK || ret == -ECANCELED);
+    }
+  while (ret < 0);
+}
+
+/****************************************************************************
+ * Name: aio_worker
+ *
+ * Description:
+ *   The body of each AIO worker thread.  It takes the highest priority
+ *   queued I/O from the pending list and performs it at the priority of
+ *   the thread that queued it.
+ *
+ ****************************************************************************/
+
+static int aio_worker(int argc, FAR char *argv[])
+{
+  FAR struct aio_container_s *aioc;
+  FAR struct aio_container_s *next;
+  struct sched_param param;
+  worker_t worker;
+
+  for (; ; )
+    {
+      nxsem_wait_uninterruptible(&g_aio_worksem);
+
+      /* Find the highest priority I/O that no other worker has taken.
+       * The pending list is short:  It holds at most CONFIG_FS_NAIOC
+       * containers.
+       */
+
+      aio_lock_nocancel();
+
+      aioc = NULL;
+      for (next = (FAR struct aio_container_s *)g_aio_pending.head;
+           next != NULL;
+           next = (FAR struct aio_container_s *)next->aioc_link.flink)
+        {
+          if (next->aioc_worker != NULL &&
+              (aioc == NULL || next->aioc_prio > aioc->aioc_prio))
+            {
+              aioc = next;
+            }
+        }
+
+      if (aioc == NULL)
+        {
+          /* The I/O was canceled */
+
+          aio_unlock();
+          continue;
+        }
+
+      worker            = aioc->aioc_worker;
+      aioc->aioc_worker = NULL;
+      g_aio_nqueued--;
+      g_aio_nidle--;
+      aio_unlock();
+
+      /* Perform the I/O at the priority of the waiting task */
+
+      param.sched_priority = aioc->aioc_prio;
+      nxsched_set_param(0, &param);
+
+      worker(aioc);
+
+      param.sched_priority = CONFIG_FS_AIO_PRIORITY;
+      nxsched_set_param(0, &param);
+
+      aio_lock_nocancel();
+      g_aio_nidle++;
+      aio_unlock();
+    }
+
+  return OK; /* Not reached */
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
 /****************************************************************************
  * Name: aio_queue
  *
  * Description:
- *   Schedule the asynchronous I/O on the low priority work queue
+ *   Queue the asynchronous I/O for the AIO worker threads, starting a new
+ *   worker thread if all of the existing ones are busy.
  *
  * Input Parameters:
- *   arg - Worker argument.  In this case, a pointer to an instance of
- *     struct aiocb cast to void *.
+ *   aioc   - The AIO control block container
+ *   worker - The function that performs the I/O on the worker thread.  It
+ *            receives the container as its argument.
  *
  * Returned Value:
  *   Zero (OK) on success.  Otherwise, -1 is returned and the errno is set
@@ -72,42 +192,92 @@
 
 int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
 {
+  FAR struct aiocb *aiocbp = aioc->aioc_aiocbp;
   int ret;
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
-  /* Prohibit context switches until we complete the queuing */
+  DEBUGASSERT(aiocbp != NULL && worker != NULL);
 
-  sched_lock();
+  ret = aio_lock();
+  if (ret < 0)
+    {
+      goto errout;
+    }
 
-  /* Make sure that the low-priority worker thread is running at at least
-   * the priority specified for this action.
+  /* Start another worker thread if every idle worker already has an I/O
+   * to perform.
    */
 
-  lpwork_boostpriority(aioc->aioc_prio);
-#endif
+  if (g_aio_nqueued >= g_aio_nidle &&
+      g_aio_nworkers < CONFIG_FS_AIO_NWORKERS)
+    {
+      if (g_aio_nworkers == 0)
+        {
+          /* g_aio_worksem is used for signaling and, hence, should not
+           * have priority inheritance enabled.
+           */
 
-  /* Schedule the work on the low priority worker thread */
+          nxsem_set_protocol(&g_aio_worksem, SEM_PRIO_NONE);
+        }
 
-  ret = work_queue(LPWORK, &aioc->aioc_work, worker, aioc, 0);
-  if (ret < 0)
-    {
-      FAR struct aiocb *aiocbp = aioc->aioc_aiocbp;
-      DEBUGASSERT(aiocbp);
-
-#ifdef CONFIG_PRIORITY_INHERITANCE
-      lpwork_restorepriority(aioc->aioc_prio);
-#endif
-      aiocbp->aio_result = ret;
-      set_errno(-ret);
-      ret = ERROR;
+      ret = kthread_create("aio", CONFIG_FS_AIO_PRIORITY,
+                           CONFIG_FS_AIO_STACKSIZE, aio_worker, NULL);
+      if (ret > 0)
+        {
+          g_aio_nworkers++;
+          g_aio_nidle++;
+        }
+      else if (g_aio_nworkers == 0)
+        {
+          /* There is no worker at all to perform the I/O */
+
+          ferr("ERROR: Failed to start an AIO worker: %d\n", ret);
+          aio_unlock();
+          goto errout;
+        }
     }
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
-  /* Now the low-priority work queue might run at its new priority */
+  aioc->aioc_worker = worker;
+  g_aio_nqueued++;
+  aio_unlock();
+
+  nxsem_post(&g_aio_worksem);
+  return OK;
+
+errout:
+  aiocbp->aio_result = ret;
+  set_errno(-ret);
+  return ERROR;
+}
+
+/****************************************************************************
+ * Name: aio_dequeue
+ *
+ * Description:
+ *   Remove a queued asynchronous I/O before any worker thread starts it.
+ *   The container remains in the pending list.
+ *
+ * Input Parameters:
+ *   aioc - The AIO control block container
+ *
+ * Returned Value:
+ *   Zero (OK) if the I/O was removed; -EBUSY if a worker thread has already
+ *   started it.
+ *
+ * Assumptions:
+ *   The caller holds the lock on the pending asynchronous I/O list.
+ *
+ ****************************************************************************/
+
+int aio_dequeue(FAR struct aio_container_s *aioc)
+{
+  if (aioc->aioc_worker == NULL)
+    {
+      return -EBUSY;
+    }
 
-  sched_unlock();
-#endif
-  return ret;
+  aioc->aioc_worker = NULL;
+  g_aio_nqueued--;
+  return OK;
 }
 
 #endif /* CONFIG_FS_AIO */
@@ -77,8 +77,9 @@ static void aio_read_worker(FAR void *arg)
   FAR struct aio_container_s *aioc = (FAR struct aio_container_s *)arg;
   FAR struct aiocb *aiocbp;
   pid_t pid;
-#ifdef CONFIG_PRIORITY_INHERITANCE
-  uint8_t prio;
+  FAR struct file *filep;
+#ifdef AIO_HAVE_PSOCK
+  FAR struct socket *psock;
 #endif
   ssize_t nread = 0;
 
@@ -89,8 +90,9 @@ static void aio_read_worker(FAR void *arg)
 
   DEBUGASSERT(aioc && aioc->aioc_aiocbp);
   pid    = aioc->aioc_pid;
-#ifdef CONFIG_PRIORITY_INHERITANCE
-  prio   = aioc->aioc_prio;
+  filep  = aioc->u.aioc_filep;
+#ifdef AIO_HAVE_PSOCK
+  psock  = aioc->u.aioc_psock;
 #endif
   aiocbp = aioc_decant(aioc);
 
@@ -100,13 +102,13 @@ static void aio_read_worker(FAR void *arg)
     {
       /* Perform the file read using:
        *
-       *   u.aioc_filep - File structure pointer
+       *   filep        - File structure pointer
        *   aio_buf      - Location of buffer
        *   aio_nbytes   - Length of transfer
        *   aio_offset   - File offset
        */
 
-     nread = file_pread(aioc->u.aioc_filep, (FAR void *)aiocbp->aio_buf,
+     nread = file_pread(filep, (FAR void *)aiocbp->aio_buf,
                         aiocbp->aio_nbytes, aiocbp->aio_offset);
     }
 #ifdef AIO_HAVE_PSOCK
@@ -114,12 +116,12 @@ static void aio_read_worker(FAR void *arg)
     {
       /* Perform the socket receive using:
        *
-       *   u.aioc_psock - Socket structure pointer
+       *   psock        - Socket structure pointer
        *   aio_buf      - Location of buffer
        *   aio_nbytes   - Length of transfer
        */
 
-      nread = psock_recv(aioc->u.aioc_psock, (FAR void *)aiocbp->aio_buf,
+      nread = psock_recv(psock, (FAR void *)aiocbp->aio_buf,
                          aiocbp->aio_nbytes, 0);
     }
 #endif
@@ -139,11 +141,6 @@ static void aio_read_worker(FAR void *arg)
 
   aio_signal(pid, aiocbp);
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
-  /* Restore the low priority worker thread default priority */
-
-  lpwork_restorepriority(prio);
-#endif
 }
 
 /****************************************************************************
@@ -77,8 +77,9 @@ static void aio_write_worker(FAR void *arg)
   FAR struct aio_container_s *aioc = (FAR struct aio_container_s *)arg;
   FAR struct aiocb *aiocbp;
   pid_t pid;
-#ifdef CONFIG_PRIORITY_INHERITANCE
-  uint8_t prio;
+  FAR struct file *filep;
+#ifdef AIO_HAVE_PSOCK
+  FAR struct socket *psock;
 #endif
   ssize_t nwritten = 0;
   int oflags;
@@ -90,8 +91,9 @@ static void aio_write_worker(FAR void *arg)
 
   DEBUGASSERT(aioc && aioc->aioc_aiocbp);
   pid    = aioc->aioc_pid;
-#ifdef CONFIG_PRIORITY_INHERITANCE
-  prio   = aioc->aioc_prio;
+  filep  = aioc->u.aioc_filep;
+#ifdef AIO_HAVE_PSOCK
+  psock  = aioc->u.aioc_psock;
 #endif
   aiocbp = aioc_decant(aioc);
 
@@ -101,7 +103,7 @@ static void aio_write_worker(FAR void *arg)
     {
       /* Call fcntl(F_GETFL) to get the file open mode. */
 
-      oflags = file_fcntl(aioc->u.aioc_filep, F_GETFL);
+      oflags = file_fcntl(filep, F_GETFL);
       if (oflags < 0)
         {
           ferr("ERROR: file_fcntl failed: %d\n", oflags);
@@ -111,7 +113,7 @@ static void aio_write_worker(FAR void *arg)
 
       /* Perform the write using:
        *
-       *   u.aioc_filep - File structure pointer
+       *   filep        - File structure pointer
        *   aio_buf      - Location of buffer
        *   aio_nbytes   - Length of transfer
        *   aio_offset   - File offset
@@ -123,13 +125,13 @@ static void aio_write_worker(FAR void *arg)
         {
           /* Append to the current file position */
 
-          nwritten = file_write(aioc->u.aioc_filep,
+          nwritten = file_write(filep,
                                 (FAR const void *)aiocbp->aio_buf,
                                 aiocbp->aio_nbytes);
         }
       else
         {
-          nwritten = file_pwrite(aioc->u.aioc_filep,
+          nwritten = file_pwrite(filep,
                                  (FAR const void *)aiocbp->aio_buf,
                                  aiocbp->aio_nbytes,
                                  aiocbp->aio_offset);
@@ -140,12 +142,12 @@ static void aio_write_worker(FAR void *arg)
     {
       /* Perform the send using:
        *
-       *   u.aioc_psock - Socket structure pointer
+       *   psock        - Socket structure pointer
        *   aio_buf      - Location of buffer
        *   aio_nbytes   - Length of transfer
        */
 
-      nwritten = psock_send(aioc->u.aioc_psock,
+      nwritten = psock_send(psock,
                             (FAR const void *)aiocbp->aio_buf,
                             aiocbp->aio_nbytes, 0);
     }
@@ -166,11 +168,6 @@ errout:
 
   aio_signal(pid, aiocbp);
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
-  /* Restore the low priority worker thread default priority */
-
-  lpwork_restorepriority(prio);
-#endif
 }
 
 /****************************************************************************
@@ -68,9 +68,7 @@ FAR struct aio_container_s *aio_contain(FAR struct aiocb *aiocbp)
     FAR void *ptr;
   } u;
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
   struct sched_param param;
-#endif
   int ret;
 
 #ifdef AIO_HAVE_PSOCK
@@ -120,10 +118,8 @@ FAR struct aio_container_s *aio_contain(FAR struct aiocb *aiocbp)
       aioc->u.ptr       = u.ptr;
       aioc->aioc_pid    = getpid();
 
-#ifdef CONFIG_PRIORITY_INHERITANCE
       DEBUGVERIFY(nxsched_get_param (aioc->aioc_pid, &param));
       aioc->aioc_prio   = param.sched_priority;
-#endif
 
       /* Add the container to the pending transfer list. */
 
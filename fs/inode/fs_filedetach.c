@@ -114,8 +114,8 @@ int file_detach(int fd, FAR struct file *filep)
       return ret;
     }
 
-  parent = &list->fl_files[fd];
-  if (parent->f_inode == NULL)
+  parent = files_fget(list, fd);
+  if (parent == NULL || parent->f_inode == NULL)
     {
       /* File is not open */
 
@@ -142,6 +142,9 @@ int file_detach(int fd, FAR struct file *filep)
   parent->f_inode  = NULL;
   parent->f_priv   = NULL;
 
+  list->fl_used[fd / CONFIG_NFILE_DESCRIPTORS_PER_BLOCK] &=
+    ~((uint32_t)1 << (fd % CONFIG_NFILE_DESCRIPTORS_PER_BLOCK));
+
   _files_semgive(list);
   return OK;
 }
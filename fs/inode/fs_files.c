@@ -26,6 +26,7 @@
 
 #include <sys/types.h>
 #include <string.h>
+#include <strings.h>
 #include <assert.h>
 #include <sched.h>
 #include <errno.h>
@@ -36,6 +37,13 @@
 
 #include "inode/inode.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define FILE_ROW(fd) ((fd) / CONFIG_NFILE_DESCRIPTORS_PER_BLOCK)
+#define FILE_COL(fd) ((fd) % CONFIG_NFILE_DESCRIPTORS_PER_BLOCK)
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -55,6 +63,59 @@ static int _files_semtake(FAR struct filelist *list)
 
 #define _files_semgive(list) nxsem_post(&list->fl_sem)
 
+/****************************************************************************
+ * Name: _files_rowmask
+ *
+ * Description:
+ *   Return the mask of the valid descriptors in a row.  Only the last row
+ *   may be partial.
+ *
+ ****************************************************************************/
+
+static uint32_t _files_rowmask(int row)
+{
+  int nfds = CONFIG_NFILE_DESCRIPTORS -
+             row * CONFIG_NFILE_DESCRIPTORS_PER_BLOCK;
+
+  if (nfds > CONFIG_NFILE_DESCRIPTORS_PER_BLOCK)
+    {
+      nfds = CONFIG_NFILE_DESCRIPTORS_PER_BLOCK;
+    }
+
+  if (nfds >= 32)
+    {
+      return UINT32_MAX;
+    }
+
+  return ((uint32_t)1 << nfds) - 1;
+}
+
+/****************************************************************************
+ * Name: _files_extend
+ *
+ * Description:
+ *   Allocate the storage for a row of descriptors if it does not exist yet.
+ *
+ * Assumptions:
+ *   Caller holds the list semaphore.
+ *
+ ****************************************************************************/
+
+static int _files_extend(FAR struct filelist *list, int row)
+{
+  if (list->fl_files[row] == NULL)
+    {
+      list->fl_files[row] = (FAR struct file *)
+        kmm_zalloc(sizeof(struct file) * CONFIG_NFILE_DESCRIPTORS_PER_BLOCK);
+      if (list->fl_files[row] == NULL)
+        {
+          return -ENOMEM;
+        }
+    }
+
+  return OK;
+}
+
 /****************************************************************************
  * Name: _files_close
  *
@@ -141,6 +202,7 @@ void files_initlist(FAR struct filelist *list)
 
 void files_releaselist(FAR struct filelist *list)
 {
+  int row;
   int i;
 
   DEBUGASSERT(list);
@@ -150,9 +212,20 @@ void files_releaselist(FAR struct filelist *list)
    * because there should not be any references in this context.
    */
 
-  for (i = 0; i < CONFIG_NFILE_DESCRIPTORS; i++)
+  for (row = 0; row < NFILE_ROWS; row++)
     {
-      _files_close(&list->fl_files[i]);
+      if (list->fl_files[row] != NULL)
+        {
+          for (i = 0; i < CONFIG_NFILE_DESCRIPTORS_PER_BLOCK; i++)
+            {
+              _files_close(&list->fl_files[row][i]);
+            }
+
+          kmm_free(list->fl_files[row]);
+          list->fl_files[row] = NULL;
+        }
+
+      list->fl_used[row] = 0;
     }
 
   /* Destroy the semaphore */
@@ -160,6 +233,101 @@ void files_releaselist(FAR struct filelist *list)
   nxsem_destroy(&list->fl_sem);
 }
 
+/****************************************************************************
+ * Name: files_fget
+ *
+ * Description:
+ *   Return the file structure of descriptor 'fd' in the list or NULL if
+ *   the descriptor was never allocated.  The file structure may or may
+ *   not be open.  No lock is needed:  Rows are never moved or freed while
+ *   the list is in use.
+ *
+ ****************************************************************************/
+
+FAR struct file *files_fget(FAR struct filelist *list, int fd)
+{
+  FAR struct file *row;
+
+  DEBUGASSERT(list != NULL);
+
+  if ((unsigned int)fd >= CONFIG_NFILE_DESCRIPTORS)
+    {
+      return NULL;
+    }
+
+  row = list->fl_files[FILE_ROW(fd)];
+  return row != NULL ? &row[FILE_COL(fd)] : NULL;
+}
+
+/****************************************************************************
+ * Name: files_reserve
+ *
+ * Description:
+ *   Reserve the specific descriptor 'fd' in the list, allocating storage
+ *   for it if necessary, and return its file structure.  The descriptor
+ *   may already be open.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+int files_reserve(FAR struct filelist *list, int fd,
+                  FAR struct file **filep)
+{
+  int ret;
+
+  DEBUGASSERT(list != NULL && filep != NULL);
+
+  if ((unsigned int)fd >= CONFIG_NFILE_DESCRIPTORS)
+    {
+      return -EBADF;
+    }
+
+  ret = _files_semtake(list);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = _files_extend(list, FILE_ROW(fd));
+  if (ret >= 0)
+    {
+      list->fl_used[FILE_ROW(fd)] |= (uint32_t)1 << FILE_COL(fd);
+      *filep = &list->fl_files[FILE_ROW(fd)][FILE_COL(fd)];
+    }
+
+  _files_semgive(list);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: files_unreserve
+ *
+ * Description:
+ *   Return a descriptor that was reserved but that is not open to the list
+ *   of free descriptors.
+ *
+ ****************************************************************************/
+
+void files_unreserve(FAR struct filelist *list, int fd)
+{
+  FAR struct file *filep;
+
+  DEBUGASSERT(list != NULL);
+
+  filep = files_fget(list, fd);
+  if (filep != NULL && _files_semtake(list) >= 0)
+    {
+      filep->f_oflags = 0;
+      filep->f_pos    = 0;
+      filep->f_inode  = NULL;
+      list->fl_used[FILE_ROW(fd)] &= ~((uint32_t)1 << FILE_COL(fd));
+      _files_semgive(list);
+    }
+}
+
 /****************************************************************************
  * Name: file_dup2
  *
@@ -294,15 +462,20 @@ errout_with_sem:
  *
  * Description:
  *   Allocate a struct files instance and associate it with an inode
- *   instance.  Returns the file descriptor == index into the files array.
+ *   instance.  Returns the file descriptor == index into the files array
+ *   or a negated errno value:  -EMFILE if all descriptors are in use or
+ *   -ENOMEM if the storage for more descriptors could not be allocated.
  *
  ****************************************************************************/
 
 int files_allocate(FAR struct inode *inode, int oflags, off_t pos, int minfd)
 {
   FAR struct filelist *list;
+  FAR struct file *filep;
+  uint32_t avail;
+  int row;
+  int col;
   int ret;
-  int i;
 
   /* Get the file descriptor list.  It should not be NULL in this context. */
 
@@ -317,21 +490,43 @@ int files_allocate(FAR struct inode *inode, int oflags, off_t pos, int minfd)
       return ret;
     }
 
-  for (i = minfd; i < CONFIG_NFILE_DESCRIPTORS; i++)
+  /* Find the lowest free descriptor >= minfd with one bit search per row */
+
+  for (row = FILE_ROW(minfd), col = FILE_COL(minfd);
+       row < NFILE_ROWS;
+       row++, col = 0)
     {
-      if (!list->fl_files[i].f_inode)
+      avail = ~list->fl_used[row] & _files_rowmask(row) &
+              ~(((uint32_t)1 << col) - 1);
+      if (avail == 0)
+        {
+          continue;
+        }
+
+      /* Allocate the row if this is its first descriptor */
+
+      ret = _files_extend(list, row);
+      if (ret < 0)
         {
-          list->fl_files[i].f_oflags = oflags;
-          list->fl_files[i].f_pos    = pos;
-          list->fl_files[i].f_inode  = inode;
-          list->fl_files[i].f_priv   = NULL;
           _files_semgive(list);
-          return i;
+          return ret;
         }
+
+      col = ffs((int)avail) - 1;
+      list->fl_used[row] |= (uint32_t)1 << col;
+
+      filep           = &list->fl_files[row][col];
+      filep->f_oflags = oflags;
+      filep->f_pos    = pos;
+      filep->f_inode  = inode;
+      filep->f_priv   = NULL;
+
+      _files_semgive(list);
+      return row * CONFIG_NFILE_DESCRIPTORS_PER_BLOCK + col;
     }
 
   _files_semgive(list);
-  return ERROR;
+  return -EMFILE;
 }
 
 /****************************************************************************
@@ -349,6 +544,7 @@ int files_allocate(FAR struct inode *inode, int oflags, off_t pos, int minfd)
 int files_close(int fd)
 {
   FAR struct filelist *list;
+  FAR struct file     *filep;
   int                  ret;
 
   /* Get the thread-specific file list.  It should never be NULL in this
@@ -360,8 +556,8 @@ int files_close(int fd)
 
   /* If the file was properly opened, there should be an inode assigned */
 
-  if (fd < 0 || fd >= CONFIG_NFILE_DESCRIPTORS ||
-      !list->fl_files[fd].f_inode)
+  filep = files_fget(list, fd);
+  if (filep == NULL || !filep->f_inode)
     {
       return -EBADF;
     }
@@ -371,7 +567,8 @@ int files_close(int fd)
   ret = _files_semtake(list);
   if (ret >= 0)
     {
-      ret = _files_close(&list->fl_files[fd]);
+      ret = _files_close(filep);
+      list->fl_used[FILE_ROW(fd)] &= ~((uint32_t)1 << FILE_COL(fd));
       _files_semgive(list);
     }
 
@@ -390,20 +587,9 @@ int files_close(int fd)
 void files_release(int fd)
 {
   FAR struct filelist *list;
-  int ret;
 
   list = nxsched_get_files();
   DEBUGASSERT(list != NULL);
 
-  if (fd >= 0 && fd < CONFIG_NFILE_DESCRIPTORS)
-    {
-      ret = _files_semtake(list);
-      if (ret >= 0)
-        {
-          list->fl_files[fd].f_oflags  = 0;
-          list->fl_files[fd].f_pos     = 0;
-          list->fl_files[fd].f_inode = NULL;
-          _files_semgive(list);
-        }
-    }
+  files_unreserve(list, fd);
 }
@@ -0,0 +1,160 @@
+/****************************************************************************
+ * fs/inode/fs_inodecache.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+
+#include <nuttx/fs/fs.h>
+
+#include "inode/inode.h"
+
+#ifdef CONFIG_PSEUDOFS_CACHE
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One entry of the lookup cache.  'node' is the child of 'parent' (or a
+ * top-level inode if 'parent' is NULL) and 'peer' is the node to its left
+ * in the ordered list of siblings, as returned by inode_search().
+ */
+
+struct inode_cache_s
+{
+  FAR struct inode *parent;
+  FAR struct inode *node;
+  FAR struct inode *peer;
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The direct-mapped cache.  Like the inode tree itself, it is protected by
+ * the inode semaphore.
+ */
+
+static struct inode_cache_s g_inode_cache[CONFIG_PSEUDOFS_CACHE_SIZE];
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_cache_lookup
+ *
+ * Description:
+ *   Look up the child of 'parent' whose name is the first segment of
+ *   'name'.
+ *
+ * Input Parameters:
+ *   parent - The parent inode or NULL for the top level
+ *   name   - The path, beginning with the segment to look up
+ *   slot   - Returned cache slot to be passed to inode_cache_insert()
+ *   peer   - Returned node to the left of the inode found
+ *
+ * Returned Value:
+ *   The inode found or NULL on a cache miss.
+ *
+ * Assumptions:
+ *   The caller holds the inode semaphore
+ *
+ ****************************************************************************/
+
+FAR struct inode *inode_cache_lookup(FAR struct inode *parent,
+                                     FAR const char *name,
+                                     FAR unsigned int *slot,
+                                     FAR struct inode **peer)
+{
+  FAR struct inode_cache_s *entry;
+  FAR const char *ptr;
+  uint32_t hash = 2166136261u;
+
+  /* FNV-1a hash of the parent address and the path segment */
+
+  hash = (hash ^ (uint32_t)(uintptr_t)parent) * 16777619u;
+  for (ptr = name; *ptr != '\0' && *ptr != '/'; ptr++)
+    {
+      hash = (hash ^ (uint8_t)*ptr) * 16777619u;
+    }
+
+  *slot = hash % CONFIG_PSEUDOFS_CACHE_SIZE;
+  entry = &g_inode_cache[*slot];
+
+  if (entry->node != NULL && entry->parent == parent &&
+      strncmp(entry->node->i_name, name, ptr - name) == 0 &&
+      entry->node->i_name[ptr - name] == '\0')
+    {
+      *peer = entry->peer;
+      return entry->node;
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: inode_cache_insert
+ *
+ * Description:
+ *   Remember the result of a successful search of one path segment.
+ *
+ * Assumptions:
+ *   The caller holds the inode semaphore
+ *
+ ****************************************************************************/
+
+void inode_cache_insert(unsigned int slot, FAR struct inode *parent,
+                        FAR struct inode *node, FAR struct inode *peer)
+{
+  FAR struct inode_cache_s *entry = &g_inode_cache[slot];
+
+  DEBUGASSERT(slot < CONFIG_PSEUDOFS_CACHE_SIZE && node != NULL);
+
+  entry->parent = parent;
+  entry->node   = node;
+  entry->peer   = peer;
+}
+
+/****************************************************************************
+ * Name: inode_cache_flush
+ *
+ * Description:
+ *   Discard all cache entries.  This must be called whenever an inode is
+ *   linked into or unlinked from the tree since that may change the left
+ *   peer of cached nodes or free them.
+ *
+ * Assumptions:
+ *   The caller holds the inode semaphore
+ *
+ ****************************************************************************/
+
+void inode_cache_flush(void)
+{
+  memset(g_inode_cache, 0, sizeof(g_inode_cache));
+}
+
+#endif /* CONFIG_PSEUDOFS_CACHE */
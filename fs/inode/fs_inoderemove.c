@@ -117,6 +117,10 @@ FAR struct inode *inode_unlink(FAR const char *path)
         }
 
       node->i_peer = NULL;
+
+      /* The unlinked inode must not be found in the lookup cache */
+
+      inode_cache_flush();
     }
 
   RELEASE_SEARCH(&desc);
@@ -135,6 +135,10 @@ static void inode_insert(FAR struct inode *node,
       node->i_peer = g_root_inode;
       g_root_inode = node;
     }
+
+  /* The left peer of cached inodes may have changed */
+
+  inode_cache_flush();
 }
 
 /****************************************************************************
@@ -241,6 +241,10 @@ static int _inode_search(FAR struct inode_search_s *desc)
   FAR struct inode *left    = NULL;
   FAR struct inode *above   = NULL;
   FAR const char   *relpath = NULL;
+#ifdef CONFIG_PSEUDOFS_CACHE
+  FAR struct inode *cached  = NULL;
+  unsigned int      slot    = 0;
+#endif
   int ret = -ENOENT;
 
   /* Get the search path, skipping over the leading '/'.  The leading '/' is
@@ -280,7 +284,22 @@ static int _inode_search(FAR struct inode_search_s *desc)
 
   while (node != NULL)
     {
-      int result = _inode_compare(name, node);
+      int result;
+
+#ifdef CONFIG_PSEUDOFS_CACHE
+      /* At the head of a list of peers, try the lookup cache first */
+
+      if (left == NULL)
+        {
+          cached = inode_cache_lookup(above, name, &slot, &left);
+          if (cached != NULL)
+            {
+              node = cached;
+            }
+        }
+#endif
+
+      result = _inode_compare(name, node);
 
       /* Case 1:  The name is less than the name of the node.
        * Since the names are ordered, these means that there
@@ -311,6 +330,13 @@ static int _inode_search(FAR struct inode_search_s *desc)
 
       else
         {
+#ifdef CONFIG_PSEUDOFS_CACHE
+          if (cached != node)
+            {
+              inode_cache_insert(slot, above, node, left);
+            }
+#endif
+
           /* Now there are three remaining possibilities:
            *   (1) This is the node that we are looking for.
            *   (2) The node we are looking for is "below" this one.
@@ -222,6 +222,31 @@ int inode_checkflags(FAR struct inode *inode, int oflags);
 
 int inode_search(FAR struct inode_search_s *desc);
 
+/****************************************************************************
+ * Name: inode_cache_lookup, inode_cache_insert, and inode_cache_flush
+ *
+ * Description:
+ *   Hashed (parent, name) cache of the results of inode_search(), so that
+ *   path resolution does not need to walk long lists of peers.  The cache
+ *   is flushed whenever the tree is modified.
+ *
+ * Assumptions:
+ *   The caller holds the g_inode_sem semaphore
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PSEUDOFS_CACHE
+FAR struct inode *inode_cache_lookup(FAR struct inode *parent,
+                                     FAR const char *name,
+                                     FAR unsigned int *slot,
+                                     FAR struct inode **peer);
+void inode_cache_insert(unsigned int slot, FAR struct inode *parent,
+                        FAR struct inode *node, FAR struct inode *peer);
+void inode_cache_flush(void);
+#else
+#  define inode_cache_flush()
+#endif
+
 /****************************************************************************
  * Name: inode_find
  *
@@ -392,7 +417,9 @@ void weak_function files_initialize(void);
  *
  * Description:
  *   Allocate a struct files instance and associate it with an inode
- *   instance.  Returns the file descriptor == index into the files array.
+ *   instance.  Returns the file descriptor == index into the files array
+ *   or a negated errno value:  -EMFILE if all descriptors are in use or
+ *   -ENOMEM if the storage for more descriptors could not be allocated.
  *
  ****************************************************************************/
 
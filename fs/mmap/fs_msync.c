@@ -0,0 +1,153 @@
+/****************************************************************************
+ * fs/mmap/fs_msync.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/mman.h>
+
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/cancelpt.h>
+#include <nuttx/fs/fs.h>
+
+#include "inode/inode.h"
+#include "fs_rammap.h"
+
+#ifdef CONFIG_FS_RAMMAP
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: msync
+ *
+ * Description:
+ *   msync() flushes changes made to a mapping back to the file.  Only
+ *   shared, writable mappings are written back and only if
+ *   CONFIG_FS_RAMMAP_WRITEBACK is selected; msync() does nothing for other
+ *   mappings.  Without an MMU there is no way to know which pages are
+ *   dirty, so the whole range is written.  The data is always written
+ *   before msync() returns; MS_SYNC additionally synchronizes the file
+ *   with the storage device.  MS_INVALIDATE is ignored:  All mappings of
+ *   a file share the same region.
+ *
+ * Input Parameters:
+ *   addr    The start of the address range
+ *   length  The length of the address range
+ *   flags   MS_ASYNC or MS_SYNC and, optionally, MS_INVALIDATE
+ *
+ * Returned Value:
+ *   On success, msync() returns 0, on failure -1, and errno is set:
+ *
+ *     EINVAL
+ *       Both MS_SYNC and MS_ASYNC are set in 'flags'.
+ *     ENOMEM
+ *       The address range is not mapped.
+ *
+ ****************************************************************************/
+
+int msync(FAR void *addr, size_t length, int flags)
+{
+  FAR struct fs_rammap_s *prev;
+  FAR struct fs_rammap_s *curr;
+  int ret;
+
+  /* msync() is a cancellation point */
+
+  enter_cancellation_point();
+
+  if ((flags & (MS_ASYNC | MS_SYNC)) == (MS_ASYNC | MS_SYNC))
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  rammap_initialize();
+  ret = nxsem_wait(&g_rammaps.exclsem);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  curr = rammap_find(addr, length, &prev);
+  if (curr == NULL)
+    {
+      ferr("ERROR: Region not found\n");
+      ret = -ENOMEM;
+      goto errout_with_semaphore;
+    }
+
+#ifdef CONFIG_FS_RAMMAP_WRITEBACK
+  if (curr->writeback)
+    {
+      size_t offset;
+
+      /* Clip the range to the region */
+
+      offset = (uintptr_t)addr > (uintptr_t)curr->addr ?
+               (uintptr_t)addr - (uintptr_t)curr->addr : 0;
+      if (length > curr->length - offset)
+        {
+          length = curr->length - offset;
+        }
+
+      ret = rammap_writeback(curr, offset, length);
+#ifndef CONFIG_DISABLE_MOUNTPOINT
+      if (ret >= 0 && (flags & MS_SYNC) != 0)
+        {
+          ret = file_fsync(&curr->file);
+
+          /* Only files on mounted file systems can be synchronized */
+
+          if (ret == -EINVAL)
+            {
+              ret = OK;
+            }
+        }
+#endif
+
+      if (ret < 0)
+        {
+          goto errout_with_semaphore;
+        }
+    }
+#endif
+
+  nxsem_post(&g_rammaps.exclsem);
+  leave_cancellation_point();
+  return OK;
+
+errout_with_semaphore:
+  nxsem_post(&g_rammaps.exclsem);
+
+errout:
+  leave_cancellation_point();
+  set_errno(-ret);
+  return ERROR;
+}
+
+#endif /* CONFIG_FS_RAMMAP */
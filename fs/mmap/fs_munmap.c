@@ -92,8 +92,10 @@
  *
  *   2. If CONFIG_FS_RAMMAP is defined in the configuration, then mmap() will
  *      support simulation of memory mapped files by copying files whole
- *      into RAM.  munmap() is required in this case to free the allocated
- *      memory holding the shared copy of the file.
+ *      into RAM.  munmap() is required in this case to release the
+ *      mapping.  The memory holding the copy of the file is freed (and
+ *      written back with CONFIG_FS_RAMMAP_WRITEBACK) when the last mapping
+ *      that shares it is removed.
  *
  * Input Parameters:
  *   start   The start address of the mapping to delete.  For this
@@ -123,22 +125,11 @@ int munmap(FAR void *start, size_t length)
   ret = nxsem_wait(&g_rammaps.exclsem);
   if (ret < 0)
     {
-      errcode = ret;
+      errcode = -ret;
       goto errout;
     }
 
-  /* Search the list of regions */
-
-  for (prev = NULL, curr = g_rammaps.head; curr; prev = curr, curr = curr->flink)
-    {
-      /* Does this region include any part of the specified range? */
-
-      if ((uintptr_t)start < (uintptr_t)curr->addr + curr->length &&
-          (uintptr_t)start + length >= (uintptr_t)curr->addr)
-        {
-          break;
-        }
-    }
+  curr = rammap_find(start, length, &prev);
 
   /* Did we find the region */
 
@@ -149,32 +140,22 @@ int munmap(FAR void *start, size_t length)
       goto errout_with_semaphore;
     }
 
-  /* Get the offset from the beginning of the region and the actual number
-   * of bytes to "unmap".  All mappings must extend to the end of the region.
-   * There is no support for free a block of memory but leaving a block of
-   * memory at the end.  This is a consequence of using kumm_realloc() to
-   * simulate the unmapping.
+  /* Are we unmapping from the beginning of the region (offset == 0)?  That
+   * removes one mapping of the region, whatever the length.
    */
 
   offset = start - curr->addr;
-  if (offset + length < curr->length)
+  if (offset == 0)
     {
-      ferr("ERROR: Cannot umap without unmapping to the end\n");
-      errcode = ENOSYS;
-      goto errout_with_semaphore;
-    }
-
-  /* Okay.. the region is beging umapped to the end.  Make sure the length
-   * indicates that.
-   */
+      /* The region is freed only when the last mapping is removed */
 
-  length = curr->length - offset;
-
-  /* Are we unmapping the entire region (offset == 0)? */
+      if (--curr->crefs > 0)
+        {
+          nxsem_post(&g_rammaps.exclsem);
+          return OK;
+        }
 
-  if (length >= curr->length)
-    {
-      /* Yes.. remove the mapping from the list */
+      /* Remove the region from the list */
 
       if (prev)
         {
@@ -185,21 +166,53 @@ int munmap(FAR void *start, size_t length)
           g_rammaps.head = curr->flink;
         }
 
-      /* Then free the region */
+      nxsem_post(&g_rammaps.exclsem);
 
-      kumm_free(curr);
+      /* Then write back and free the region */
+
+      rammap_free(curr);
+      return OK;
     }
 
   /* No.. We have been asked to "unmap' only a portion of the memory
-   * (offset > 0).
+   * (offset > 0).  Leave the region intact if other mappings still use it.
    */
 
-  else
+  if (curr->crefs > 1)
+    {
+      nxsem_post(&g_rammaps.exclsem);
+      return OK;
+    }
+
+  /* All mappings must extend to the end of the region.  There is no
+   * support for free a block of memory but leaving a block of memory at the
+   * end.  This is a consequence of using kumm_realloc() to simulate the
+   * unmapping.
+   */
+
+  if (offset + length < curr->length)
+    {
+      ferr("ERROR: Cannot umap without unmapping to the end\n");
+      errcode = ENOSYS;
+      goto errout_with_semaphore;
+    }
+
+#ifdef CONFIG_FS_RAMMAP_WRITEBACK
+  rammap_writeback(curr, offset, curr->length - offset);
+#endif
+
+  /* Shrink the allocation holding the region header and data so that it
+   * keeps only the first 'offset' bytes.
+   */
+
+  newaddr = kumm_realloc(curr, sizeof(struct fs_rammap_s) + offset);
+  DEBUGASSERT(newaddr == (FAR void *)curr);
+  UNUSED(newaddr); /* May not be used */
+
+  curr->length = offset;
+  if (curr->valid > offset)
     {
-      newaddr = kumm_realloc(curr->addr, sizeof(struct fs_rammap_s) + length);
-      DEBUGASSERT(newaddr == (FAR void *)(curr->addr));
-      UNUSED(newaddr); /* May not be used */
-      curr->length = length;
+      curr->valid = offset;
     }
 
   nxsem_post(&g_rammaps.exclsem);
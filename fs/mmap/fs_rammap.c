@@ -42,8 +42,11 @@
 #include <sys/types.h>
 #include <sys/mman.h>
 
+#include <sys/stat.h>
+
 #include <string.h>
 #include <unistd.h>
+#include <fcntl.h>
 #include <errno.h>
 #include <debug.h>
 
@@ -95,17 +98,24 @@ void rammap_initialize(void)
  *
  * Description:
  *   Support simulation of memory mapped files by copying files into RAM.
+ *   Mappings of the same file at the same offset share the same region
+ *   unless the mapping is both private and writable.
  *
  * Input Parameters:
  *   fd      file descriptor of the backing file -- required.
  *   length  The length of the mapping.  For exception #1 above, this length
  *           ignored:  The entire underlying media is always accessible.
  *   offset  The offset into the file to map
+ *   prot    The mmap() memory protection flags
+ *   flags   The mmap() mapping flags
  *
  * Returned Value:
  *   On success, rammmap() returns a pointer to the mapped area. On error, the
  *   value MAP_FAILED is returned, and errno is set  appropriately.
  *
+ *     EACCES
+ *       A shared, writable mapping of a file not open for writing was
+ *       requested.
  *     EBADF
  *      'fd' is not a valid file descriptor.
  *     EINVAL
@@ -115,29 +125,112 @@ void rammap_initialize(void)
  *
  ****************************************************************************/
 
-FAR void *rammap(int fd, size_t length, off_t offset)
+FAR void *rammap(int fd, size_t length, off_t offset, int prot, int flags)
 {
   FAR struct fs_rammap_s *map;
+  FAR struct inode *inode = NULL;
+  FAR struct file *filep;
   FAR uint8_t *alloc;
   FAR uint8_t *rdbuffer;
+  struct stat buf;
+  ino_t ino = 0;
   ssize_t nread;
-  off_t fpos;
+  size_t remaining;
+#ifdef CONFIG_FS_RAMMAP_WRITEBACK
+  bool writeback;
+#endif
   int errcode;
   int ret;
 
-  /* There is a major design flaw that I have not yet thought of fix for:
-   * The goal is to have a single region of memory that represents a single
-   * file and can be shared by many threads.  That is, given a filename a
-   * thread should be able to open the file, get a file descriptor, and
-   * call mmap() to get a memory region.  Different file descriptors opened
-   * with the same file path should get the same memory region when mapped.
-   *
-   * The design flaw is that I don't have sufficient knowledge to know that
-   * these different file descriptors map to the same file.  So, for the time
-   * being, a new memory region is created each time that rammap() is called.
-   * Not very useful!
+  ret = fs_getfilep(fd, &filep);
+  if (ret < 0)
+    {
+      errcode = -ret;
+      goto errout;
+    }
+
+#ifdef CONFIG_FS_RAMMAP_WRITEBACK
+  /* Changes to a shared, writable mapping are written back to the file */
+
+  writeback = (flags & MAP_SHARED) != 0 && (prot & PROT_WRITE) != 0;
+  if (writeback && (filep->f_oflags & O_WROK) == 0)
+    {
+      errcode = EACCES;
+      goto errout;
+    }
+#endif
+
+  /* Changes to a private, writable mapping must not be seen by any other
+   * mapping.  Otherwise, try to share the region if the file can be
+   * identified.  All files in a mount point share the inode of the mount
+   * point:  The file serial number tells them apart, but not all file
+   * systems provide one.
    */
 
+  if ((flags & MAP_PRIVATE) == 0 || (prot & PROT_WRITE) == 0)
+    {
+      inode = filep->f_inode;
+      if (INODE_IS_MOUNTPT(inode))
+        {
+          ret = file_fstat(filep, &buf);
+          if (ret < 0 || buf.st_ino == 0)
+            {
+              inode = NULL;
+            }
+          else
+            {
+              ino = buf.st_ino;
+            }
+        }
+    }
+
+  rammap_initialize();
+
+  if (inode != NULL)
+    {
+      /* Look for an existing region that covers the requested mapping */
+
+      ret = nxsem_wait(&g_rammaps.exclsem);
+      if (ret < 0)
+        {
+          errcode = -ret;
+          goto errout;
+        }
+
+      for (map = g_rammaps.head; map != NULL; map = map->flink)
+        {
+          if (map->inode == inode && map->ino == ino &&
+              map->offset == offset && map->length >= length)
+            {
+              break;
+            }
+        }
+
+      if (map != NULL)
+        {
+#ifdef CONFIG_FS_RAMMAP_WRITEBACK
+          if (writeback && !map->writeback)
+            {
+              ret = file_dup2(filep, &map->file);
+              if (ret < 0)
+                {
+                  nxsem_post(&g_rammaps.exclsem);
+                  errcode = -ret;
+                  goto errout;
+                }
+
+              map->writeback = true;
+            }
+#endif
+
+          map->crefs++;
+          nxsem_post(&g_rammaps.exclsem);
+          return map->addr;
+        }
+
+      nxsem_post(&g_rammaps.exclsem);
+    }
+
   /* Allocate a region of memory of the specified size */
 
   alloc = (FAR uint8_t *)kumm_malloc(sizeof(struct fs_rammap_s) + length);
@@ -155,27 +248,18 @@ FAR void *rammap(int fd, size_t length, off_t offset)
   map->addr   = alloc + sizeof(struct fs_rammap_s);
   map->length = length;
   map->offset = offset;
+  map->crefs  = 1;
 
-  /* Seek to the specified file offset */
-
-  fpos = lseek(fd, offset,  SEEK_SET);
-  if (fpos == (off_t)-1)
-    {
-      /* Seek failed... errno has already been set, but EINVAL is probably
-       * the correct response.
-       */
-
-      ferr("ERROR: Seek to position %d failed\n", (int)offset);
-      errcode = EINVAL;
-      goto errout_with_region;
-    }
-
-  /* Read the file data into the memory region */
+  /* Read the file data into the memory region.  This does not change the
+   * file position of the caller's file descriptor.
+   */
 
-  rdbuffer = map->addr;
-  while (length > 0)
+  rdbuffer  = map->addr;
+  remaining = length;
+  while (remaining > 0)
     {
-      nread = nx_read(fd, rdbuffer, length);
+      nread = file_pread(filep, rdbuffer, remaining,
+                         offset + (off_t)(length - remaining));
       if (nread < 0)
         {
           /* Handle the special case where the read was interrupted by a
@@ -192,6 +276,8 @@ FAR void *rammap(int fd, size_t length, off_t offset)
               errcode = (int)-nread;
               goto errout_with_region;
             }
+
+          continue;
         }
 
       /* Check for end of file. */
@@ -203,22 +289,50 @@ FAR void *rammap(int fd, size_t length, off_t offset)
 
       /* Increment number of bytes read */
 
-      rdbuffer += nread;
-      length   -= nread;
+      rdbuffer  += nread;
+      remaining -= nread;
     }
 
   /* Zero any memory beyond the amount read from the file */
 
-  memset(rdbuffer, 0, length);
+  memset(rdbuffer, 0, remaining);
+  map->valid = length - remaining;
+
+#ifdef CONFIG_FS_RAMMAP_WRITEBACK
+  if (writeback)
+    {
+      ret = file_dup2(filep, &map->file);
+      if (ret < 0)
+        {
+          errcode = -ret;
+          goto errout_with_region;
+        }
+
+      map->writeback = true;
+    }
+#endif
 
-  /* Add the buffer to the list of regions */
+  /* Hold a reference to the inode so that it cannot be reused for another
+   * file while it identifies the region.
+   */
+
+  if (inode != NULL && inode_addref(inode) >= 0)
+    {
+      map->inode = inode;
+      map->ino   = ino;
+    }
+
+  /* Add the buffer to the list of regions.  If another thread mapped the
+   * same file meanwhile, there will be two regions for it; that costs only
+   * memory.
+   */
 
-  rammap_initialize();
   ret = nxsem_wait(&g_rammaps.exclsem);
   if (ret < 0)
     {
+      rammap_free(map);
       errcode = -ret;
-      goto errout_with_region;
+      goto errout;
     }
 
   map->flink  = g_rammaps.head;
@@ -235,4 +349,140 @@ errout:
   return MAP_FAILED;
 }
 
+/****************************************************************************
+ * Name: rammap_find
+ *
+ * Description:
+ *   Find the region that contains any part of the address range.
+ *
+ * Input Parameters:
+ *   addr    The start of the address range
+ *   length  The length of the address range
+ *   prev    The location to return the region before it in the list
+ *
+ * Returned Value:
+ *   The region or NULL if the range is not mapped.
+ *
+ * Assumptions:
+ *   The caller holds g_rammaps.exclsem.
+ *
+ ****************************************************************************/
+
+FAR struct fs_rammap_s *rammap_find(FAR void *addr, size_t length,
+                                    FAR struct fs_rammap_s **prev)
+{
+  FAR struct fs_rammap_s *curr;
+
+  for (*prev = NULL, curr = g_rammaps.head;
+       curr != NULL;
+       *prev = curr, curr = curr->flink)
+    {
+      /* Does this region include any part of the specified range? */
+
+      if ((uintptr_t)addr < (uintptr_t)curr->addr + curr->length &&
+          (uintptr_t)addr + length >= (uintptr_t)curr->addr)
+        {
+          break;
+        }
+    }
+
+  return curr;
+}
+
+#ifdef CONFIG_FS_RAMMAP_WRITEBACK
+/****************************************************************************
+ * Name: rammap_writeback
+ *
+ * Description:
+ *   Write a range of a write-back region to the file.  Nothing is written
+ *   for other regions or beyond the end of file at the time of mapping.
+ *
+ * Input Parameters:
+ *   map     The region
+ *   offset  The offset of the range from the start of the region
+ *   length  The length of the range
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int rammap_writeback(FAR struct fs_rammap_s *map, size_t offset,
+                     size_t length)
+{
+  ssize_t nwritten;
+
+  if (!map->writeback || offset >= map->valid)
+    {
+      return OK;
+    }
+
+  /* A mapping cannot extend the file */
+
+  if (length > map->valid - offset)
+    {
+      length = map->valid - offset;
+    }
+
+  while (length > 0)
+    {
+      nwritten = file_pwrite(&map->file, (FAR uint8_t *)map->addr + offset,
+                             length, map->offset + (off_t)offset);
+      if (nwritten < 0)
+        {
+          if (nwritten == -EINTR)
+            {
+              continue;
+            }
+
+          ferr("ERROR: Write-back failed: offset=%d errno=%d\n",
+               (int)(map->offset + offset), (int)nwritten);
+          return (int)nwritten;
+        }
+      else if (nwritten == 0)
+        {
+          return -EIO;
+        }
+
+      offset += nwritten;
+      length -= nwritten;
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: rammap_free
+ *
+ * Description:
+ *   Release the resources of a region that has been removed from the list
+ *   of regions, writing it back to the file first if necessary.
+ *
+ * Input Parameters:
+ *   map     The region
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void rammap_free(FAR struct fs_rammap_s *map)
+{
+#ifdef CONFIG_FS_RAMMAP_WRITEBACK
+  if (map->writeback)
+    {
+      rammap_writeback(map, 0, map->length);
+      file_close(&map->file);
+    }
+#endif
+
+  if (map->inode != NULL)
+    {
+      inode_release(map->inode);
+    }
+
+  kumm_free(map);
+}
+
 #endif /* CONFIG_FS_RAMMAP */
@@ -45,6 +45,10 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <nuttx/fs/fs.h>
 #include <nuttx/semaphore.h>
 
 #ifdef CONFIG_FS_RAMMAP
@@ -65,9 +69,15 @@
  * - All of the file must be present in memory.  This limits the size of
  *   files that may be memory mapped (especially on MCUs with no significant
  *   RAM resources).
- * - All mapped files are read-only.  You can write to the in-memory image,
- *   but the file contents will not change.
+ * - Unless CONFIG_FS_RAMMAP_WRITEBACK is selected, all mapped files are
+ *   read-only.  You can write to the in-memory image, but the file
+ *   contents will not change.
  * - There are not access privileges.
+ *
+ * Mappings of the same file at the same offset share one region when the
+ * file can be identified:  'inode' is the inode of a driver or of a
+ * pseudo-file, or the mount point inode together with a non-zero 'ino'
+ * reported by fstat().  'inode' is NULL for regions that are not shared.
  */
 
 struct fs_rammap_s
@@ -75,7 +85,15 @@ struct fs_rammap_s
   struct fs_rammap_s *flink;       /* Implements a singly linked list */
   FAR void           *addr;        /* Start of allocated memory */
   size_t              length;      /* Length of region */
+  size_t              valid;       /* Length of region backed by the file */
   off_t               offset;      /* File offset */
+  FAR struct inode   *inode;       /* Mapped file inode (NULL: not shared) */
+  ino_t               ino;         /* File serial number in a mount point */
+  uint16_t            crefs;       /* Number of mappings of the region */
+#ifdef CONFIG_FS_RAMMAP_WRITEBACK
+  bool                writeback;   /* True: Write changes back to the file */
+  struct file         file;        /* Open file used for the write-back */
+#endif
 };
 
 /* This structure defines all "mapped" files */
@@ -126,11 +144,16 @@ void rammap_initialize(void);
  *   length  The length of the mapping.  For exception #1 above, this length
  *           ignored:  The entire underlying media is always accessible.
  *   offset  The offset into the file to map
+ *   prot    The mmap() memory protection flags
+ *   flags   The mmap() mapping flags
  *
  * Returned Value:
  *   On success, rammmap() returns a pointer to the mapped area. On error, the
  *   value MAP_FAILED is returned, and errno is set  appropriately.
  *
+ *     EACCES
+ *       A shared, writable mapping of a file not open for writing was
+ *       requested.
  *     EBADF
  *      'fd' is not a valid file descriptor.
  *     EINVAL
@@ -140,7 +163,68 @@ void rammap_initialize(void);
  *
  ****************************************************************************/
 
-FAR void *rammap(int fd, size_t length, off_t offset);
+FAR void *rammap(int fd, size_t length, off_t offset, int prot, int flags);
+
+/****************************************************************************
+ * Name: rammap_find
+ *
+ * Description:
+ *   Find the region that contains any part of the address range.
+ *
+ * Input Parameters:
+ *   addr    The start of the address range
+ *   length  The length of the address range
+ *   prev    The location to return the region before it in the list
+ *
+ * Returned Value:
+ *   The region or NULL if the range is not mapped.
+ *
+ * Assumptions:
+ *   The caller holds g_rammaps.exclsem.
+ *
+ ****************************************************************************/
+
+FAR struct fs_rammap_s *rammap_find(FAR void *addr, size_t length,
+                                    FAR struct fs_rammap_s **prev);
+
+#ifdef CONFIG_FS_RAMMAP_WRITEBACK
+/****************************************************************************
+ * Name: rammap_writeback
+ *
+ * Description:
+ *   Write a range of a write-back region to the file.  Nothing is written
+ *   for other regions or beyond the end of file at the time of mapping.
+ *
+ * Input Parameters:
+ *   map     The region
+ *   offset  The offset of the range from the start of the region
+ *   length  The length of the range
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int rammap_writeback(FAR struct fs_rammap_s *map, size_t offset,
+                     size_t length);
+#endif
+
+/****************************************************************************
+ * Name: rammap_free
+ *
+ * Description:
+ *   Release the resources of a region that has been removed from the list
+ *   of regions, writing it back to the file first if necessary.
+ *
+ * Input Parameters:
+ *   map     The region
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void rammap_free(FAR struct fs_rammap_s *map);
 
 #endif /* CONFIG_FS_RAMMAP */
 #endif /* __FS_MMAP_RAMMAP_H */
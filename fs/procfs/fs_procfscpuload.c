@@ -69,7 +69,17 @@
  * to handle the longest line generated by this logic.
  */
 
-#define CPULOAD_LINELEN 16
+#ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
+#  ifdef CONFIG_SMP
+#    define CPULOAD_NCPUS CONFIG_SMP_NCPUS
+#  else
+#    define CPULOAD_NCPUS 1
+#  endif
+#  define CPULOAD_CPULEN  64
+#  define CPULOAD_LINELEN (16 + CPULOAD_NCPUS * CPULOAD_CPULEN)
+#else
+#  define CPULOAD_LINELEN 16
+#endif
 
 /****************************************************************************
  * Private Types
@@ -226,6 +236,9 @@ static ssize_t cpuload_read(FAR struct file *filep, FAR char *buffer,
       struct cpuload_s cpuload;
       uint32_t intpart;
       uint32_t fracpart;
+#ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
+      int cpu;
+#endif
 
       /* Sample the counts for the IDLE thread.  clock_cpuload should only
        * fail if the PID is not valid.  This, however, should never happen
@@ -255,6 +268,29 @@ static ssize_t cpuload_read(FAR struct file *filep, FAR char *buffer,
       linesize = snprintf(attr->line, CPULOAD_LINELEN, "%3d.%01d%%\n",
                           intpart, fracpart);
 
+#ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
+      /* Then the time that each CPU has spent in its IDLE thread and in
+       * interrupt handlers.  The IDLE thread of CPU n has PID n.
+       */
+
+      for (cpu = 0; cpu < CPULOAD_NCPUS; cpu++)
+        {
+          struct timespec idle;
+          struct timespec irq;
+
+          DEBUGVERIFY(clock_cpuload_runtime(cpu, &idle));
+          DEBUGVERIFY(clock_cpuload_irqtime(cpu, &irq));
+
+          linesize += snprintf(&attr->line[linesize],
+                               CPULOAD_LINELEN - linesize,
+                               "CPU%d: idle %lu.%06lu irq %lu.%06lu\n",
+                               cpu, (unsigned long)idle.tv_sec,
+                               (unsigned long)idle.tv_nsec / 1000,
+                               (unsigned long)irq.tv_sec,
+                               (unsigned long)irq.tv_nsec / 1000);
+        }
+#endif
+
       /* Save the linesize in case we are re-entered with f_pos > 0 */
 
       attr->linesize = linesize;
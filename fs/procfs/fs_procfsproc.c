@@ -95,6 +95,9 @@ enum proc_node_e
 #ifdef CONFIG_SCHED_CPULOAD
   PROC_LOADAVG,                       /* Average CPU utilization */
 #endif
+#ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
+  PROC_RUNTIME,                       /* Total execution time */
+#endif
 #ifdef CONFIG_SCHED_CRITMONITOR
   PROC_CRITMON,                       /* Critical section monitor */
 #endif
@@ -178,6 +181,11 @@ static ssize_t proc_loadavg(FAR struct proc_file_s *procfile,
                  FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
                  off_t offset);
 #endif
+#ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
+static ssize_t proc_runtime(FAR struct proc_file_s *procfile,
+                 FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
+                 off_t offset);
+#endif
 #ifdef CONFIG_SCHED_CRITMONITOR
 static ssize_t proc_critmon(FAR struct proc_file_s *procfile,
                  FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
@@ -272,6 +280,13 @@ static const struct proc_node_s g_loadavg =
 };
 #endif
 
+#ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
+static const struct proc_node_s g_runtime =
+{
+  "runtime",       "runtime", (uint8_t)PROC_RUNTIME,     DTYPE_FILE        /* Total execution time */
+};
+#endif
+
 #ifdef CONFIG_SCHED_CRITMONITOR
 static const struct proc_node_s g_critmon =
 {
@@ -316,6 +331,9 @@ static FAR const struct proc_node_s * const g_nodeinfo[] =
 #ifdef CONFIG_SCHED_CPULOAD
   &g_loadavg,      /* Average CPU utilization */
 #endif
+#ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
+  &g_runtime,      /* Total execution time */
+#endif
 #ifdef CONFIG_SCHED_CRITMONITOR
   &g_critmon,      /* Critical section Monitor */
 #endif
@@ -339,6 +357,9 @@ static const struct proc_node_s * const g_level0info[] =
 #ifdef CONFIG_SCHED_CPULOAD
   &g_loadavg,      /* Average CPU utilization */
 #endif
+#ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
+  &g_runtime,      /* Total execution time */
+#endif
 #ifdef CONFIG_SCHED_CRITMONITOR
   &g_critmon,      /* Critical section monitor */
 #endif
@@ -778,6 +799,39 @@ static ssize_t proc_loadavg(FAR struct proc_file_s *procfile,
 }
 #endif
 
+/****************************************************************************
+ * Name: proc_runtime
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
+static ssize_t proc_runtime(FAR struct proc_file_s *procfile,
+                            FAR struct tcb_s *tcb, FAR char *buffer,
+                            size_t buflen, off_t offset)
+{
+  struct timespec runtime;
+  size_t linesize;
+  size_t copysize;
+
+  /* clock_cpuload_runtime should only fail if the thread exited sometime
+   * after the procfs entry was opened.
+   */
+
+  if (clock_cpuload_runtime(procfile->pid, &runtime) < 0)
+    {
+      runtime.tv_sec  = 0;
+      runtime.tv_nsec = 0;
+    }
+
+  linesize = snprintf(procfile->line, STATUS_LINELEN, "%lu.%09lu\n",
+                      (unsigned long)runtime.tv_sec,
+                      (unsigned long)runtime.tv_nsec);
+  copysize = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                           &offset);
+
+  return copysize;
+}
+#endif
+
 /****************************************************************************
  * Name: proc_critmon
  ****************************************************************************/
@@ -910,7 +964,7 @@ static ssize_t proc_stack(FAR struct proc_file_s *procfile,
   /* Show the stack size */
 
   linesize   = snprintf(procfile->line, STATUS_LINELEN, "%-12s%ld\n",
-                        "StackUsed:", (long)up_check_tcbstack(tcb));
+                        "StackUsed:", (long)nxsched_check_tcbstack(tcb));
   copysize   = procfs_memcpy(procfile->line, linesize, buffer, remaining,
                              &offset);
 
@@ -1103,13 +1157,12 @@ static ssize_t proc_groupfd(FAR struct proc_file_s *procfile,
 
   /* Examine each open file descriptor */
 
-  for (i = 0, file = group->tg_filelist.fl_files;
-       i < CONFIG_NFILE_DESCRIPTORS;
-       i++, file++)
+  for (i = 0; i < CONFIG_NFILE_DESCRIPTORS; i++)
     {
       /* Is there an inode associated with the file descriptor? */
 
-      if (file->f_inode)
+      file = files_fget(&group->tg_filelist, i);
+      if (file != NULL && file->f_inode)
         {
           linesize   = snprintf(procfile->line, STATUS_LINELEN,
                                 "%3d %8ld %04x\n", i, (long)file->f_pos,
@@ -1454,6 +1507,11 @@ static ssize_t proc_read(FAR struct file *filep, FAR char *buffer,
       ret = proc_loadavg(procfile, tcb, buffer, buflen, filep->f_pos);
       break;
 #endif
+#ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
+    case PROC_RUNTIME: /* Total execution time */
+      ret = proc_runtime(procfile, tcb, buffer, buflen, filep->f_pos);
+      break;
+#endif
 #ifdef CONFIG_SCHED_CRITMONITOR
     case PROC_CRITMON: /* Critical section monitor */
       ret = proc_critmon(procfile, tcb, buffer, buflen, filep->f_pos);
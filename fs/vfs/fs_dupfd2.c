@@ -81,17 +81,12 @@ int fs_dupfd2(int fd1, int fd2)
   /* Get the file structures corresponding to the file descriptors. */
 
   ret = fs_getfilep(fd1, &filep1);
-  if (ret >= 0)
-    {
-      ret = fs_getfilep(fd2, &filep2);
-    }
-
   if (ret < 0)
     {
       return ret;
     }
 
-  DEBUGASSERT(filep1 != NULL && filep2 != NULL);
+  DEBUGASSERT(filep1 != NULL);
 
   /* Verify that fd1 is a valid, open file descriptor */
 
@@ -107,7 +102,23 @@ int fs_dupfd2(int fd1, int fd2)
       return fd1;
     }
 
+  /* Reserve fd2, allocating storage for it if it has never been used */
+
+  ret = files_reserve(nxsched_get_files(), fd2, &filep2);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  DEBUGASSERT(filep2 != NULL);
+
   /* Perform the dup2 operation */
 
-  return file_dup2(filep1, filep2);
+  ret = file_dup2(filep1, filep2);
+  if (ret < 0 && !DUP_ISOPEN(filep2))
+    {
+      files_unreserve(nxsched_get_files(), fd2);
+    }
+
+  return ret;
 }
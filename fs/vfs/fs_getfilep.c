@@ -102,6 +102,6 @@ int fs_getfilep(int fd, FAR struct file **filep)
 
   /* And return the file pointer from the list */
 
-  *filep = &list->fl_files[fd];
-  return OK;
+  *filep = files_fget(list, fd);
+  return *filep != NULL ? OK : -EBADF;
 }
@@ -0,0 +1,488 @@
+/****************************************************************************
+ * graphics/vnc/server/vnc_hextile.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <assert.h>
+#include <errno.h>
+
+#if defined(CONFIG_VNCSERVER_DEBUG) && !defined(CONFIG_DEBUG_GRAPHICS)
+#  undef  CONFIG_DEBUG_ERROR
+#  undef  CONFIG_DEBUG_WARN
+#  undef  CONFIG_DEBUG_INFO
+#  undef  CONFIG_DEBUG_GRAPHICS_ERROR
+#  undef  CONFIG_DEBUG_GRAPHICS_WARN
+#  undef  CONFIG_DEBUG_GRAPHICS_INFO
+#  define CONFIG_DEBUG_ERROR          1
+#  define CONFIG_DEBUG_WARN           1
+#  define CONFIG_DEBUG_INFO           1
+#  define CONFIG_DEBUG_GRAPHICS       1
+#  define CONFIG_DEBUG_GRAPHICS_ERROR 1
+#  define CONFIG_DEBUG_GRAPHICS_WARN  1
+#  define CONFIG_DEBUG_GRAPHICS_INFO  1
+#endif
+#include <debug.h>
+
+#include "vnc_server.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The number of sub-rectangles in a tile is sent in a single byte */
+
+#define HEXTILE_MAX_SUBRECTS 255
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Background and foreground colors carried over from the previous tile */
+
+struct hextile_state_s
+{
+  uint32_t bg;
+  uint32_t fg;
+  bool bgvalid;
+  bool fgvalid;
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vnc_hextile_subrects
+ *
+ * Description:
+ *  Cover all non-background pixels of a tile with single-color
+ *  sub-rectangles.  Each sub-rectangle is grown first to the right and then
+ *  downward over pixels of the same color that are not yet covered.
+ *
+ *  The same deterministic walk is used twice: once with a NULL stream to
+ *  count the sub-rectangles, then again to send them.
+ *
+ * Input Parameters:
+ *   stream  - The output stream or NULL to only count the sub-rectangles.
+ *   pixels  - The tile pixels in the remote color format.
+ *   width   - The width of the tile.
+ *   height  - The height of the tile.
+ *   bg      - The background color of the tile.
+ *   colored - True: each sub-rectangle is preceded by its color.
+ *   limit   - The maximum number of sub-rectangles to generate.
+ *
+ * Returned Value:
+ *   The number of sub-rectangles; -E2BIG if more than 'limit' would be
+ *   needed; or a negated errno value if the send failed.
+ *
+ ****************************************************************************/
+
+static int vnc_hextile_subrects(FAR struct vnc_tilestream_s *stream,
+                                FAR const uint32_t *pixels,
+                                nxgl_coord_t width, nxgl_coord_t height,
+                                uint32_t bg, bool colored, int limit)
+{
+  uint16_t done[VNC_TILE_SIZE];
+  uint8_t subrect[2];
+  uint32_t color;
+  uint32_t mask;
+  nxgl_coord_t subwidth;
+  nxgl_coord_t subheight;
+  nxgl_coord_t x;
+  nxgl_coord_t y;
+  nxgl_coord_t i;
+  int nsubrects = 0;
+  int ret;
+
+  for (y = 0; y < height; y++)
+    {
+      done[y] = 0;
+    }
+
+  for (y = 0; y < height; y++)
+    {
+      for (x = 0; x < width; x++)
+        {
+          color = pixels[y * width + x];
+          if (color == bg || (done[y] & (1 << x)) != 0)
+            {
+              continue;
+            }
+
+          /* Grow to the right along this row */
+
+          for (subwidth = 1; x + subwidth < width; subwidth++)
+            {
+              if (pixels[y * width + x + subwidth] != color ||
+                  (done[y] & (1 << (x + subwidth))) != 0)
+                {
+                  break;
+                }
+            }
+
+          /* Then grow downward while the whole span matches */
+
+          mask = ((1u << subwidth) - 1) << x;
+
+          for (subheight = 1; y + subheight < height; subheight++)
+            {
+              FAR const uint32_t *row = &pixels[(y + subheight) * width];
+
+              if ((done[y + subheight] & mask) != 0)
+                {
+                  break;
+                }
+
+              i = x;
+              while (i < x + subwidth && row[i] == color)
+                {
+                  i++;
+                }
+
+              if (i < x + subwidth)
+                {
+                  break;
+                }
+            }
+
+          for (i = y; i < y + subheight; i++)
+            {
+              done[i] |= (uint16_t)mask;
+            }
+
+          if (++nsubrects > limit)
+            {
+              return -E2BIG;
+            }
+
+          if (stream != NULL)
+            {
+              if (colored)
+                {
+                  ret = vnc_tile_putpixel(stream, color);
+                  if (ret < 0)
+                    {
+                      return ret;
+                    }
+                }
+
+              subrect[0] = (uint8_t)((x << 4) | y);
+              subrect[1] = (uint8_t)(((subwidth - 1) << 4) |
+                                     (subheight - 1));
+
+              ret = vnc_tile_put(stream, subrect, 2);
+              if (ret < 0)
+                {
+                  return ret;
+                }
+            }
+        }
+    }
+
+  return nsubrects;
+}
+
+/****************************************************************************
+ * Name: vnc_hextile_tile
+ *
+ * Description:
+ *  Encode and send one tile, choosing between a solid tile, a two-color
+ *  tile, a tile of colored sub-rectangles and a raw tile, whichever is the
+ *  smallest.
+ *
+ * Input Parameters:
+ *   stream - The output stream.
+ *   state  - Colors carried over from the previous tile.
+ *   pixels - The tile pixels in the remote color format.
+ *   width  - The width of the tile.
+ *   height - The height of the tile.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value if the send failed.
+ *
+ ****************************************************************************/
+
+static int vnc_hextile_tile(FAR struct vnc_tilestream_s *stream,
+                            FAR struct hextile_state_s *state,
+                            FAR const uint32_t *pixels,
+                            nxgl_coord_t width, nxgl_coord_t height)
+{
+  unsigned int npixels = width * height;
+  unsigned int ncolors = 1;
+  unsigned int count0 = 0;
+  unsigned int count1 = 0;
+  unsigned int subsize;
+  unsigned int hdrsize;
+  unsigned int rawsize;
+  unsigned int i;
+  uint32_t c0 = pixels[0];
+  uint32_t c1 = 0;
+  uint32_t bg;
+  uint32_t fg;
+  uint8_t encoding;
+  uint8_t nsubrects;
+  bool colored;
+  int limit;
+  int ret;
+
+  /* Find the first two colors and count them, stopping at a third */
+
+  for (i = 0; i < npixels; i++)
+    {
+      if (pixels[i] == c0)
+        {
+          count0++;
+        }
+      else if (ncolors == 1)
+        {
+          c1 = pixels[i];
+          count1 = 1;
+          ncolors = 2;
+        }
+      else if (pixels[i] == c1)
+        {
+          count1++;
+        }
+      else
+        {
+          ncolors = 3;
+          break;
+        }
+    }
+
+  if (ncolors == 1)
+    {
+      /* A solid tile is just the (possibly carried over) background */
+
+      encoding = 0;
+      if (!state->bgvalid || state->bg != c0)
+        {
+          encoding = RFB_HEXTILE_BACK;
+        }
+
+      ret = vnc_tile_put(stream, &encoding, 1);
+      if (ret >= 0 && encoding != 0)
+        {
+          ret = vnc_tile_putpixel(stream, c0);
+        }
+
+      state->bg      = c0;
+      state->bgvalid = true;
+      return ret;
+    }
+
+  /* Two colors use the most frequent as the background and the other as
+   * the foreground.  Otherwise every sub-rectangle carries its own color.
+   */
+
+  colored = (ncolors > 2);
+  if (colored || count0 >= count1)
+    {
+      bg = c0;
+      fg = c1;
+    }
+  else
+    {
+      bg = c1;
+      fg = c0;
+    }
+
+  encoding = RFB_HEXTILE_ANY;
+  hdrsize  = 2;
+
+  if (!state->bgvalid || state->bg != bg)
+    {
+      encoding |= RFB_HEXTILE_BACK;
+      hdrsize  += stream->pixsize;
+    }
+
+  if (colored)
+    {
+      encoding |= RFB_HEXTILE_COLORED;
+      subsize   = stream->pixsize + 2;
+    }
+  else
+    {
+      if (!state->fgvalid || state->fg != fg)
+        {
+          encoding |= RFB_HEXTILE_FORE;
+          hdrsize  += stream->pixsize;
+        }
+
+      subsize = 2;
+    }
+
+  /* Only use sub-rectangles if that is smaller than the raw tile */
+
+  rawsize = npixels * stream->pixsize;
+  limit   = 0;
+
+  if (rawsize > hdrsize)
+    {
+      limit = MIN((rawsize - hdrsize) / subsize, HEXTILE_MAX_SUBRECTS);
+    }
+
+  ret = vnc_hextile_subrects(NULL, pixels, width, height, bg, colored,
+                             limit);
+  if (ret <= 0)
+    {
+      encoding = RFB_HEXTILE_RAW;
+      ret = vnc_tile_put(stream, &encoding, 1);
+
+      for (i = 0; ret >= 0 && i < npixels; i++)
+        {
+          ret = vnc_tile_putpixel(stream, pixels[i]);
+        }
+
+      /* Neither color may be carried over a raw tile */
+
+      state->bgvalid = false;
+      state->fgvalid = false;
+      return ret;
+    }
+
+  nsubrects = (uint8_t)ret;
+
+  ret = vnc_tile_put(stream, &encoding, 1);
+  if (ret >= 0 && (encoding & RFB_HEXTILE_BACK) != 0)
+    {
+      ret = vnc_tile_putpixel(stream, bg);
+    }
+
+  if (ret >= 0 && (encoding & RFB_HEXTILE_FORE) != 0)
+    {
+      ret = vnc_tile_putpixel(stream, fg);
+    }
+
+  if (ret >= 0)
+    {
+      ret = vnc_tile_put(stream, &nsubrects, 1);
+    }
+
+  if (ret >= 0)
+    {
+      ret = vnc_hextile_subrects(stream, pixels, width, height, bg,
+                                 colored, nsubrects);
+    }
+
+  state->bg      = bg;
+  state->bgvalid = true;
+  state->fg      = fg;
+  state->fgvalid = !colored;
+  return ret < 0 ? ret : OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vnc_hextile
+ *
+ * Description:
+ *  Send the framebuffer update using the Hextile encoding if the client
+ *  supports it.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect  - Describes the rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   Zero is returned if Hextile coding was not performed (but no error was
+ *   encountered).  Otherwise, the size of the framebuffer update message
+ *   is returned on success or a negated errno value is returned on failure
+ *   that indicates the nature of the failure.  A failure is only
+ *   returned in cases of a network failure and unexpected internal failures.
+ *
+ ****************************************************************************/
+
+int vnc_hextile(FAR struct vnc_session_s *session,
+                FAR struct nxgl_rect_s *rect)
+{
+  struct vnc_tilestream_s stream;
+  struct hextile_state_s state;
+  struct nxgl_rect_s tile;
+  uint8_t colorfmt;
+  int ret;
+
+  /* Check if the client supports the Hextile encoding */
+
+  if (!session->hextile)
+    {
+      return 0;
+    }
+
+  /* Snapshot the client pixel format.  It may change asynchronously if a
+   * SetPixelFormat is received, but one rectangle must be encoded
+   * consistently.
+   */
+
+  colorfmt = session->colorfmt;
+  vnc_tile_begin(&stream, session, rect, RFB_ENCODING_HEXTILE,
+                 (session->bpp + 7) >> 3);
+
+  state.bgvalid = false;
+  state.fgvalid = false;
+
+  /* Send each 16x16 tile, left-to-right and top-to-bottom */
+
+  for (tile.pt1.y = rect->pt1.y; tile.pt1.y <= rect->pt2.y;
+       tile.pt1.y += VNC_TILE_SIZE)
+    {
+      tile.pt2.y = MIN(tile.pt1.y + VNC_TILE_SIZE - 1, rect->pt2.y);
+
+      for (tile.pt1.x = rect->pt1.x; tile.pt1.x <= rect->pt2.x;
+           tile.pt1.x += VNC_TILE_SIZE)
+        {
+          tile.pt2.x = MIN(tile.pt1.x + VNC_TILE_SIZE - 1, rect->pt2.x);
+
+          ret = vnc_tile_load(session, colorfmt, &tile, session->tile);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          ret = vnc_hextile_tile(&stream, &state, session->tile,
+                                 tile.pt2.x - tile.pt1.x + 1,
+                                 tile.pt2.y - tile.pt1.y + 1);
+          if (ret < 0)
+            {
+              gerr("ERROR: Send Hextile FrameBufferUpdate failed: %d\n",
+                   ret);
+              return ret;
+            }
+        }
+    }
+
+  ret = vnc_tile_flush(&stream);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  updinfo("Sent {(%d, %d),(%d, %d)}\n",
+          rect->pt1.x, rect->pt1.y, rect->pt2.x, rect->pt2.y);
+  return (int)stream.nsent;
+}
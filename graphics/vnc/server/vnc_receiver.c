@@ -292,19 +292,31 @@ int vnc_receiver(FAR struct vnc_session_s *session)
                 }
               else
                 {
-                  /* Enqueue the update */
+                  /* The client is ready for the next update.  This must
+                   * be noted before queuing below:  The queue may be full
+                   * and only the updater can drain it.
+                   */
 
                   update = (FAR struct rfb_fbupdatereq_s *)session->inbuf;
+                  vnc_client_request(session);
 
-                  rect.pt1.x = rfb_getbe16(update->xpos);
-                  rect.pt1.y = rfb_getbe16(update->ypos);
-                  rect.pt2.x = rect.pt1.x + rfb_getbe16(update->width);
-                  rect.pt2.y = rect.pt1.y + rfb_getbe16(update->height);
+                  /* An incremental request is satisfied by the changes
+                   * that are already queued (or will be).  Otherwise the
+                   * client wants the whole region regardless of changes.
+                   */
 
-                  ret = vnc_update_rectangle(session, &rect, false);
-                  if (ret < 0)
+                  if (update->incremental == 0)
                     {
-                      gerr("ERROR: Failed to queue update: %d\n", ret);
+                      rect.pt1.x = rfb_getbe16(update->xpos);
+                      rect.pt1.y = rfb_getbe16(update->ypos);
+                      rect.pt2.x = rect.pt1.x + rfb_getbe16(update->width);
+                      rect.pt2.y = rect.pt1.y + rfb_getbe16(update->height);
+
+                      ret = vnc_update_rectangle(session, &rect, true);
+                      if (ret < 0)
+                        {
+                          gerr("ERROR: Failed to queue update: %d\n", ret);
+                        }
                     }
                 }
             }
@@ -469,7 +481,9 @@ int vnc_client_encodings(FAR struct vnc_session_s *session,
 
   /* Assume that there are no common encodings (other than RAW) */
 
-  session->rre = false;
+  session->rre     = false;
+  session->hextile = false;
+  session->trle    = false;
 
   /* Loop for each client supported encoding */
 
@@ -486,6 +500,19 @@ int vnc_client_encodings(FAR struct vnc_session_s *session,
         {
           session->rre = true;
         }
+
+      /* Of the tiled encodings, use the one the client prefers (i.e. lists
+       * first).
+       */
+
+      if (encoding == RFB_ENCODING_HEXTILE && !session->trle)
+        {
+          session->hextile = true;
+        }
+      else if (encoding == RFB_ENCODING_TRLE && !session->hextile)
+        {
+          session->trle = true;
+        }
     }
 
   session->change = true;
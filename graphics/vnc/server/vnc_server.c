@@ -133,12 +133,14 @@ static void vnc_reset_session(FAR struct vnc_session_s *session,
 
   nxsem_reset(&session->freesem, CONFIG_VNCSERVER_NUPDATES);
   nxsem_reset(&session->queuesem, 0);
+  nxsem_reset(&session->reqsem, 0);
 
   session->fb      = fb;
   session->display = display;
   session->state   = VNCSERVER_INITIALIZED;
   session->nwhupd  = 0;
   session->change  = true;
+  session->fbreq   = false;
 
   /* Careful not to disturb the keyboard/mouse callouts set by
    * vnc_fbinitialize().  Client related data left in garbage state.
@@ -293,6 +295,7 @@ int vnc_server(int argc, FAR char *argv[])
   g_vnc_sessions[display] = session;
   nxsem_init(&session->freesem, 0, CONFIG_VNCSERVER_NUPDATES);
   nxsem_init(&session->queuesem, 0, 0);
+  nxsem_init(&session->reqsem, 0, 0);
 
   /* Inform any waiter that we have started */
 
@@ -152,6 +152,11 @@
 #define VNCSERVER_UPDATE_BUFSIZE \
   (CONFIG_VNCSERVER_UPDATE_BUFSIZE + SIZEOF_RFB_FRAMEBUFFERUPDATE_S(0))
 
+/* Tile geometry shared by the Hextile and TRLE encodings */
+
+#define VNC_TILE_SIZE       16
+#define VNC_TILE_NPIXELS    (VNC_TILE_SIZE * VNC_TILE_SIZE)
+
 /* Local framebuffer characteristics in bytes */
 
 #define RFB_BYTESPERPIXEL   ((RFB_BITSPERPIXEL + 7) >> 3)
@@ -223,14 +228,18 @@ struct vnc_session_s
   volatile uint8_t state;      /* See enum vnc_server_e */
   volatile uint8_t nwhupd;     /* Number of whole screen updates queued */
   volatile bool change;        /* True: Frambebuffer data change since last whole screen update */
+  volatile bool fbreq;         /* True: Client has an outstanding update request */
 
   /* Display geometry and color characteristics */
 
   uint8_t display;             /* Display number (for debug) */
   volatile uint8_t colorfmt;   /* Remote color format (See include/nuttx/fb.h) */
   volatile uint8_t bpp;        /* Remote bits per pixel */
+  volatile uint8_t depth;      /* Remote color depth */
   volatile bool bigendian;     /* True: Remote expect data in big-endian format */
   volatile bool rre;           /* True: Remote supports RRE encoding */
+  volatile bool hextile;       /* True: Remote supports Hextile encoding */
+  volatile bool trle;          /* True: Remote supports TRLE encoding */
   FAR uint8_t *fb;             /* Allocated local frame buffer */
 
   /* VNC client input support */
@@ -250,11 +259,30 @@ struct vnc_session_s
   sq_queue_t updqueue;
   sem_t freesem;
   sem_t queuesem;
+  sem_t reqsem;                /* Wakes the updater on a client request */
 
   /* I/O buffers for misc network send/receive */
 
   uint8_t inbuf[CONFIG_VNCSERVER_INBUFFER_SIZE];
   uint8_t outbuf[VNCSERVER_UPDATE_BUFSIZE];
+
+  /* Scratch buffers used by the tile encoders (updater thread only) */
+
+  uint32_t tile[VNC_TILE_NPIXELS];
+  uint8_t tileidx[VNC_TILE_NPIXELS];
+};
+
+/* This structure describes one encoded rectangle that is streamed to the
+ * client through the session outbuf.
+ */
+
+struct vnc_tilestream_s
+{
+  FAR struct vnc_session_s *session;
+  size_t nbytes;               /* Number of bytes buffered in outbuf */
+  size_t nsent;                /* Total number of bytes sent */
+  uint8_t pixsize;             /* Size of a (C)PIXEL on the wire */
+  bool bigendian;              /* True: Pixels are sent big-endian */
 };
 
 /* This structure is used to communicate start-up status between the server
@@ -418,6 +446,23 @@ int vnc_start_updater(FAR struct vnc_session_s *session);
 
 int vnc_stop_updater(FAR struct vnc_session_s *session);
 
+/****************************************************************************
+ * Name: vnc_client_request
+ *
+ * Description:
+ *  Note that the client has sent a FramebufferUpdateRequest.  This
+ *  releases the updater to send whatever changes are queued.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void vnc_client_request(FAR struct vnc_session_s *session);
+
 /****************************************************************************
  * Name: vnc_update_rectangle
  *
@@ -478,6 +523,52 @@ int vnc_receiver(FAR struct vnc_session_s *session);
 
 int vnc_rre(FAR struct vnc_session_s *session, FAR struct nxgl_rect_s *rect);
 
+/****************************************************************************
+ * Name: vnc_trle
+ *
+ * Description:
+ *  Send the framebuffer update using the TRLE encoding if the client
+ *  supports it.  Each 16x16 tile is sent as solid, packed palette, plain
+ *  RLE, palette RLE or raw, whichever is the smallest.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect  - Describes the rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   Zero is returned if TRLE coding was not performed (but no error was
+ *   encountered).  Otherwise, the size of the framebuffer update message
+ *   is returned on success or a negated errno value is returned on failure
+ *   that indicates the nature of the failure.  A failure is only
+ *   returned in cases of a network failure and unexpected internal failures.
+ *
+ ****************************************************************************/
+
+int vnc_trle(FAR struct vnc_session_s *session, FAR struct nxgl_rect_s *rect);
+
+/****************************************************************************
+ * Name: vnc_hextile
+ *
+ * Description:
+ *  Send the framebuffer update using the Hextile encoding if the client
+ *  supports it.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect  - Describes the rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   Zero is returned if Hextile coding was not performed (but no error was
+ *   encountered).  Otherwise, the size of the framebuffer update message
+ *   is returned on success or a negated errno value is returned on failure
+ *   that indicates the nature of the failure.  A failure is only
+ *   returned in cases of a network failure and unexpected internal failures.
+ *
+ ****************************************************************************/
+
+int vnc_hextile(FAR struct vnc_session_s *session,
+                FAR struct nxgl_rect_s *rect);
+
 /****************************************************************************
  * Name: vnc_raw
  *
@@ -571,6 +662,73 @@ int vnc_colors(FAR struct vnc_session_s *session,
                FAR struct nxgl_rect_s *rect,
                unsigned int maxcolors, FAR lfb_color_t *colors);
 
+/****************************************************************************
+ * Name: vnc_tile_load
+ *
+ * Description:
+ *  Copy one tile from the local framebuffer into an array of pixels in the
+ *  remote color format.
+ *
+ * Input Parameters:
+ *   session  - An instance of the session structure.
+ *   colorfmt - The remote color format to convert to.
+ *   tile     - The tile region in the local frame buffer.
+ *   pixels   - The location to return the converted pixels, row by row.
+ *
+ * Returned Value:
+ *   The number of pixels in the tile on success; -EINVAL if the color
+ *   format is not supported.
+ *
+ ****************************************************************************/
+
+int vnc_tile_load(FAR struct vnc_session_s *session, uint8_t colorfmt,
+                  FAR const struct nxgl_rect_s *tile,
+                  FAR uint32_t *pixels);
+
+/****************************************************************************
+ * Name: vnc_tile_begin
+ *
+ * Description:
+ *  Start a FramebufferUpdate message containing the single rectangle
+ *  'rect' with the given encoding.  The message header is buffered in the
+ *  session outbuf; the encoded data is appended with vnc_tile_put() and
+ *  vnc_tile_putpixel() and finished with vnc_tile_flush().
+ *
+ * Input Parameters:
+ *   stream   - The stream state to initialize.
+ *   session  - An instance of the session structure.
+ *   rect     - The rectangle in the local framebuffer.
+ *   encoding - The RFB encoding of the rectangle data.
+ *   pixsize  - The size of one pixel on the wire (1-4).
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void vnc_tile_begin(FAR struct vnc_tilestream_s *stream,
+                    FAR struct vnc_session_s *session,
+                    FAR const struct nxgl_rect_s *rect, int32_t encoding,
+                    uint8_t pixsize);
+
+/****************************************************************************
+ * Name: vnc_tile_put, vnc_tile_putpixel and vnc_tile_flush
+ *
+ * Description:
+ *  Append raw bytes or one pixel to the stream, sending the outbuf to the
+ *  client each time it fills.  vnc_tile_flush() sends whatever remains
+ *  buffered.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value if the send failed.
+ *
+ ****************************************************************************/
+
+int vnc_tile_put(FAR struct vnc_tilestream_s *stream,
+                 FAR const uint8_t *data, size_t len);
+int vnc_tile_putpixel(FAR struct vnc_tilestream_s *stream, uint32_t pixel);
+int vnc_tile_flush(FAR struct vnc_tilestream_s *stream);
+
 #undef EXTERN
 #ifdef __cplusplus
 }
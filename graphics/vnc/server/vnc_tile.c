@@ -0,0 +1,327 @@
+/****************************************************************************
+ * graphics/vnc/server/vnc_tile.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#if defined(CONFIG_VNCSERVER_DEBUG) && !defined(CONFIG_DEBUG_GRAPHICS)
+#  undef  CONFIG_DEBUG_ERROR
+#  undef  CONFIG_DEBUG_WARN
+#  undef  CONFIG_DEBUG_INFO
+#  undef  CONFIG_DEBUG_GRAPHICS_ERROR
+#  undef  CONFIG_DEBUG_GRAPHICS_WARN
+#  undef  CONFIG_DEBUG_GRAPHICS_INFO
+#  define CONFIG_DEBUG_ERROR          1
+#  define CONFIG_DEBUG_WARN           1
+#  define CONFIG_DEBUG_INFO           1
+#  define CONFIG_DEBUG_GRAPHICS       1
+#  define CONFIG_DEBUG_GRAPHICS_ERROR 1
+#  define CONFIG_DEBUG_GRAPHICS_WARN  1
+#  define CONFIG_DEBUG_GRAPHICS_INFO  1
+#endif
+#include <debug.h>
+
+#include "vnc_server.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vnc_tile_load
+ *
+ * Description:
+ *  Copy one tile from the local framebuffer into an array of pixels in the
+ *  remote color format.
+ *
+ * Input Parameters:
+ *   session  - An instance of the session structure.
+ *   colorfmt - The remote color format to convert to.
+ *   tile     - The tile region in the local frame buffer.
+ *   pixels   - The location to return the converted pixels, row by row.
+ *
+ * Returned Value:
+ *   The number of pixels in the tile on success; -EINVAL if the color
+ *   format is not supported.
+ *
+ ****************************************************************************/
+
+int vnc_tile_load(FAR struct vnc_session_s *session, uint8_t colorfmt,
+                  FAR const struct nxgl_rect_s *tile,
+                  FAR uint32_t *pixels)
+{
+  FAR const lfb_color_t *srcleft;
+  FAR const lfb_color_t *src;
+  FAR uint32_t *dest;
+  nxgl_coord_t width;
+  nxgl_coord_t height;
+  nxgl_coord_t x;
+  nxgl_coord_t y;
+
+  width  = tile->pt2.x - tile->pt1.x + 1;
+  height = tile->pt2.y - tile->pt1.y + 1;
+  DEBUGASSERT(width * height <= VNC_TILE_NPIXELS);
+
+  srcleft = (FAR const lfb_color_t *)
+    (session->fb + RFB_STRIDE * tile->pt1.y +
+     RFB_BYTESPERPIXEL * tile->pt1.x);
+  dest    = pixels;
+
+  /* Select the conversion once per tile, not once per pixel */
+
+  for (y = 0; y < height; y++)
+    {
+      src = srcleft;
+
+      switch (colorfmt)
+        {
+          case FB_FMT_RGB8_222:
+            for (x = 0; x < width; x++)
+              {
+                *dest++ = vnc_convert_rgb8_222(*src++);
+              }
+            break;
+
+          case FB_FMT_RGB8_332:
+            for (x = 0; x < width; x++)
+              {
+                *dest++ = vnc_convert_rgb8_332(*src++);
+              }
+            break;
+
+          case FB_FMT_RGB16_555:
+            for (x = 0; x < width; x++)
+              {
+                *dest++ = vnc_convert_rgb16_555(*src++);
+              }
+            break;
+
+          case FB_FMT_RGB16_565:
+            for (x = 0; x < width; x++)
+              {
+                *dest++ = vnc_convert_rgb16_565(*src++);
+              }
+            break;
+
+          case FB_FMT_RGB32:
+            for (x = 0; x < width; x++)
+              {
+                *dest++ = vnc_convert_rgb32_888(*src++);
+              }
+            break;
+
+          default:
+            gerr("ERROR: Unrecognized color format: %d\n", colorfmt);
+            return -EINVAL;
+        }
+
+      srcleft = (FAR const lfb_color_t *)((uintptr_t)srcleft + RFB_STRIDE);
+    }
+
+  return width * height;
+}
+
+/****************************************************************************
+ * Name: vnc_tile_begin
+ *
+ * Description:
+ *  Start a FramebufferUpdate message containing the single rectangle
+ *  'rect' with the given encoding.  The message header is buffered in the
+ *  session outbuf; the encoded data is appended with vnc_tile_put() and
+ *  vnc_tile_putpixel() and finished with vnc_tile_flush().
+ *
+ * Input Parameters:
+ *   stream   - The stream state to initialize.
+ *   session  - An instance of the session structure.
+ *   rect     - The rectangle in the local framebuffer.
+ *   encoding - The RFB encoding of the rectangle data.
+ *   pixsize  - The size of one pixel on the wire (1-4).
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void vnc_tile_begin(FAR struct vnc_tilestream_s *stream,
+                    FAR struct vnc_session_s *session,
+                    FAR const struct nxgl_rect_s *rect, int32_t encoding,
+                    uint8_t pixsize)
+{
+  FAR struct rfb_framebufferupdate_s *update;
+
+  DEBUGASSERT(pixsize >= 1 && pixsize <= 4);
+
+  update          = (FAR struct rfb_framebufferupdate_s *)session->outbuf;
+  update->msgtype = RFB_FBUPDATE_MSG;
+  update->padding = 0;
+  rfb_putbe16(update->nrect, 1);
+
+  rfb_putbe16(update->rect[0].xpos, rect->pt1.x);
+  rfb_putbe16(update->rect[0].ypos, rect->pt1.y);
+  rfb_putbe16(update->rect[0].width, rect->pt2.x - rect->pt1.x + 1);
+  rfb_putbe16(update->rect[0].height, rect->pt2.y - rect->pt1.y + 1);
+  rfb_putbe32(update->rect[0].encoding, (uint32_t)encoding);
+
+  stream->session   = session;
+  stream->nbytes    = SIZEOF_RFB_FRAMEBUFFERUPDATE_S(SIZEOF_RFB_RECTANGE_S(0));
+  stream->nsent     = 0;
+  stream->pixsize   = pixsize;
+  stream->bigendian = session->bigendian;
+}
+
+/****************************************************************************
+ * Name: vnc_tile_flush
+ *
+ * Description:
+ *  Send all of the bytes buffered in the session outbuf.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value if the send failed.
+ *
+ ****************************************************************************/
+
+int vnc_tile_flush(FAR struct vnc_tilestream_s *stream)
+{
+  FAR struct vnc_session_s *session = stream->session;
+  FAR const uint8_t *src = session->outbuf;
+  size_t size = stream->nbytes;
+  ssize_t nsent;
+
+  /* Send until all of the bytes are out.  This may loop for the case where
+   * TCP write buffering is enabled and there are a limited number of IOBs
+   * available.
+   */
+
+  while (size > 0)
+    {
+      nsent = psock_send(&session->connect, src, size, 0);
+      if (nsent < 0)
+        {
+          gerr("ERROR: Send FrameBufferUpdate failed: %d\n", (int)nsent);
+          return (int)nsent;
+        }
+
+      DEBUGASSERT(nsent <= size);
+      src           += nsent;
+      size          -= nsent;
+      stream->nsent += nsent;
+    }
+
+  stream->nbytes = 0;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: vnc_tile_put
+ *
+ * Description:
+ *  Append raw bytes to the stream, sending the outbuf each time it fills.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value if the send failed.
+ *
+ ****************************************************************************/
+
+int vnc_tile_put(FAR struct vnc_tilestream_s *stream,
+                 FAR const uint8_t *data, size_t len)
+{
+  size_t ncopy;
+  int ret;
+
+  while (len > 0)
+    {
+      if (stream->nbytes >= VNCSERVER_UPDATE_BUFSIZE)
+        {
+          ret = vnc_tile_flush(stream);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+
+      ncopy = MIN(len, VNCSERVER_UPDATE_BUFSIZE - stream->nbytes);
+      memcpy(&stream->session->outbuf[stream->nbytes], data, ncopy);
+
+      stream->nbytes += ncopy;
+      data           += ncopy;
+      len            -= ncopy;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: vnc_tile_putpixel
+ *
+ * Description:
+ *  Append one pixel to the stream.  Only the 'pixsize' least significant
+ *  bytes of the pixel are sent, in the byte order requested by the client.
+ *  With a pixsize of 3 this is the compressed CPIXEL of the TRLE encoding.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value if the send failed.
+ *
+ ****************************************************************************/
+
+int vnc_tile_putpixel(FAR struct vnc_tilestream_s *stream, uint32_t pixel)
+{
+  FAR uint8_t *dest;
+  int ret;
+  int i;
+
+  if (stream->nbytes + stream->pixsize > VNCSERVER_UPDATE_BUFSIZE)
+    {
+      ret = vnc_tile_flush(stream);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  dest = &stream->session->outbuf[stream->nbytes];
+  stream->nbytes += stream->pixsize;
+
+  if (stream->bigendian)
+    {
+      for (i = stream->pixsize - 1; i >= 0; i--)
+        {
+          dest[i] = (uint8_t)pixel;
+          pixel >>= 8;
+        }
+    }
+  else
+    {
+      for (i = 0; i < stream->pixsize; i++)
+        {
+          dest[i] = (uint8_t)pixel;
+          pixel >>= 8;
+        }
+    }
+
+  return OK;
+}
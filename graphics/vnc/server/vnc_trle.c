@@ -0,0 +1,465 @@
+/****************************************************************************
+ * graphics/vnc/server/vnc_trle.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <assert.h>
+#include <errno.h>
+
+#if defined(CONFIG_VNCSERVER_DEBUG) && !defined(CONFIG_DEBUG_GRAPHICS)
+#  undef  CONFIG_DEBUG_ERROR
+#  undef  CONFIG_DEBUG_WARN
+#  undef  CONFIG_DEBUG_INFO
+#  undef  CONFIG_DEBUG_GRAPHICS_ERROR
+#  undef  CONFIG_DEBUG_GRAPHICS_WARN
+#  undef  CONFIG_DEBUG_GRAPHICS_INFO
+#  define CONFIG_DEBUG_ERROR          1
+#  define CONFIG_DEBUG_WARN           1
+#  define CONFIG_DEBUG_INFO           1
+#  define CONFIG_DEBUG_GRAPHICS       1
+#  define CONFIG_DEBUG_GRAPHICS_ERROR 1
+#  define CONFIG_DEBUG_GRAPHICS_WARN  1
+#  define CONFIG_DEBUG_GRAPHICS_INFO  1
+#endif
+#include <debug.h>
+
+#include "vnc_server.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Largest palette used for the packed palette and palette RLE tiles.  The
+ * protocol allows up to 127 entries for palette RLE, but the packed
+ * formats stop at 16 and larger palettes rarely pay off on 16x16 tiles.
+ */
+
+#define TRLE_MAX_PALETTE     16
+
+/* Number of bytes needed to send a run length */
+
+#define TRLE_RUNBYTES(n)     ((((n) - 1) / 255) + 1)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* Statistics of one tile used to select the smallest subencoding */
+
+struct trle_tile_s
+{
+  FAR const uint32_t *pixels;   /* Tile pixels in the remote color format */
+  FAR uint8_t *index;           /* Palette index of each pixel */
+  nxgl_coord_t width;           /* Tile width */
+  nxgl_coord_t height;          /* Tile height */
+  unsigned int npalette;        /* Palette size, 0 if too many colors */
+  unsigned int nruns;           /* Number of runs of identical pixels */
+  unsigned int nsingles;        /* Number of runs of length one */
+  unsigned int runbytes;        /* Bytes needed for all run lengths */
+  uint32_t palette[TRLE_MAX_PALETTE];
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vnc_trle_analyze
+ *
+ * Description:
+ *  Build the palette of a tile and count its runs.
+ *
+ ****************************************************************************/
+
+static void vnc_trle_analyze(FAR struct trle_tile_s *tile)
+{
+  unsigned int npixels = tile->width * tile->height;
+  unsigned int runlen = 0;
+  unsigned int i;
+  unsigned int j;
+  uint32_t pixel;
+
+  tile->npalette = 0;
+  tile->nruns    = 0;
+  tile->nsingles = 0;
+  tile->runbytes = 0;
+
+  for (i = 0; i < npixels; i++)
+    {
+      pixel = tile->pixels[i];
+
+      /* Runs may continue from the end of one row into the next */
+
+      if (i > 0 && pixel == tile->pixels[i - 1])
+        {
+          runlen++;
+          tile->index[i] = tile->index[i - 1];
+          continue;
+        }
+
+      if (runlen > 0)
+        {
+          tile->nruns++;
+          tile->nsingles += (runlen == 1);
+          tile->runbytes += TRLE_RUNBYTES(runlen);
+        }
+
+      runlen = 1;
+
+      /* Look the color up in the palette, adding it if there is room */
+
+      if (i == 0 || tile->npalette > 0)
+        {
+          for (j = 0; j < tile->npalette && tile->palette[j] != pixel; j++)
+            {
+            }
+
+          if (j == tile->npalette)
+            {
+              if (j < TRLE_MAX_PALETTE)
+                {
+                  tile->palette[j] = pixel;
+                  tile->npalette++;
+                }
+              else
+                {
+                  /* Too many colors; no palette can be used */
+
+                  tile->npalette = 0;
+                }
+            }
+
+          tile->index[i] = (uint8_t)j;
+        }
+    }
+
+  tile->nruns++;
+  tile->nsingles += (runlen == 1);
+  tile->runbytes += TRLE_RUNBYTES(runlen);
+}
+
+/****************************************************************************
+ * Name: vnc_trle_putrun
+ *
+ * Description:
+ *  Send a run length: one more than the sum of the bytes, where any byte
+ *  other than 255 is the last one.
+ *
+ ****************************************************************************/
+
+static int vnc_trle_putrun(FAR struct vnc_tilestream_s *stream,
+                           unsigned int runlen)
+{
+  uint8_t value = 255;
+  int ret;
+
+  for (runlen--; runlen >= 255; runlen -= 255)
+    {
+      ret = vnc_tile_put(stream, &value, 1);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  value = (uint8_t)runlen;
+  return vnc_tile_put(stream, &value, 1);
+}
+
+/****************************************************************************
+ * Name: vnc_trle_tile
+ *
+ * Description:
+ *  Encode and send one tile using the smallest of the solid, packed
+ *  palette, plain RLE, palette RLE and raw subencodings.
+ *
+ * Input Parameters:
+ *   stream - The output stream.
+ *   tile   - The tile pixels and scratch space.
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value if the send failed.
+ *
+ ****************************************************************************/
+
+static int vnc_trle_tile(FAR struct vnc_tilestream_s *stream,
+                         FAR struct trle_tile_s *tile)
+{
+  unsigned int npixels = tile->width * tile->height;
+  unsigned int cpsize = stream->pixsize;
+  unsigned int npalette;
+  unsigned int bits = 0;
+  unsigned int best;
+  unsigned int size;
+  unsigned int runlen;
+  unsigned int i;
+  nxgl_coord_t x;
+  nxgl_coord_t y;
+  uint8_t encoding;
+  uint8_t value;
+  int ret;
+
+  vnc_trle_analyze(tile);
+  npalette = tile->npalette;
+
+  /* Single color tiles are always solid */
+
+  if (npalette == 1)
+    {
+      encoding = RFB_SUBENCODING_SOLID;
+      ret = vnc_tile_put(stream, &encoding, 1);
+      return ret < 0 ? ret : vnc_tile_putpixel(stream, tile->palette[0]);
+    }
+
+  /* Otherwise pick the smallest of the remaining subencodings */
+
+  encoding = RFB_SUBENCODING_RAW;
+  best     = npixels * cpsize;
+
+  size = tile->nruns * cpsize + tile->runbytes;
+  if (size < best)
+    {
+      encoding = RFB_SUBENCODING_RLE;
+      best     = size;
+    }
+
+  if (npalette > 1)
+    {
+      bits = npalette <= 2 ? 1 : npalette <= 4 ? 2 : 4;
+
+      size = npalette * cpsize +
+             tile->height * ((tile->width * bits + 7) >> 3);
+      if (size < best)
+        {
+          encoding = (uint8_t)npalette;
+          best     = size;
+        }
+
+      size = npalette * cpsize + tile->nruns +
+             tile->runbytes - tile->nsingles;
+      if (size < best)
+        {
+          encoding = (uint8_t)(RFB_SUBENCODING_RLE + npalette);
+          best     = size;
+        }
+    }
+
+  ret = vnc_tile_put(stream, &encoding, 1);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  if (encoding == RFB_SUBENCODING_RAW)
+    {
+      for (i = 0; ret >= 0 && i < npixels; i++)
+        {
+          ret = vnc_tile_putpixel(stream, tile->pixels[i]);
+        }
+
+      return ret;
+    }
+
+  /* The palette based subencodings start with the palette */
+
+  if (encoding != RFB_SUBENCODING_RLE)
+    {
+      for (i = 0; ret >= 0 && i < npalette; i++)
+        {
+          ret = vnc_tile_putpixel(stream, tile->palette[i]);
+        }
+    }
+
+  if (encoding <= TRLE_MAX_PALETTE)
+    {
+      /* Packed palette:  Indices packed MSB first, each row padded to a
+       * whole byte.
+       */
+
+      for (y = 0; ret >= 0 && y < tile->height; y++)
+        {
+          FAR const uint8_t *index = &tile->index[y * tile->width];
+          unsigned int nbits = 0;
+
+          value = 0;
+          for (x = 0; ret >= 0 && x < tile->width; x++)
+            {
+              value  = (uint8_t)((value << bits) | index[x]);
+              nbits += bits;
+
+              if (nbits == 8)
+                {
+                  ret   = vnc_tile_put(stream, &value, 1);
+                  value = 0;
+                  nbits = 0;
+                }
+            }
+
+          if (ret >= 0 && nbits > 0)
+            {
+              value <<= 8 - nbits;
+              ret = vnc_tile_put(stream, &value, 1);
+            }
+        }
+
+      return ret;
+    }
+
+  /* Plain or palette RLE:  Walk the runs again and send them */
+
+  for (i = 0; ret >= 0 && i < npixels; i += runlen)
+    {
+      for (runlen = 1;
+           i + runlen < npixels &&
+           tile->pixels[i + runlen] == tile->pixels[i];
+           runlen++)
+        {
+        }
+
+      if (encoding == RFB_SUBENCODING_RLE)
+        {
+          ret = vnc_tile_putpixel(stream, tile->pixels[i]);
+          if (ret >= 0)
+            {
+              ret = vnc_trle_putrun(stream, runlen);
+            }
+        }
+      else if (runlen == 1)
+        {
+          ret = vnc_tile_put(stream, &tile->index[i], 1);
+        }
+      else
+        {
+          value = tile->index[i] | 0x80;
+          ret = vnc_tile_put(stream, &value, 1);
+          if (ret >= 0)
+            {
+              ret = vnc_trle_putrun(stream, runlen);
+            }
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: vnc_trle
+ *
+ * Description:
+ *  Send the framebuffer update using the TRLE encoding if the client
+ *  supports it.  Each 16x16 tile is sent as solid, packed palette, plain
+ *  RLE, palette RLE or raw, whichever is the smallest.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *   rect  - Describes the rectangle in the local framebuffer.
+ *
+ * Returned Value:
+ *   Zero is returned if TRLE coding was not performed (but no error was
+ *   encountered).  Otherwise, the size of the framebuffer update message
+ *   is returned on success or a negated errno value is returned on failure
+ *   that indicates the nature of the failure.  A failure is only
+ *   returned in cases of a network failure and unexpected internal failures.
+ *
+ ****************************************************************************/
+
+int vnc_trle(FAR struct vnc_session_s *session, FAR struct nxgl_rect_s *rect)
+{
+  struct vnc_tilestream_s stream;
+  struct trle_tile_s tile;
+  struct nxgl_rect_s region;
+  uint8_t colorfmt;
+  uint8_t pixsize;
+  int ret;
+
+  /* Check if the client supports the TRLE encoding */
+
+  if (!session->trle)
+    {
+      return 0;
+    }
+
+  /* Snapshot the client pixel format.  Pixels are sent as CPIXELs:  32-bit
+   * pixels with a depth of 24 or less are sent as their three least
+   * significant bytes.
+   */
+
+  colorfmt = session->colorfmt;
+  pixsize  = (session->bpp + 7) >> 3;
+
+  if (pixsize == 4 && session->depth <= 24)
+    {
+      pixsize = 3;
+    }
+
+  vnc_tile_begin(&stream, session, rect, RFB_ENCODING_TRLE, pixsize);
+
+  tile.pixels = session->tile;
+  tile.index  = session->tileidx;
+
+  /* Send each 16x16 tile, left-to-right and top-to-bottom */
+
+  for (region.pt1.y = rect->pt1.y; region.pt1.y <= rect->pt2.y;
+       region.pt1.y += VNC_TILE_SIZE)
+    {
+      region.pt2.y = MIN(region.pt1.y + VNC_TILE_SIZE - 1, rect->pt2.y);
+
+      for (region.pt1.x = rect->pt1.x; region.pt1.x <= rect->pt2.x;
+           region.pt1.x += VNC_TILE_SIZE)
+        {
+          region.pt2.x = MIN(region.pt1.x + VNC_TILE_SIZE - 1, rect->pt2.x);
+
+          ret = vnc_tile_load(session, colorfmt, &region, session->tile);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          tile.width  = region.pt2.x - region.pt1.x + 1;
+          tile.height = region.pt2.y - region.pt1.y + 1;
+
+          ret = vnc_trle_tile(&stream, &tile);
+          if (ret < 0)
+            {
+              gerr("ERROR: Send TRLE FrameBufferUpdate failed: %d\n", ret);
+              return ret;
+            }
+        }
+    }
+
+  ret = vnc_tile_flush(&stream);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  updinfo("Sent {(%d, %d),(%d, %d)}\n",
+          rect->pt1.x, rect->pt1.y, rect->pt2.x, rect->pt2.y);
+  return (int)stream.nsent;
+}
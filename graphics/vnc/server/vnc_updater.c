@@ -336,6 +336,155 @@ static void vnc_add_queue(FAR struct vnc_session_s *session,
   sched_unlock();
 }
 
+/****************************************************************************
+ * Name: vnc_rect_area
+ *
+ * Description:
+ *   Return the number of pixels in a rectangle.
+ *
+ ****************************************************************************/
+
+static uint32_t vnc_rect_area(FAR const struct nxgl_rect_s *rect)
+{
+  return (uint32_t)(rect->pt2.x - rect->pt1.x + 1) *
+         (uint32_t)(rect->pt2.y - rect->pt1.y + 1);
+}
+
+/****************************************************************************
+ * Name: vnc_merge_candidate
+ *
+ * Description:
+ *   Check if two rectangles should be sent as their bounding box.  That is
+ *   the case if the bounding box does not cover more pixels than the two
+ *   rectangles together, i.e. if they overlap or are adjacent and aligned.
+ *
+ ****************************************************************************/
+
+static bool vnc_merge_candidate(FAR const struct nxgl_rect_s *rect1,
+                                FAR const struct nxgl_rect_s *rect2,
+                                FAR struct nxgl_rect_s *merged)
+{
+  nxgl_rectunion(merged, rect1, rect2);
+  return vnc_rect_area(merged) <=
+         vnc_rect_area(rect1) + vnc_rect_area(rect2);
+}
+
+/****************************************************************************
+ * Name: vnc_merge_queue
+ *
+ * Description:
+ *   Try to merge a new rectangle into one that is already queued.  If that
+ *   succeeds, the grown rectangle may now also absorb other queued
+ *   rectangles; those are removed from the queue and freed.
+ *
+ *   The caller must hold the scheduler lock so that the queue and the
+ *   queuesem count remain consistent.
+ *
+ * Input Parameters:
+ *   session - A reference to the VNC session structure.
+ *   rect    - The new rectangle to be updated.
+ *
+ * Returned Value:
+ *   True if the rectangle was merged into the queue.
+ *
+ ****************************************************************************/
+
+static bool vnc_merge_queue(FAR struct vnc_session_s *session,
+                            FAR const struct nxgl_rect_s *rect)
+{
+  FAR struct vnc_fbupdate_s *target;
+  FAR struct vnc_fbupdate_s *curr;
+  FAR struct vnc_fbupdate_s *next;
+  struct nxgl_rect_s merged;
+  bool again;
+
+  for (target = (FAR struct vnc_fbupdate_s *)session->updqueue.head;
+       target != NULL;
+       target = target->flink)
+    {
+      if (vnc_merge_candidate(&target->rect, rect, &merged))
+        {
+          break;
+        }
+    }
+
+  if (target == NULL)
+    {
+      return false;
+    }
+
+  nxgl_rectcopy(&target->rect, &merged);
+
+  updinfo("Merged into {(%d, %d),(%d, %d)}\n",
+          merged.pt1.x, merged.pt1.y, merged.pt2.x, merged.pt2.y);
+
+  /* Absorb any other queued rectangles that the grown one now covers */
+
+  do
+    {
+      again = false;
+
+      for (curr = (FAR struct vnc_fbupdate_s *)session->updqueue.head;
+           curr != NULL;
+           curr = next)
+        {
+          next = curr->flink;
+
+          if (curr != target &&
+              vnc_merge_candidate(&target->rect, &curr->rect, &merged))
+            {
+              nxgl_rectcopy(&target->rect, &merged);
+
+              /* Remove it from the queue, consuming its queuesem count */
+
+              sq_rem((FAR sq_entry_t *)curr, &session->updqueue);
+              DEBUGVERIFY(nxsem_trywait(&session->queuesem));
+              vnc_free_update(session, curr);
+
+              again = true;
+            }
+        }
+    }
+  while (again);
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: vnc_wait_request
+ *
+ * Description:
+ *   Wait until the client has an outstanding FramebufferUpdateRequest.
+ *   Updates are only sent in response to requests so that a slow client
+ *   is not flooded; changes accumulate (and are merged) in the queue in
+ *   the meantime.  The request is consumed when the last queued update is
+ *   taken, before it is sent, so that a new request that arrives while
+ *   sending is not lost.
+ *
+ * Input Parameters:
+ *   session - A reference to the VNC session structure.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void vnc_wait_request(FAR struct vnc_session_s *session)
+{
+  sched_lock();
+  while (!session->fbreq && session->state == VNCSERVER_RUNNING)
+    {
+      nxsem_wait_uninterruptible(&session->reqsem);
+    }
+
+  if (sq_empty(&session->updqueue))
+    {
+      session->fbreq = false;
+    }
+
+  sched_unlock();
+}
+
 /****************************************************************************
  * Name: vnc_updater
  *
@@ -379,9 +528,30 @@ static FAR void *vnc_updater(FAR void *arg)
               srcrect->rect.pt1.x, srcrect->rect.pt1.y,
               srcrect->rect.pt2.x, srcrect->rect.pt2.y);
 
-      /* Attempt to use RRE encoding */
+      /* Hold the update until the client asks for one */
+
+      vnc_wait_request(session);
+      if (session->state != VNCSERVER_RUNNING)
+        {
+          vnc_free_update(session, srcrect);
+          break;
+        }
+
+      /* Attempt to use RRE encoding for single color regions, then the
+       * tiled encodings, in order of preference.
+       */
 
       ret = vnc_rre(session, &srcrect->rect);
+      if (ret == 0)
+        {
+          ret = vnc_trle(session, &srcrect->rect);
+        }
+
+      if (ret == 0)
+        {
+          ret = vnc_hextile(session, &srcrect->rect);
+        }
+
       if (ret == 0)
         {
           /* Perform the framebuffer update using the default RAW encoding */
@@ -482,6 +652,10 @@ int vnc_stop_updater(FAR struct vnc_session_s *session)
 
       session->state = VNCSERVER_STOPPING;
 
+      /* Wake the updater if it is waiting for a client request */
+
+      nxsem_post(&session->reqsem);
+
       /* Wait for the thread to comply with our request */
 
       status = pthread_join(session->updater, &result);
@@ -500,6 +674,33 @@ int vnc_stop_updater(FAR struct vnc_session_s *session)
   return OK;
 }
 
+/****************************************************************************
+ * Name: vnc_client_request
+ *
+ * Description:
+ *  Note that the client has sent a FramebufferUpdateRequest.  This
+ *  releases the updater to send whatever changes are queued.
+ *
+ * Input Parameters:
+ *   session - An instance of the session structure.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void vnc_client_request(FAR struct vnc_session_s *session)
+{
+  sched_lock();
+  if (!session->fbreq)
+    {
+      session->fbreq = true;
+      nxsem_post(&session->reqsem);
+    }
+
+  sched_unlock();
+}
+
 /****************************************************************************
  * Name: vnc_update_rectangle
  *
@@ -593,6 +794,16 @@ int vnc_update_rectangle(FAR struct vnc_session_s *session,
                */
 
               session->change |= change;
+
+              /* Merge it into a queued update if that costs no extra
+               * pixels.
+               */
+
+              if (vnc_merge_queue(session, &intersection))
+                {
+                  sched_unlock();
+                  return OK;
+                }
             }
 
           /* Allocate an update structure... waiting if necessary */
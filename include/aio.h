@@ -60,22 +60,12 @@
 #  undef CONFIG_FS_AIO
 #endif
 
-/* Work queue support is required.  The low-priority work queue is required
- * so that the asynchronous I/O does not interfere with high priority driver
- * operations.  If this pre-requisite is met, then asynchronous I/O support
- * can be enabled with CONFIG_FS_AIO
+/* Asynchronous I/O is performed by a pool of dedicated kernel threads
+ * (see CONFIG_FS_AIO_NWORKERS) and has no other pre-requisites.
  */
 
 #ifdef CONFIG_FS_AIO
 
-#ifndef CONFIG_SCHED_WORKQUEUE
-#  error Asynchronous I/O requires CONFIG_SCHED_WORKQUEUE
-#endif
-
-#ifndef CONFIG_SCHED_LPWORK
-#  error Asynchronous I/O requires CONFIG_SCHED_LPWORK
-#endif
-
 /* Standard Definitions *****************************************************/
 
 /* aio_cancel return values
@@ -101,6 +101,15 @@ int     mq_setattr(mqd_t mqdes, FAR const struct mq_attr *mq_stat,
                    FAR struct mq_attr *oldstat);
 int     mq_getattr(mqd_t mqdes, FAR struct mq_attr *mq_stat);
 
+#ifdef CONFIG_MQ_ZEROCOPY
+/* Non-standard zero-copy interfaces */
+
+int     mq_sendbuffer(mqd_t mqdes, FAR void *buffer, size_t buflen,
+                      unsigned int prio);
+ssize_t mq_receivebuffer(mqd_t mqdes, FAR void **buffer,
+                         FAR unsigned int *prio);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -1761,6 +1761,30 @@ int16_t up_fetchsub16(FAR volatile int16_t *addr, int16_t value);
 int8_t up_fetchsub8(FAR volatile int8_t *addr, int8_t value);
 #endif
 
+/****************************************************************************
+ * Name: up_cmpxchg16
+ *
+ * Description:
+ *   Perform an atomic compare and exchange operation on the provided 16-bit
+ *   value:  newval is stored at addr only if addr still holds oldval.
+ *
+ *   This function must be provided via the architecture-specific logic.
+ *
+ * Input Parameters:
+ *   addr   - The address of the value to be exchanged.
+ *   oldval - The value that is expected at addr
+ *   newval - The value to store at addr
+ *
+ * Returned Value:
+ *   true if newval was stored; false if addr did not hold oldval.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ARCH_HAVE_FETCHADD
+bool up_cmpxchg16(FAR volatile int16_t *addr, int16_t oldval,
+                  int16_t newval);
+#endif
+
 /****************************************************************************
  * Name: up_cpu_index
  *
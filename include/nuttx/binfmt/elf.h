@@ -111,10 +111,18 @@ struct elf_loadinfo_s
   size_t            textsize;    /* Size of the ELF .text memory allocation */
   size_t            datasize;    /* Size of the ELF .bss/.data memory allocation */
   off_t             filelen;     /* Length of the entire ELF file */
+#ifdef CONFIG_ELF_XIP
+  uintptr_t         xipbase;     /* Address of the ELF file in XIP media (or 0) */
+  uintptr_t         textbase;    /* Run-time address of the first .text section */
+#endif
 
   Elf_Ehdr          ehdr;        /* Buffered ELF file header */
   FAR Elf_Shdr      *shdr;       /* Buffered ELF section headers */
   uint8_t           *iobuffer;   /* File I/O buffer */
+#ifdef CONFIG_ELF_LOADSYMTAB
+  FAR Elf_Sym       *symtab;     /* Buffered symbol table (may be NULL) */
+  FAR char          *strtab;     /* Buffered symbol string table (may be NULL) */
+#endif
 
   /* Constructors and destructors */
 
@@ -436,6 +436,48 @@ int clock_systime_timespec(FAR struct timespec *ts);
 int clock_cpuload(int pid, FAR struct cpuload_s *cpuload);
 #endif
 
+/****************************************************************************
+ * Name:  clock_cpuload_runtime
+ *
+ * Description:
+ *   Return the total time that the selected thread has executed since it
+ *   was started.  Time spent in interrupt handlers is not included.
+ *
+ * Input Parameters:
+ *   pid - The task ID of the thread of interest. pid == 0 is IDLE thread.
+ *   runtime - The location to return the execution time
+ *
+ * Returned Value:
+ *   OK (0) on success; a negated errno value on failure.  The only reason
+ *   that this function can fail is if 'pid' no longer refers to a valid
+ *   thread.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
+int clock_cpuload_runtime(int pid, FAR struct timespec *runtime);
+#endif
+
+/****************************************************************************
+ * Name:  clock_cpuload_irqtime
+ *
+ * Description:
+ *   Return the total time that the selected CPU has spent in interrupt
+ *   handlers.
+ *
+ * Input Parameters:
+ *   cpu - The index of the CPU of interest.
+ *   irqtime - The location to return the interrupt handling time
+ *
+ * Returned Value:
+ *   OK (0) on success; -EINVAL if 'cpu' is not a valid CPU index.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
+int clock_cpuload_irqtime(int cpu, FAR struct timespec *irqtime);
+#endif
+
 /****************************************************************************
  * Name:  nxsched_oneshot_extclk
  *
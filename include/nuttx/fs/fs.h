@@ -412,12 +412,22 @@ struct file
   void             *f_priv;     /* Per file driver private data */
 };
 
-/* This defines a list of files indexed by the file descriptor */
+/* This defines a list of files indexed by the file descriptor.  The files
+ * are held in rows of CONFIG_NFILE_DESCRIPTORS_PER_BLOCK entries that are
+ * allocated when first needed and are never moved, so a struct file
+ * pointer stays valid for as long as the file list exists.  fl_used has
+ * one bit set for each descriptor in the row that is reserved or open.
+ */
+
+#define NFILE_ROWS \
+  ((CONFIG_NFILE_DESCRIPTORS + CONFIG_NFILE_DESCRIPTORS_PER_BLOCK - 1) / \
+   CONFIG_NFILE_DESCRIPTORS_PER_BLOCK)
 
 struct filelist
 {
   sem_t   fl_sem;               /* Manage access to the file list */
-  struct file fl_files[CONFIG_NFILE_DESCRIPTORS];
+  uint32_t fl_used[NFILE_ROWS]; /* Reserved descriptors in each row */
+  FAR struct file *fl_files[NFILE_ROWS];
 };
 
 /* The following structure defines the list of files used for standard C I/O.
@@ -744,6 +754,46 @@ void files_initlist(FAR struct filelist *list);
 
 void files_releaselist(FAR struct filelist *list);
 
+/****************************************************************************
+ * Name: files_fget
+ *
+ * Description:
+ *   Return the file structure of descriptor 'fd' in the list or NULL if
+ *   the descriptor was never allocated.  The file structure may or may
+ *   not be open.
+ *
+ ****************************************************************************/
+
+FAR struct file *files_fget(FAR struct filelist *list, int fd);
+
+/****************************************************************************
+ * Name: files_reserve
+ *
+ * Description:
+ *   Reserve the specific descriptor 'fd' in the list, allocating storage
+ *   for it if necessary, and return its file structure.  The descriptor
+ *   may already be open.  This is the first step of dup2().
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+int files_reserve(FAR struct filelist *list, int fd,
+                  FAR struct file **filep);
+
+/****************************************************************************
+ * Name: files_unreserve
+ *
+ * Description:
+ *   Return a descriptor that was reserved but that is not open to the list
+ *   of free descriptors.
+ *
+ ****************************************************************************/
+
+void files_unreserve(FAR struct filelist *list, int fd);
+
 /****************************************************************************
  * Name: file_dup
  *
@@ -215,6 +215,10 @@ struct mod_loadinfo_s
   Elf_Ehdr          ehdr;        /* Buffered module file header */
   FAR Elf_Shdr     *shdr;        /* Buffered module section headers */
   uint8_t          *iobuffer;    /* File I/O buffer */
+#ifdef CONFIG_MODLIB_LOADSYMTAB
+  FAR Elf_Sym      *symtab;      /* Buffered symbol table (may be NULL) */
+  FAR char         *strtab;      /* Buffered symbol string table (may be NULL) */
+#endif
 
   uint16_t          symtabidx;   /* Symbol table section index */
   uint16_t          strtabidx;   /* String table section index */
@@ -48,6 +48,7 @@
 #include <sys/types.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <limits.h>
 #include <mqueue.h>
 #include <queue.h>
 
@@ -117,6 +118,10 @@ struct mqueue_inode_s
   pid_t ntpid;                /* Notification: Receiving Task's PID */
   struct sigevent ntevent;    /* Notification description */
   struct sigwork_s ntwork;    /* Notification work */
+#ifdef CONFIG_MQ_PRIOINDEX
+  FAR struct mqueue_msg_s *priotail[MQ_PRIO_MAX + 1]; /* Last msg per prio */
+  uint32_t priomap[(MQ_PRIO_MAX + 32) / 32]; /* Priorities in msglist */
+#endif
 };
 
 /* This describes the message queue descriptor that is held in the
@@ -382,6 +387,43 @@ ssize_t nxmq_timedreceive(mqd_t mqdes, FAR char *msg, size_t msglen,
                           FAR unsigned int *prio,
                           FAR const struct timespec *abstime);
 
+#ifdef CONFIG_MQ_ZEROCOPY
+/****************************************************************************
+ * Name: nxmq_sendbuffer
+ *
+ * Description:
+ *   This is the internal OS version of mq_sendbuffer().  It queues the
+ *   buffer itself rather than a copy of its content.  On success, the
+ *   ownership of the buffer passes to the message queue.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success.  A negated errno value is returned on
+ *   failure.  (see mq_sendbuffer() for the list of valid return values).
+ *
+ ****************************************************************************/
+
+int nxmq_sendbuffer(mqd_t mqdes, FAR void *buffer, size_t buflen,
+                    unsigned int prio);
+
+/****************************************************************************
+ * Name: nxmq_receivebuffer
+ *
+ * Description:
+ *   This is the internal OS version of mq_receivebuffer().  It removes the
+ *   oldest of the highest priority messages from the queue and returns the
+ *   buffer holding it.  The caller becomes the owner of the buffer.
+ *
+ * Returned Value:
+ *   The length of the message is returned on success.  A negated errno
+ *   value is returned on failure.  (see mq_receivebuffer() for the list of
+ *   valid return values).
+ *
+ ****************************************************************************/
+
+ssize_t nxmq_receivebuffer(mqd_t mqdes, FAR void **buffer,
+                           FAR unsigned int *prio);
+#endif
+
 /****************************************************************************
  * Name: nxmq_free_msgq
  *
@@ -47,6 +47,7 @@
 
 #include <nuttx/net/netconfig.h>
 #include <nuttx/compiler.h>
+#include <nuttx/fs/ioctl.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -74,6 +75,43 @@
 #define USRSOCK_MESSAGE_REQ_COMPLETED(flags) \
                           (!USRSOCK_MESSAGE_REQ_IN_PROGRESS(flags))
 
+/* Shared-memory ring transport.
+ *
+ * Instead of read()ing requests from and write()ing responses to
+ * /dev/usrsock, the daemon may mmap() the device to obtain a pair of rings
+ * shared with the kernel:
+ *
+ *   - The submission queue (SQ) carries requests (kernel => daemon).  The
+ *     kernel advances sq_head, the daemon advances sq_tail.
+ *   - The completion queue (CQ) carries responses and events
+ *     (daemon => kernel).  The daemon advances cq_head, the kernel
+ *     advances cq_tail.
+ *
+ * Each queue is an array of fixed-size slots.  A message starts on a slot
+ * boundary with a struct usrsock_ring_entry_s header, followed directly by
+ * the message exactly as it would be passed through read()/write(),
+ * including any data payload.  Messages that do not fit in a single slot
+ * occupy consecutive slots; a message never wraps around the end of the
+ * queue.  Instead the producer fills the remaining slots with a single
+ * USRSOCK_RING_ENTRY_PAD entry and continues at slot zero.
+ *
+ * Head and tail are free-running slot counters; a queue is empty when
+ * head == tail.  The daemon learns of new submissions via POLLIN.  After
+ * producing one or more completions, and after consuming submissions while
+ * the SQ was full, the daemon rings the doorbell with
+ * USRSOCKIOC_RING_DOORBELL so that the kernel processes the whole batch in
+ * one system call.
+ */
+
+#define USRSOCK_RING_MAGIC           0x75737272 /* "usrr" */
+#define USRSOCK_RING_ENTRY_PAD       0xffffffff /* Skip to slot zero */
+
+/* Process pending CQ entries.  Argument is ignored; the number of entries
+ * processed is returned.
+ */
+
+#define USRSOCKIOC_RING_DOORBELL     _USRSOCKIOC(0x0001)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -269,4 +307,28 @@ begin_packed_struct struct usrsock_message_socket_event_s
   uint16_t events;
 } end_packed_struct;
 
+/* Shared-memory ring (kernel <=> mmap(/dev/usrsock) <=> daemon) */
+
+struct usrsock_ring_entry_s
+{
+  uint32_t len;               /* Length of the message following this
+                               * header, or USRSOCK_RING_ENTRY_PAD */
+};
+
+struct usrsock_ring_s
+{
+  uint32_t magic;             /* USRSOCK_RING_MAGIC */
+  uint16_t slotsize;          /* Size of one slot in bytes */
+  uint16_t sq_nslots;         /* Number of submission queue slots */
+  uint16_t cq_nslots;         /* Number of completion queue slots */
+  uint16_t reserved;
+  uint32_t sq_offset;         /* Offset of the SQ slots from the ring base */
+  uint32_t cq_offset;         /* Offset of the CQ slots from the ring base */
+
+  volatile uint32_t sq_head;  /* Next SQ slot written by the kernel */
+  volatile uint32_t sq_tail;  /* Next SQ slot read by the daemon */
+  volatile uint32_t cq_head;  /* Next CQ slot written by the daemon */
+  volatile uint32_t cq_tail;  /* Next CQ slot read by the kernel */
+};
+
 #endif /* __INCLUDE_NUTTX_NET_USRSOCK_H */
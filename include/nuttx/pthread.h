@@ -114,6 +114,10 @@
   }
 #endif
 
+/* futex_wait() flags */
+
+#define FUTEX_CANCELPT    (1 << 0)  /* Wake on a deferred cancellation */
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -136,6 +140,52 @@ EXTERN const pthread_attr_t g_default_pthread_attr;
  * Public Function Prototypes
  ****************************************************************************/
 
+#ifdef CONFIG_PTHREAD_FUTEX
+/****************************************************************************
+ * Name: futex_wait
+ *
+ * Description:
+ *   Sleep on the 32-bit word at 'addr' provided that it still holds 'val'.
+ *   Returns zero (OK) when awakened by futex_wake() or a positive errno
+ *   value (EAGAIN, ETIMEDOUT, EINTR, EINVAL, ECANCELED).  Spurious wakeups
+ *   are possible.
+ *
+ ****************************************************************************/
+
+int futex_wait(FAR volatile uint32_t *addr, uint32_t val,
+               clockid_t clockid, FAR const struct timespec *abstime,
+               int flags);
+
+/****************************************************************************
+ * Name: futex_wake
+ *
+ * Description:
+ *   Wake at most 'nwake' threads sleeping on 'addr'.  Returns the number
+ *   of threads that were awakened.
+ *
+ ****************************************************************************/
+
+int futex_wake(FAR volatile uint32_t *addr, int nwake);
+
+/****************************************************************************
+ * Name: nx_pthread_mutex_timedlock, nx_pthread_mutex_trylock,
+ *       nx_pthread_mutex_unlock
+ *
+ * Description:
+ *   The kernel implementations of pthread_mutex_timedlock(),
+ *   pthread_mutex_trylock() and pthread_mutex_unlock().  With futexes,
+ *   the C library handles plain mutexes in user space and calls these
+ *   only for mutexes that need the kernel:  Robust, recursive,
+ *   error-checking and priority inheritance mutexes.
+ *
+ ****************************************************************************/
+
+int nx_pthread_mutex_timedlock(FAR pthread_mutex_t *mutex,
+                               FAR const struct timespec *abs_timeout);
+int nx_pthread_mutex_trylock(FAR pthread_mutex_t *mutex);
+int nx_pthread_mutex_unlock(FAR pthread_mutex_t *mutex);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -106,7 +106,9 @@
 #define TCB_FLAG_SIGNAL_ACTION     (1 << 8)                      /* Bit 8: In a signal handler */
 #define TCB_FLAG_SYSCALL           (1 << 9)                      /* Bit 9: In a system call */
 #define TCB_FLAG_EXIT_PROCESSING   (1 << 10)                     /* Bit 10: Exitting */
-                                                                 /* Bits 11-15: Available */
+#define TCB_FLAG_STACK_SCAN        (1 << 11)                     /* Bit 11: Stack usage scan pending */
+#define TCB_FLAG_STACK_VALID       (1 << 12)                     /* Bit 12: Cached stack usage valid */
+                                                                 /* Bits 13-15: Available */
 
 /* Values for struct task_group tg_flags */
 
@@ -688,6 +690,9 @@ struct tcb_s
                                          /* Needed to deallocate stack          */
   FAR void *adj_stack_ptr;               /* Adjusted stack_alloc_ptr for HW     */
                                          /* The initial stack pointer value     */
+#ifdef CONFIG_STACK_USAGE_CACHE
+  size_t    stack_used;                  /* Last measured stack usage           */
+#endif
 
   /* External Module Support ****************************************************/
 
@@ -739,6 +744,10 @@ struct tcb_s
   uint32_t crit_max;                     /* Max time in critical section        */
 #endif
 
+#ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
+  uint64_t run_time;                     /* Total execution time of the thread  */
+#endif
+
   /* State save areas ***********************************************************/
 
   /* The form and content of these fields are platform-specific.                */
@@ -1372,6 +1381,28 @@ int nxsched_set_affinity(pid_t pid, size_t cpusetsize,
 
 int nxsched_get_stackinfo(pid_t pid, FAR struct stackinfo_s *stackinfo);
 
+/********************************************************************************
+ * Name: nxsched_check_tcbstack
+ *
+ * Description:
+ *   Determine (approximately) how much stack a thread has used, like
+ *   up_check_tcbstack().  With CONFIG_STACK_USAGE_CACHE, the stack is only
+ *   scanned again if the thread has run since it was last measured.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread to be measured.
+ *
+ * Returned Value:
+ *   The estimated amount of stack space used.
+ *
+ ********************************************************************************/
+
+#ifdef CONFIG_STACK_USAGE_CACHE
+size_t nxsched_check_tcbstack(FAR struct tcb_s *tcb);
+#elif defined(CONFIG_STACK_COLORATION)
+#  define nxsched_check_tcbstack(tcb) up_check_tcbstack(tcb)
+#endif
+
 /********************************************************************************
  * Name: nx_wait/nx_waitid/nx_waitpid
  ********************************************************************************/
@@ -144,7 +144,12 @@ struct uart_buffer_s
   FAR char        *buffer; /* Pointer to the allocated buffer memory */
 };
 
-#if defined(CONFIG_SERIAL_RXDMA) || defined(CONFIG_SERIAL_TXDMA)
+/* This structure describes the one or two contiguous regions of a circular
+ * buffer that take part in a DMA or bulk transfer.
+ */
+
+#if defined(CONFIG_SERIAL_RXDMA) || defined(CONFIG_SERIAL_TXDMA) || \
+    defined(CONFIG_SERIAL_BULKIO)
 struct uart_dmaxfer_s
 {
   FAR char        *buffer;  /* First DMA buffer */
@@ -153,7 +158,7 @@ struct uart_dmaxfer_s
   size_t           nlength; /* Length of next DMA buffer */
   size_t           nbytes;  /* Bytes actually transferred by DMA from both buffers */
 };
-#endif /* CONFIG_SERIAL_RXDMA || CONFIG_SERIAL_TXDMA */
+#endif /* CONFIG_SERIAL_RXDMA || CONFIG_SERIAL_TXDMA || CONFIG_SERIAL_BULKIO */
 
 /* This structure defines all of the operations providd by the architecture specific
  * logic.  All fields must be provided with non-NULL function pointers by the
@@ -270,6 +275,20 @@ struct uart_ops_s
    */
 
   CODE bool (*txempty)(FAR struct uart_dev_s *dev);
+
+#ifdef CONFIG_SERIAL_BULKIO
+  /* Optional.  Called from the interrupt level to send as many bytes of a
+   * contiguous span as the hardware accepts without waiting, and to receive
+   * the available bytes into a contiguous span.  Both return the number of
+   * bytes transferred.  If provided, uart_xmitchars() and uart_recvchars()
+   * move data in spans instead of calling send() and receive() per byte.
+   */
+
+  CODE size_t (*sendbuf)(FAR struct uart_dev_s *dev, FAR const char *buffer,
+                         size_t buflen);
+  CODE size_t (*recvbuf)(FAR struct uart_dev_s *dev, FAR char *buffer,
+                         size_t buflen);
+#endif
 };
 
 /* This is the device structure used by the driver.  The caller of
@@ -495,6 +514,34 @@ void uart_recvchars_dma(FAR uart_dev_t *dev);
 void uart_recvchars_done(FAR uart_dev_t *dev);
 #endif
 
+/************************************************************************************
+ * Name: uart_xmitchars_bulk
+ *
+ * Description:
+ *   Send bytes from the TX circular buffer with the lower half sendbuf() method,
+ *   one contiguous span at a time.  This is called by uart_xmitchars() when the
+ *   lower half provides sendbuf().
+ *
+ ************************************************************************************/
+
+#ifdef CONFIG_SERIAL_BULKIO
+void uart_xmitchars_bulk(FAR uart_dev_t *dev);
+#endif
+
+/************************************************************************************
+ * Name: uart_recvchars_bulk
+ *
+ * Description:
+ *   Receive bytes into the RX circular buffer with the lower half recvbuf() method,
+ *   one contiguous span at a time.  This is called by uart_recvchars() when the
+ *   lower half provides recvbuf().
+ *
+ ************************************************************************************/
+
+#ifdef CONFIG_SERIAL_BULKIO
+void uart_recvchars_bulk(FAR uart_dev_t *dev);
+#endif
+
 /************************************************************************************
  * Name: uart_reset_sem
  *
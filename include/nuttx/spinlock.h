@@ -44,6 +44,7 @@
 
 #include <sys/types.h>
 #include <stdint.h>
+#include <string.h>
 
 #ifdef CONFIG_SPINLOCK
 
@@ -96,6 +97,96 @@
 #  define SP_SECTION
 #endif
 
+/* Fair (ticket) spinlocks and read/write spinlocks are built on the
+ * architecture's atomic fetch-add and compare-and-exchange operations.
+ */
+
+#ifdef CONFIG_ARCH_HAVE_FETCHADD
+#  define HAVE_TICKET_SPINLOCK 1
+#endif
+
+/* Number of log2 buckets in the wait/hold time histograms */
+
+#define SPINLOCK_STATS_NHIST 16
+
+/* Give a name to a ticket or read/write spinlock and make its statistics
+ * visible in /proc/spinlocks.  The lock must be unregistered before its
+ * memory is released.
+ *
+ * void spin_stats_register(FAR <lock type> *lock, FAR const char *name);
+ * void spin_stats_unregister(FAR <lock type> *lock);
+ */
+
+#ifdef CONFIG_SPINLOCK_STATS
+#  define spin_stats_register(l,n) spinlock_stats_register(&(l)->stats, (n))
+#  define spin_stats_unregister(l) spinlock_stats_unregister(&(l)->stats)
+#else
+#  define spin_stats_register(l,n)
+#  define spin_stats_unregister(l)
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_STATS
+/* Contention statistics of one ticket or read/write spinlock.  Times are in
+ * the units of up_critmon_gettime().  Histogram bucket n counts the
+ * contended acquisitions (or the exclusive holds) that lasted [2^n, 2^(n+1))
+ * time units.  Hold times are only gathered for ticket and write owners.
+ */
+
+struct spinlock_stats_s
+{
+  FAR struct spinlock_stats_s *flink;   /* Link in the list of named locks */
+  FAR const char *name;                 /* Name given at registration */
+  uint32_t nacquired;                   /* Number of acquisitions */
+  uint32_t ncontended;                  /* Acquisitions that had to spin */
+  uint32_t maxwait;                     /* Longest wait for the lock */
+  uint32_t maxhold;                     /* Longest exclusive hold */
+  uint32_t start;                       /* Time the exclusive owner got it */
+  uint32_t wait[SPINLOCK_STATS_NHIST];  /* Wait time histogram */
+  uint32_t hold[SPINLOCK_STATS_NHIST];  /* Hold time histogram */
+};
+#endif
+
+#ifdef HAVE_TICKET_SPINLOCK
+/* A ticket spinlock grants the lock to the waiting CPUs in the order they
+ * requested it.  The owner field is only modified by the lock holder.
+ */
+
+struct ticket_spinlock_s
+{
+  volatile int16_t next;                /* Next ticket to hand out */
+  volatile int16_t owner;               /* Ticket now owning the lock */
+#ifdef CONFIG_SPINLOCK_STATS
+  struct spinlock_stats_s stats;
+#endif
+};
+
+typedef struct ticket_spinlock_s ticket_spinlock_t;
+
+/* A read/write spinlock admits any number of readers or a single writer.
+ * A waiting writer blocks new readers so that writers cannot starve.
+ */
+
+struct rwlock_s
+{
+  volatile int16_t state;               /* See RW_* in spinlock.c */
+#ifdef CONFIG_SPINLOCK_STATS
+  struct spinlock_stats_s stats;
+#endif
+};
+
+typedef struct rwlock_s rwlock_t;
+
+/* void ticket_spin_initialize(FAR ticket_spinlock_t *lock); */
+/* void rwlock_initialize(FAR rwlock_t *lock); */
+
+#define ticket_spin_initialize(l) memset((l), 0, sizeof(ticket_spinlock_t))
+#define rwlock_initialize(l)      memset((l), 0, sizeof(rwlock_t))
+#endif /* HAVE_TICKET_SPINLOCK */
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -342,5 +433,114 @@ void spin_clrbit(FAR volatile cpu_set_t *set, unsigned int cpu,
                  FAR volatile spinlock_t *orlock);
 #endif
 
+#ifdef HAVE_TICKET_SPINLOCK
+/****************************************************************************
+ * Name: ticket_spin_lock
+ *
+ * Description:
+ *   Take a ticket and spin until the lock is handed over to that ticket.
+ *   Unlike spin_lock(), waiters are served in first-come, first-served
+ *   order so no CPU can be starved under contention.
+ *
+ * Input Parameters:
+ *   lock - A reference to the ticket spinlock object to lock.
+ *
+ * Returned Value:
+ *   None.  When the function returns, the spinlock was successfully locked
+ *   by this CPU.
+ *
+ ****************************************************************************/
+
+void ticket_spin_lock(FAR ticket_spinlock_t *lock);
+
+/****************************************************************************
+ * Name: ticket_spin_trylock
+ *
+ * Description:
+ *   Take the ticket spinlock only if it is free and nobody is waiting.
+ *
+ * Returned Value:
+ *   SP_LOCKED - Failure, the spinlock was already locked
+ *   SP_UNLOCKED - Success, the spinlock was successfully locked
+ *
+ ****************************************************************************/
+
+spinlock_t ticket_spin_trylock(FAR ticket_spinlock_t *lock);
+
+/****************************************************************************
+ * Name: ticket_spin_unlock
+ *
+ * Description:
+ *   Hand the ticket spinlock over to the next waiter, if any.
+ *
+ ****************************************************************************/
+
+void ticket_spin_unlock(FAR ticket_spinlock_t *lock);
+
+/****************************************************************************
+ * Name: read_lock, read_trylock, read_unlock
+ *
+ * Description:
+ *   Take or release a read/write spinlock for reading.  Any number of
+ *   readers may hold the lock at the same time.  read_trylock() returns
+ *   SP_UNLOCKED on success and SP_LOCKED if a writer holds or waits for
+ *   the lock.
+ *
+ ****************************************************************************/
+
+void read_lock(FAR rwlock_t *lock);
+spinlock_t read_trylock(FAR rwlock_t *lock);
+void read_unlock(FAR rwlock_t *lock);
+
+/****************************************************************************
+ * Name: write_lock, write_trylock, write_unlock
+ *
+ * Description:
+ *   Take or release a read/write spinlock for writing.  The writer waits
+ *   for all readers to leave; new readers are held off in the meantime.
+ *   write_trylock() returns SP_UNLOCKED on success and SP_LOCKED if the
+ *   lock is held.
+ *
+ ****************************************************************************/
+
+void write_lock(FAR rwlock_t *lock);
+spinlock_t write_trylock(FAR rwlock_t *lock);
+void write_unlock(FAR rwlock_t *lock);
+#endif /* HAVE_TICKET_SPINLOCK */
+
+#ifdef CONFIG_SPINLOCK_STATS
+/****************************************************************************
+ * Name: spinlock_stats_register and spinlock_stats_unregister
+ *
+ * Description:
+ *   Add or remove the statistics of a lock to/from the list reported by
+ *   /proc/spinlocks.  Normally used via spin_stats_register() and
+ *   spin_stats_unregister().
+ *
+ ****************************************************************************/
+
+void spinlock_stats_register(FAR struct spinlock_stats_s *stats,
+                             FAR const char *name);
+void spinlock_stats_unregister(FAR struct spinlock_stats_s *stats);
+
+/****************************************************************************
+ * Name: spinlock_stats_snapshot
+ *
+ * Description:
+ *   Copy the statistics of the most contended registered locks, most
+ *   contended first.
+ *
+ * Input Parameters:
+ *   buffer - Location to receive the copies
+ *   nmax   - Maximum number of entries in buffer
+ *
+ * Returned Value:
+ *   The number of entries copied.
+ *
+ ****************************************************************************/
+
+int spinlock_stats_snapshot(FAR struct spinlock_stats_s *buffer, int nmax);
+#endif
+
 #endif /* CONFIG_SPINLOCK */
 #endif /* __INCLUDE_NUTTX_SPINLOCK_H */
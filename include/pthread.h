@@ -154,7 +154,11 @@
 
 /* Used to initialize a pthread_once_t */
 
-#define PTHREAD_ONCE_INIT             (false)
+#ifdef CONFIG_PTHREAD_FUTEX
+#  define PTHREAD_ONCE_INIT           (0)
+#else
+#  define PTHREAD_ONCE_INIT           (false)
+#endif
 
 /* This is returned by pthread_barrier_wait.  It must not match any errno
  * in errno.h
@@ -285,18 +289,36 @@ typedef struct pthread_condattr_s pthread_condattr_t;
 #define __PTHREAD_CONDATTR_T_DEFINED 1
 #endif
 
+#ifdef CONFIG_PTHREAD_FUTEX
+/* The condition variable is a futex word holding a sequence number that is
+ * advanced by each signal or broadcast, and a count of waiters so that a
+ * signal with no waiters stays in user space.
+ */
+
+struct pthread_cond_s
+{
+  volatile uint32_t seq;      /* Signal sequence number (futex word) */
+  volatile uint32_t waiters;  /* Number of waiting threads */
+  clockid_t clockid;
+};
+#else
 struct pthread_cond_s
 {
   sem_t sem;
   clockid_t clockid;
 };
+#endif
 
 #ifndef __PTHREAD_COND_T_DEFINED
 typedef struct pthread_cond_s pthread_cond_t;
 #define __PTHREAD_COND_T_DEFINED 1
 #endif
 
-#define PTHREAD_COND_INITIALIZER {SEM_INITIALIZER(0), CLOCK_REALTIME }
+#ifdef CONFIG_PTHREAD_FUTEX
+#  define PTHREAD_COND_INITIALIZER {0, 0, CLOCK_REALTIME }
+#else
+#  define PTHREAD_COND_INITIALIZER {SEM_INITIALIZER(0), CLOCK_REALTIME }
+#endif
 
 struct pthread_mutexattr_s
 {
@@ -336,6 +358,15 @@ struct pthread_mutex_s
   uint8_t type;     /* Type of the mutex.  See PTHREAD_MUTEX_* definitions */
   int16_t nlocks;   /* The number of recursive locks held */
 #endif
+#ifdef CONFIG_PTHREAD_FUTEX
+  /* Futex word of mutexes locked in user space:  0 = unlocked, 1 = locked,
+   * 2 = locked with possible waiters.  The remaining fields are used only
+   * by robust, recursive, error-checking and priority inheritance mutexes
+   * that are locked in the kernel.
+   */
+
+  volatile uint32_t futex;
+#endif
 };
 
 #ifndef __PTHREAD_MUTEX_T_DEFINED
@@ -394,10 +425,28 @@ typedef struct pthread_barrier_s pthread_barrier_t;
 #endif
 
 #ifndef __PTHREAD_ONCE_T_DEFINED
+#ifdef CONFIG_PTHREAD_FUTEX
+typedef uint32_t pthread_once_t;
+#else
 typedef bool pthread_once_t;
+#endif
 #define __PTHREAD_ONCE_T_DEFINED 1
 #endif
 
+#ifdef CONFIG_PTHREAD_FUTEX
+/* The read/write lock is a single futex word holding the number of readers,
+ * the number of waiting writers and writer-owned and waiters-present flags.
+ * Uncontended lock and unlock operations are performed in user space with
+ * atomic operations.
+ */
+
+struct pthread_rwlock_s
+{
+  volatile uint32_t state;
+};
+
+#define PTHREAD_RWLOCK_INITIALIZER  {0}
+#else
 struct pthread_rwlock_s
 {
   pthread_mutex_t lock;
@@ -407,13 +456,14 @@ struct pthread_rwlock_s
   bool write_in_progress;
 };
 
-typedef struct pthread_rwlock_s pthread_rwlock_t;
-
-typedef int pthread_rwlockattr_t;
-
 #define PTHREAD_RWLOCK_INITIALIZER  {PTHREAD_MUTEX_INITIALIZER, \
                                      PTHREAD_COND_INITIALIZER, \
                                      0, 0, false}
+#endif
+
+typedef struct pthread_rwlock_s pthread_rwlock_t;
+
+typedef int pthread_rwlockattr_t;
 
 #ifdef CONFIG_PTHREAD_SPINLOCKS
 #ifndef __PTHREAD_SPINLOCK_T_DEFINED
@@ -801,7 +851,11 @@ typedef FAR struct pthread_spinlock_s pthread_spinlock_t;
 #endif /* CONFIG_PTHREAD_SPINLOCKS */
 
 #ifndef __PTHREAD_ONCE_T_DEFINED
+#ifdef CONFIG_PTHREAD_FUTEX
+typedef uint32_t pthread_once_t;
+#else
 typedef bool pthread_once_t;
+#endif
 #  define __PTHREAD_ONCE_T_DEFINED 1
 #endif
 
@@ -242,6 +242,8 @@ int      mkstemp(FAR char *path_template);
 
 void     qsort(FAR void *base, size_t nel, size_t width,
                CODE int (*compar)(FAR const void *, FAR const void *));
+int      mergesort(FAR void *base, size_t nel, size_t width,
+                   CODE int (*compar)(FAR const void *, FAR const void *));
 
 /* Binary search */
 
@@ -247,6 +247,7 @@ SYSCALL_LOOKUP(telldir,                    1)
 
 #if defined(CONFIG_FS_RAMMAP)
   SYSCALL_LOOKUP(munmap,                   2)
+  SYSCALL_LOOKUP(msync,                    3)
 #endif
 
 #if defined(CONFIG_PSEUDOFS_SOFTLINKS)
@@ -297,9 +298,11 @@ SYSCALL_LOOKUP(telldir,                    1)
 
 #ifndef CONFIG_DISABLE_PTHREAD
   SYSCALL_LOOKUP(pthread_cancel,           1)
+#ifndef CONFIG_PTHREAD_FUTEX
   SYSCALL_LOOKUP(pthread_cond_broadcast,   1)
   SYSCALL_LOOKUP(pthread_cond_signal,      1)
   SYSCALL_LOOKUP(pthread_cond_wait,        2)
+#endif
   SYSCALL_LOOKUP(pthread_create,           4)
   SYSCALL_LOOKUP(pthread_detach,           1)
   SYSCALL_LOOKUP(pthread_exit,             1)
@@ -307,9 +310,11 @@ SYSCALL_LOOKUP(telldir,                    1)
   SYSCALL_LOOKUP(pthread_join,             2)
   SYSCALL_LOOKUP(pthread_mutex_destroy,    1)
   SYSCALL_LOOKUP(pthread_mutex_init,       2)
+#ifndef CONFIG_PTHREAD_FUTEX
   SYSCALL_LOOKUP(pthread_mutex_timedlock,  2)
   SYSCALL_LOOKUP(pthread_mutex_trylock,    1)
   SYSCALL_LOOKUP(pthread_mutex_unlock,     1)
+#endif
 #ifndef CONFIG_PTHREAD_MUTEX_UNSAFE
   SYSCALL_LOOKUP(pthread_mutex_consistent, 1)
 #endif
@@ -319,13 +324,22 @@ SYSCALL_LOOKUP(telldir,                    1)
   SYSCALL_LOOKUP(pthread_setaffinity_np,   3)
   SYSCALL_LOOKUP(pthread_getaffinity_np,   3)
 #endif
+#ifndef CONFIG_PTHREAD_FUTEX
   SYSCALL_LOOKUP(pthread_cond_clockwait,   4)
+#endif
   SYSCALL_LOOKUP(pthread_kill,             2)
   SYSCALL_LOOKUP(pthread_sigmask,          3)
 #ifdef CONFIG_PTHREAD_CLEANUP
   SYSCALL_LOOKUP(pthread_cleanup_push,     2)
   SYSCALL_LOOKUP(pthread_cleanup_pop,      1)
 #endif
+#ifdef CONFIG_PTHREAD_FUTEX
+  SYSCALL_LOOKUP(futex_wait,               5)
+  SYSCALL_LOOKUP(futex_wake,               2)
+  SYSCALL_LOOKUP(nx_pthread_mutex_timedlock, 2)
+  SYSCALL_LOOKUP(nx_pthread_mutex_trylock, 1)
+  SYSCALL_LOOKUP(nx_pthread_mutex_unlock,  1)
+#endif
 #endif
 
 /* The following are defined only if message queues are enabled */
@@ -341,6 +355,10 @@ SYSCALL_LOOKUP(telldir,                    1)
   SYSCALL_LOOKUP(mq_timedreceive,          5)
   SYSCALL_LOOKUP(mq_timedsend,             5)
   SYSCALL_LOOKUP(mq_unlink,                1)
+#ifdef CONFIG_MQ_ZEROCOPY
+  SYSCALL_LOOKUP(mq_sendbuffer,            4)
+  SYSCALL_LOOKUP(mq_receivebuffer,         3)
+#endif
 #endif
 
 /* The following are defined only if environment variables are supported */
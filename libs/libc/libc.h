@@ -99,6 +99,19 @@
 
 #define LIB_BUFLEN_UNKNOWN INT_MAX
 
+/* Helpers for the word-at-a-time string functions.  LIBC_WORD_HASZERO(w)
+ * is non-zero if and only if some byte in the word 'w' is zero.
+ */
+
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+#  define LIBC_WORD_SIZE       sizeof(uintptr_t)
+#  define LIBC_WORD_MASK       (LIBC_WORD_SIZE - 1)
+#  define LIBC_WORD_ONES       ((uintptr_t)-1 / 0xff)
+#  define LIBC_WORD_HIGHS      (LIBC_WORD_ONES * 0x80)
+#  define LIBC_WORD_HASZERO(w) \
+     (((w) - LIBC_WORD_ONES) & ~(w) & LIBC_WORD_HIGHS)
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -85,6 +85,22 @@ int modlib_findsymtab(FAR struct mod_loadinfo_s *loadinfo);
 int modlib_readsym(FAR struct mod_loadinfo_s *loadinfo, int index,
                    FAR Elf_Sym *sym);
 
+/****************************************************************************
+ * Name: modlib_loadsymtab
+ *
+ * Description:
+ *   Read the entire symbol table and its string table into memory.
+ *
+ * Returned Value:
+ *   0 (OK) is returned on success and a negated errno is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MODLIB_LOADSYMTAB
+int modlib_loadsymtab(FAR struct mod_loadinfo_s *loadinfo);
+#endif
+
 /****************************************************************************
  * Name: modlib_symvalue
  *
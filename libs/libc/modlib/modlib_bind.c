@@ -552,6 +552,19 @@ int modlib_bind(FAR struct module_s *modp,
       return ret;
     }
 
+#ifdef CONFIG_MODLIB_LOADSYMTAB
+  /* Read the symbol and string tables into memory in one pass.  This is
+   * only an optimization; if it fails, symbols are read from the file on
+   * demand.
+   */
+
+  ret = modlib_loadsymtab(loadinfo);
+  if (ret < 0)
+    {
+      bwarn("WARNING: modlib_loadsymtab failed: %d\n", ret);
+    }
+#endif
+
   /* Allocate an I/O buffer.  This buffer is used by mod_symname() to
    * accumulate the variable length symbol name.
    */
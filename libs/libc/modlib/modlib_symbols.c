@@ -31,6 +31,7 @@
 
 #include <nuttx/lib/modlib.h>
 
+#include "libc.h"
 #include "modlib/modlib.h"
 
 /****************************************************************************
@@ -61,7 +62,8 @@ struct mod_exportinfo_s
  * Name: modlib_symname
  *
  * Description:
- *   Get the symbol name in loadinfo->iobuffer[].
+ *   Get the symbol name.  The name is returned in 'name' and refers either
+ *   to the in-memory string table or to loadinfo->iobuffer[].
  *
  * Returned Value:
  *   0 (OK) is returned on success and a negated errno is returned on
@@ -74,7 +76,8 @@ struct mod_exportinfo_s
  ****************************************************************************/
 
 static int modlib_symname(FAR struct mod_loadinfo_s *loadinfo,
-                          FAR const Elf_Sym *sym)
+                          FAR const Elf_Sym *sym,
+                          FAR const char **name)
 {
   FAR uint8_t *buffer;
   off_t  offset;
@@ -92,6 +95,22 @@ static int modlib_symname(FAR struct mod_loadinfo_s *loadinfo,
       return -ESRCH;
     }
 
+#ifdef CONFIG_MODLIB_LOADSYMTAB
+  /* If the string table was read into memory, just point into it */
+
+  if (loadinfo->strtab != NULL)
+    {
+      if (sym->st_name >= loadinfo->shdr[loadinfo->strtabidx].sh_size)
+        {
+          berr("ERROR: Symbol name offset out of range\n");
+          return -EINVAL;
+        }
+
+      *name = &loadinfo->strtab[sym->st_name];
+      return OK;
+    }
+#endif
+
   offset = loadinfo->shdr[loadinfo->strtabidx].sh_offset + sym->st_name;
 
   /* Loop until we get the entire symbol name into memory */
@@ -117,7 +136,7 @@ static int modlib_symname(FAR struct mod_loadinfo_s *loadinfo,
       /* Read that number of bytes into the array */
 
       buffer = &loadinfo->iobuffer[bytesread];
-      ret = modlib_read(loadinfo, buffer, readlen, offset);
+      ret = modlib_read(loadinfo, buffer, readlen, offset + bytesread);
       if (ret < 0)
         {
           berr("ERROR: modlib_read failed: %d\n", ret);
@@ -132,6 +151,7 @@ static int modlib_symname(FAR struct mod_loadinfo_s *loadinfo,
         {
           /* Yes, the buffer contains a NUL terminator. */
 
+          *name = (FAR const char *)loadinfo->iobuffer;
           return OK;
         }
 
@@ -269,12 +289,22 @@ int modlib_readsym(FAR struct mod_loadinfo_s *loadinfo, int index,
 
   /* Verify that the symbol table index lies within symbol table */
 
-  if (index < 0 || index > (symtab->sh_size / sizeof(Elf_Sym)))
+  if (index < 0 || index >= (symtab->sh_size / sizeof(Elf_Sym)))
     {
       berr("ERROR: Bad relocation symbol index: %d\n", index);
       return -EINVAL;
     }
 
+#ifdef CONFIG_MODLIB_LOADSYMTAB
+  /* Copy the entry from the in-memory symbol table if there is one */
+
+  if (loadinfo->symtab != NULL)
+    {
+      *sym = loadinfo->symtab[index];
+      return OK;
+    }
+#endif
+
   /* Get the file offset to the symbol table entry */
 
   offset = symtab->sh_offset + sizeof(Elf_Sym) * index;
@@ -284,6 +314,78 @@ int modlib_readsym(FAR struct mod_loadinfo_s *loadinfo, int index,
   return modlib_read(loadinfo, (FAR uint8_t *)sym, sizeof(Elf_Sym), offset);
 }
 
+/****************************************************************************
+ * Name: modlib_loadsymtab
+ *
+ * Description:
+ *   Read the entire symbol table and its string table into memory so that
+ *   symbol lookups during relocation do not need to access the file.
+ *
+ * Input Parameters:
+ *   loadinfo - Load state information
+ *
+ * Returned Value:
+ *   0 (OK) is returned on success and a negated errno is returned on
+ *   failure.  On failure, no memory remains allocated and symbols will be
+ *   read from the file on demand.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MODLIB_LOADSYMTAB
+int modlib_loadsymtab(FAR struct mod_loadinfo_s *loadinfo)
+{
+  FAR Elf_Shdr *symtab = &loadinfo->shdr[loadinfo->symtabidx];
+  FAR Elf_Shdr *strtab = &loadinfo->shdr[loadinfo->strtabidx];
+  int ret;
+
+  /* Allocate one extra byte for the string table so that it is always
+   * NUL terminated, even if the file is corrupted.
+   */
+
+  loadinfo->symtab = (FAR Elf_Sym *)lib_malloc(symtab->sh_size);
+  loadinfo->strtab = (FAR char *)lib_malloc(strtab->sh_size + 1);
+  if (loadinfo->symtab == NULL || loadinfo->strtab == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  ret = modlib_read(loadinfo, (FAR uint8_t *)loadinfo->symtab,
+                    symtab->sh_size, symtab->sh_offset);
+  if (ret < 0)
+    {
+      berr("ERROR: Failed to read symbol table: %d\n", ret);
+      goto errout;
+    }
+
+  ret = modlib_read(loadinfo, (FAR uint8_t *)loadinfo->strtab,
+                    strtab->sh_size, strtab->sh_offset);
+  if (ret < 0)
+    {
+      berr("ERROR: Failed to read string table: %d\n", ret);
+      goto errout;
+    }
+
+  loadinfo->strtab[strtab->sh_size] = '\0';
+  return OK;
+
+errout:
+  if (loadinfo->symtab != NULL)
+    {
+      lib_free(loadinfo->symtab);
+      loadinfo->symtab = NULL;
+    }
+
+  if (loadinfo->strtab != NULL)
+    {
+      lib_free(loadinfo->strtab);
+      loadinfo->strtab = NULL;
+    }
+
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: modlib_symvalue
  *
@@ -313,6 +415,7 @@ int modlib_symvalue(FAR struct module_s *modp,
 {
   FAR const struct symtab_s *symbol;
   struct mod_exportinfo_s exportinfo;
+  FAR const char *name;
   uintptr_t secbase;
   int nsymbols;
   int ret;
@@ -339,7 +442,7 @@ int modlib_symvalue(FAR struct module_s *modp,
       {
         /* Get the name of the undefined symbol */
 
-        ret = modlib_symname(loadinfo, sym);
+        ret = modlib_symname(loadinfo, sym, &name);
         if (ret < 0)
           {
             /* There are a few relocations for a few architectures that do
@@ -358,7 +461,7 @@ int modlib_symvalue(FAR struct module_s *modp,
          * recently installed will take precedence.
          */
 
-        exportinfo.name   = (FAR const char *)loadinfo->iobuffer;
+        exportinfo.name   = name;
         exportinfo.modp   = modp;
         exportinfo.symbol = NULL;
 
@@ -393,7 +496,7 @@ int modlib_symvalue(FAR struct module_s *modp,
         if (symbol == NULL)
           {
             berr("ERROR: SHN_UNDEF: Exported symbol \"%s\" not found\n",
-                 loadinfo->iobuffer);
+                 name);
             return -ENOENT;
           }
 
@@ -402,7 +505,7 @@ int modlib_symvalue(FAR struct module_s *modp,
          */
 
         binfo("SHN_UNDEF: name=%s %08x+%08x=%08x\n",
-              loadinfo->iobuffer, sym->st_value, symbol->sym_value,
+              name, sym->st_value, symbol->sym_value,
               sym->st_value + symbol->sym_value);
 
         sym->st_value += ((uintptr_t)symbol->sym_value);
@@ -95,5 +95,19 @@ int modlib_freebuffers(struct mod_loadinfo_s *loadinfo)
       loadinfo->buflen    = 0;
     }
 
+#ifdef CONFIG_MODLIB_LOADSYMTAB
+  if (loadinfo->symtab != NULL)
+    {
+      lib_free((FAR void *)loadinfo->symtab);
+      loadinfo->symtab    = NULL;
+    }
+
+  if (loadinfo->strtab != NULL)
+    {
+      lib_free((FAR void *)loadinfo->strtab);
+      loadinfo->strtab    = NULL;
+    }
+#endif
+
   return OK;
 }
@@ -0,0 +1,196 @@
+/****************************************************************************
+ * libs/libc/pthread/pthread_cond_futex.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <limits.h>
+#include <pthread.h>
+#include <errno.h>
+
+#include <nuttx/pthread.h>
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cond_wake
+ *
+ * Description:
+ *   Advance the sequence number so that no thread that sampled it earlier
+ *   can go to sleep, then wake up to 'nwake' sleepers.  The kernel is
+ *   entered only if there are waiters.
+ *
+ ****************************************************************************/
+
+static int cond_wake(FAR pthread_cond_t *cond, int nwake)
+{
+  if (cond == NULL)
+    {
+      return EINVAL;
+    }
+
+  __atomic_fetch_add(&cond->seq, 1, __ATOMIC_SEQ_CST);
+  if (__atomic_load_n(&cond->waiters, __ATOMIC_SEQ_CST) > 0)
+    {
+      futex_wake(&cond->seq, nwake);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pthread_cond_clockwait
+ *
+ * Description:
+ *   A thread can perform a timed wait on a condition variable.
+ *
+ * Input Parameters:
+ *   cond    - the condition variable to wait on
+ *   mutex   - the mutex that protects the condition variable
+ *   clockid - The timing source to use in the conversion
+ *   abstime - wait until this absolute time or NULL to wait forever
+ *
+ * Returned Value:
+ *   OK (0) on success; A non-zero errno value is returned on failure.
+ *
+ * Assumptions:
+ *   Spurious wakeups are possible, as POSIX permits.
+ *
+ ****************************************************************************/
+
+int pthread_cond_clockwait(FAR pthread_cond_t *cond,
+                           FAR pthread_mutex_t *mutex,
+                           clockid_t clockid,
+                           FAR const struct timespec *abstime)
+{
+  uint32_t seq;
+  int status;
+  int ret;
+
+  if (cond == NULL || mutex == NULL)
+    {
+      return EINVAL;
+    }
+
+  /* Register as a waiter and sample the sequence number while still
+   * holding the mutex.  A signal after this point changes the sequence
+   * number so that the wait below does not sleep.
+   */
+
+  __atomic_fetch_add(&cond->waiters, 1, __ATOMIC_SEQ_CST);
+  seq = __atomic_load_n(&cond->seq, __ATOMIC_SEQ_CST);
+
+  ret = pthread_mutex_unlock(mutex);
+  if (ret != OK)
+    {
+      __atomic_fetch_sub(&cond->waiters, 1, __ATOMIC_SEQ_CST);
+      return ret;
+    }
+
+  /* pthread_cond_clockwait() is a cancellation point, but the mutex must
+   * be reacquired before the cancellation is acted upon.
+   */
+
+  status = futex_wait(&cond->seq, seq, clockid, abstime, FUTEX_CANCELPT);
+
+  ret = pthread_mutex_lock(mutex);
+  __atomic_fetch_sub(&cond->waiters, 1, __ATOMIC_SEQ_CST);
+
+  if (status == ECANCELED)
+    {
+      pthread_testcancel();
+    }
+
+  if (ret == OK && (status == ETIMEDOUT || status == EINVAL))
+    {
+      ret = status;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pthread_cond_wait
+ *
+ * Description:
+ *   A thread can wait for a condition variable to be signalled or
+ *   broadcast.
+ *
+ * Input Parameters:
+ *   cond  - the condition variable to wait on
+ *   mutex - the mutex that protects the condition variable
+ *
+ * Returned Value:
+ *   OK (0) on success; A non-zero errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+int pthread_cond_wait(FAR pthread_cond_t *cond, FAR pthread_mutex_t *mutex)
+{
+  return pthread_cond_clockwait(cond, mutex, CLOCK_REALTIME, NULL);
+}
+
+/****************************************************************************
+ * Name: pthread_cond_signal
+ *
+ * Description:
+ *   A thread can signal on a condition variable.
+ *
+ * Input Parameters:
+ *   cond - the condition variable to signal
+ *
+ * Returned Value:
+ *   OK (0) on success; A non-zero errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+int pthread_cond_signal(FAR pthread_cond_t *cond)
+{
+  return cond_wake(cond, 1);
+}
+
+/****************************************************************************
+ * Name: pthread_cond_broadcast
+ *
+ * Description:
+ *   A thread broadcast on a condition variable.
+ *
+ * Input Parameters:
+ *   cond - the condition variable to broadcast
+ *
+ * Returned Value:
+ *   OK (0) on success; A non-zero errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+int pthread_cond_broadcast(FAR pthread_cond_t *cond)
+{
+  return cond_wake(cond, INT_MAX);
+}
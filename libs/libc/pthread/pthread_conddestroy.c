@@ -74,12 +74,14 @@ int pthread_cond_destroy(FAR pthread_cond_t *cond)
       ret = EINVAL;
     }
 
+#ifndef CONFIG_PTHREAD_FUTEX
   /* Destroy the semaphore contained in the structure */
 
   else if (sem_destroy((FAR sem_t *)&cond->sem) != OK)
     {
       ret = EINVAL;
     }
+#endif
 
   sinfo("Returning %d\n", ret);
   return ret;
@@ -76,6 +76,14 @@ int pthread_cond_init(FAR pthread_cond_t *cond,
       ret = EINVAL;
     }
 
+#ifdef CONFIG_PTHREAD_FUTEX
+  else
+    {
+      cond->seq     = 0;
+      cond->waiters = 0;
+      cond->clockid = attr ? attr->clockid : CLOCK_REALTIME;
+    }
+#else
   /* Initialize the semaphore contained in the condition structure with
    * initial count = 0
    */
@@ -94,6 +102,7 @@ int pthread_cond_init(FAR pthread_cond_t *cond,
 
       cond->clockid = attr ? attr->clockid : CLOCK_REALTIME;
     }
+#endif
 
   sinfo("Returning %d\n", ret);
   return ret;
@@ -0,0 +1,217 @@
+/****************************************************************************
+ * libs/libc/pthread/pthread_mutex_futex.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <errno.h>
+
+#include <nuttx/pthread.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Values of the futex word */
+
+#define MUTEX_UNLOCKED       0  /* The mutex is available */
+#define MUTEX_LOCKED         1  /* Locked, no thread is sleeping */
+#define MUTEX_CONTENDED      2  /* Locked, threads may be sleeping */
+
+#define MUTEX_CAS(m,o,n) \
+  __atomic_compare_exchange_n(&(m)->futex, (o), (n), false, \
+                              __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)
+#define MUTEX_XCHG(m,n,o) \
+  __atomic_exchange_n(&(m)->futex, (n), (o))
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pthread_mutex_isfast
+ *
+ * Description:
+ *   Return true if the mutex can be locked and unlocked in user space.
+ *   Robust, recursive, error-checking and priority inheritance mutexes must
+ *   know their holder and are left to the kernel.
+ *
+ ****************************************************************************/
+
+static inline bool pthread_mutex_isfast(FAR pthread_mutex_t *mutex)
+{
+#ifndef CONFIG_PTHREAD_MUTEX_UNSAFE
+  if ((mutex->flags & _PTHREAD_MFLAGS_ROBUST) != 0)
+    {
+      return false;
+    }
+#endif
+
+#ifdef CONFIG_PTHREAD_MUTEX_TYPES
+  if (mutex->type != PTHREAD_MUTEX_NORMAL)
+    {
+      return false;
+    }
+#endif
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  if ((mutex->sem.flags & PRIOINHERIT_FLAGS_DISABLE) == 0)
+    {
+      return false;
+    }
+#endif
+
+  return true;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pthread_mutex_timedlock
+ *
+ * Description:
+ *   Lock the mutex, waiting no longer than 'abs_timeout' (CLOCK_REALTIME)
+ *   if it is not NULL.  An uncontended lock is a single atomic operation on
+ *   the futex word; the kernel is entered only to sleep.
+ *
+ * Input Parameters:
+ *   mutex       - A reference to the mutex to be locked.
+ *   abs_timeout - Maximum wait time or NULL to wait forever.
+ *
+ * Returned Value:
+ *   0 on success or an errno value on failure (ETIMEDOUT, EINVAL).  EINTR
+ *   is never returned.
+ *
+ ****************************************************************************/
+
+int pthread_mutex_timedlock(FAR pthread_mutex_t *mutex,
+                            FAR const struct timespec *abs_timeout)
+{
+  uint32_t state = MUTEX_UNLOCKED;
+  int ret;
+
+  if (mutex == NULL || !pthread_mutex_isfast(mutex))
+    {
+      return nx_pthread_mutex_timedlock(mutex, abs_timeout);
+    }
+
+  if (MUTEX_CAS(mutex, &state, MUTEX_LOCKED))
+    {
+      return OK;
+    }
+
+  /* Contended.  Mark the mutex so that the holder will wake us up and sleep
+   * until we manage to take it.  Because we cannot know if other threads
+   * still sleep, the mutex is taken in the contended state.
+   */
+
+  if (state != MUTEX_CONTENDED)
+    {
+      state = MUTEX_XCHG(mutex, MUTEX_CONTENDED, __ATOMIC_ACQUIRE);
+    }
+
+  while (state != MUTEX_UNLOCKED)
+    {
+      ret = futex_wait(&mutex->futex, MUTEX_CONTENDED, CLOCK_REALTIME,
+                       abs_timeout, 0);
+      if (ret == ETIMEDOUT || ret == EINVAL)
+        {
+          return ret;
+        }
+
+      state = MUTEX_XCHG(mutex, MUTEX_CONTENDED, __ATOMIC_ACQUIRE);
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pthread_mutex_trylock
+ *
+ * Description:
+ *   Lock the mutex if it is available; otherwise return EBUSY.
+ *
+ * Input Parameters:
+ *   mutex - A reference to the mutex to be locked.
+ *
+ * Returned Value:
+ *   0 on success or an errno value on failure.
+ *
+ ****************************************************************************/
+
+int pthread_mutex_trylock(FAR pthread_mutex_t *mutex)
+{
+  uint32_t state = MUTEX_UNLOCKED;
+
+  if (mutex == NULL || !pthread_mutex_isfast(mutex))
+    {
+      return nx_pthread_mutex_trylock(mutex);
+    }
+
+  return MUTEX_CAS(mutex, &state, MUTEX_LOCKED) ? OK : EBUSY;
+}
+
+/****************************************************************************
+ * Name: pthread_mutex_unlock
+ *
+ * Description:
+ *   Release the mutex and wake up one thread sleeping on it, if any.
+ *
+ * Input Parameters:
+ *   mutex - A reference to the mutex to be unlocked.
+ *
+ * Returned Value:
+ *   0 on success or an errno value on failure.  The holder of a mutex
+ *   locked in user space is not recorded, so only unlocking an unlocked
+ *   mutex is reported (EPERM).
+ *
+ ****************************************************************************/
+
+int pthread_mutex_unlock(FAR pthread_mutex_t *mutex)
+{
+  uint32_t state;
+
+  if (mutex == NULL || !pthread_mutex_isfast(mutex))
+    {
+      return nx_pthread_mutex_unlock(mutex);
+    }
+
+  state = MUTEX_XCHG(mutex, MUTEX_UNLOCKED, __ATOMIC_RELEASE);
+  if (state == MUTEX_UNLOCKED)
+    {
+      return EPERM;
+    }
+
+  if (state == MUTEX_CONTENDED)
+    {
+      futex_wake(&mutex->futex, 1);
+    }
+
+  return OK;
+}
@@ -40,11 +40,28 @@
 #include <nuttx/config.h>
 
 #include <stdbool.h>
+#include <stdint.h>
+#include <limits.h>
 #include <pthread.h>
 #include <sched.h>
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/pthread.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef CONFIG_PTHREAD_FUTEX
+/* Values of the futex-based once_control */
+
+#  define ONCE_INIT     0  /* init_routine has not been called */
+#  define ONCE_RUNNING  1  /* init_routine is running */
+#  define ONCE_WAITERS  2  /* init_routine is running, threads are waiting */
+#  define ONCE_DONE     3  /* init_routine has completed */
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -78,31 +95,89 @@
 int pthread_once(FAR pthread_once_t *once_control,
                  CODE void (*init_routine)(void))
 {
+#ifdef CONFIG_PTHREAD_FUTEX
+  FAR volatile uint32_t *once = once_control;
+  uint32_t state;
+#endif
+
   /* Sanity checks */
 
-  if (once_control && init_routine)
+  if (once_control == NULL || init_routine == NULL)
     {
-      /* Prohibit pre-emption while we test and set the once_control */
+      /* One of the two arguments is NULL */
+
+      return EINVAL;
+    }
 
-      sched_lock();
-      if (!*once_control)
+#ifdef CONFIG_PTHREAD_FUTEX
+  /* Once the init_routine has completed, this is a single load */
+
+  state = __atomic_load_n(once, __ATOMIC_ACQUIRE);
+  while (state != ONCE_DONE)
+    {
+      if (state == ONCE_INIT)
         {
-          *once_control = true;
+          /* Try to become the thread that runs the init_routine.  On
+           * failure, 'state' is updated with the current value.
+           */
+
+          if (__atomic_compare_exchange_n(once, &state, ONCE_RUNNING, false,
+                                          __ATOMIC_ACQUIRE,
+                                          __ATOMIC_ACQUIRE))
+            {
+              init_routine();
 
-          /* Call the init_routine with pre-emption enabled. */
+              /* Wake up any threads that are waiting for completion */
 
-          sched_unlock();
-          init_routine();
-          return OK;
+              state = __atomic_exchange_n(once, ONCE_DONE,
+                                          __ATOMIC_RELEASE);
+              if (state == ONCE_WAITERS)
+                {
+                  futex_wake(once, INT_MAX);
+                }
+
+              return OK;
+            }
+
+          continue;
+        }
+
+      /* Another thread is running the init_routine.  Let it know that
+       * there are waiters, then sleep until it is done.
+       */
+
+      if (state == ONCE_RUNNING &&
+          !__atomic_compare_exchange_n(once, &state, ONCE_WAITERS, false,
+                                       __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE))
+        {
+          continue;
         }
 
-      /* The init_routine has already been called.  Restore pre-emption and return */
+      futex_wait(once, ONCE_WAITERS, CLOCK_REALTIME, NULL, 0);
+      state = __atomic_load_n(once, __ATOMIC_ACQUIRE);
+    }
+
+  return OK;
+#else
+  /* Prohibit pre-emption while we test and set the once_control */
+
+  sched_lock();
+  if (!*once_control)
+    {
+      *once_control = true;
+
+      /* Call the init_routine with pre-emption enabled. */
 
       sched_unlock();
+      init_routine();
       return OK;
     }
 
-  /* One of the two arguments is NULL */
+  /* The init_routine has already been called.  Restore pre-emption and
+   * return
+   */
 
-  return EINVAL;
+  sched_unlock();
+  return OK;
+#endif
 }
@@ -0,0 +1,376 @@
+/****************************************************************************
+ * libs/libc/pthread/pthread_rwlock_futex.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <limits.h>
+#include <pthread.h>
+#include <errno.h>
+
+#include <nuttx/pthread.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Layout of the futex word */
+
+#define RWLOCK_READERS_MASK  0x0000ffff  /* Number of readers holding lock */
+#define RWLOCK_WRITERS_INC   0x00010000  /* One waiting writer */
+#define RWLOCK_WRITERS_MASK  0x3fff0000  /* Number of waiting writers */
+#define RWLOCK_WAITERS       0x40000000  /* Threads are sleeping on the word */
+#define RWLOCK_WRITER        0x80000000  /* A writer holds the lock */
+
+#define RWLOCK_LOAD(rw) \
+  __atomic_load_n(&(rw)->state, __ATOMIC_RELAXED)
+#define RWLOCK_CAS(rw,o,n) \
+  __atomic_compare_exchange_n(&(rw)->state, (o), (n), false, \
+                              __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: rwlock_wait
+ *
+ * Description:
+ *   Sleep until the futex word no longer holds 'state'.  Every transition
+ *   of the word that may let a sleeper proceed clears RWLOCK_WAITERS and
+ *   wakes all sleepers, so the flag is set here before going to sleep.
+ *
+ * Returned Value:
+ *   Zero (OK) if the caller should re-examine the lock or ETIMEDOUT.
+ *
+ ****************************************************************************/
+
+static int rwlock_wait(FAR pthread_rwlock_t *rw_lock, uint32_t state,
+                       clockid_t clockid, FAR const struct timespec *ts)
+{
+  if ((state & RWLOCK_WAITERS) == 0)
+    {
+      if (!RWLOCK_CAS(rw_lock, &state, state | RWLOCK_WAITERS))
+        {
+          return OK;
+        }
+
+      state |= RWLOCK_WAITERS;
+    }
+
+  /* EAGAIN and EINTR simply cause the caller to try again */
+
+  return futex_wait(&rw_lock->state, state, clockid, ts, 0) == ETIMEDOUT ?
+         ETIMEDOUT : OK;
+}
+
+/****************************************************************************
+ * Name: rwlock_release
+ *
+ * Description:
+ *   Replace the futex word 'state' with 'newstate' and, if the lock became
+ *   available to sleepers, clear RWLOCK_WAITERS and wake them up.
+ *
+ * Returned Value:
+ *   True if the exchange succeeded; otherwise 'state' is updated with the
+ *   current value.
+ *
+ ****************************************************************************/
+
+static bool rwlock_release(FAR pthread_rwlock_t *rw_lock,
+                           FAR uint32_t *state, uint32_t newstate)
+{
+  bool wake = false;
+
+  /* Sleepers may proceed if there is no writer and either there are no
+   * readers (for writers) or no waiting writers (for readers).
+   */
+
+  if ((newstate & (RWLOCK_WAITERS | RWLOCK_WRITER)) == RWLOCK_WAITERS &&
+      ((newstate & RWLOCK_READERS_MASK) == 0 ||
+       (newstate & RWLOCK_WRITERS_MASK) == 0))
+    {
+      newstate &= ~RWLOCK_WAITERS;
+      wake      = true;
+    }
+
+  if (!RWLOCK_CAS(rw_lock, state, newstate))
+    {
+      return false;
+    }
+
+  if (wake)
+    {
+      futex_wake(&rw_lock->state, INT_MAX);
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: tryrdlock
+ ****************************************************************************/
+
+static int tryrdlock(FAR pthread_rwlock_t *rw_lock, FAR uint32_t *state)
+{
+  *state = RWLOCK_LOAD(rw_lock);
+  for (; ; )
+    {
+      /* Waiting writers take precedence over new readers */
+
+      if ((*state & (RWLOCK_WRITER | RWLOCK_WRITERS_MASK)) != 0)
+        {
+          return EBUSY;
+        }
+
+      if ((*state & RWLOCK_READERS_MASK) == RWLOCK_READERS_MASK)
+        {
+          return EAGAIN;
+        }
+
+      if (RWLOCK_CAS(rw_lock, state, *state + 1))
+        {
+          return OK;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: trywrlock
+ *
+ * Description:
+ *   Try to take the lock for writing.  If 'waiting' is true, the caller
+ *   has been counted as a waiting writer and the count is dropped when the
+ *   lock is taken.
+ *
+ ****************************************************************************/
+
+static int trywrlock(FAR pthread_rwlock_t *rw_lock, FAR uint32_t *state,
+                     bool waiting)
+{
+  uint32_t newstate;
+
+  *state = RWLOCK_LOAD(rw_lock);
+  for (; ; )
+    {
+      if ((*state & (RWLOCK_WRITER | RWLOCK_READERS_MASK)) != 0)
+        {
+          return EBUSY;
+        }
+
+      newstate = *state | RWLOCK_WRITER;
+      if (waiting)
+        {
+          newstate -= RWLOCK_WRITERS_INC;
+        }
+
+      if (RWLOCK_CAS(rw_lock, state, newstate))
+        {
+          return OK;
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: pthread_rwlock_init
+ *
+ * Description:
+ *   Initialize a read/write lock.  Attributes are not supported.
+ *
+ ****************************************************************************/
+
+int pthread_rwlock_init(FAR pthread_rwlock_t *lock,
+                        FAR const pthread_rwlockattr_t *attr)
+{
+  if (attr != NULL)
+    {
+      return ENOSYS;
+    }
+
+  lock->state = 0;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: pthread_rwlock_destroy
+ ****************************************************************************/
+
+int pthread_rwlock_destroy(FAR pthread_rwlock_t *lock)
+{
+  return RWLOCK_LOAD(lock) != 0 ? EBUSY : OK;
+}
+
+/****************************************************************************
+ * Name: pthread_rwlock_unlock
+ *
+ * Description:
+ *   Release a read/write lock held for either reading or writing.
+ *
+ ****************************************************************************/
+
+int pthread_rwlock_unlock(FAR pthread_rwlock_t *rw_lock)
+{
+  uint32_t state = RWLOCK_LOAD(rw_lock);
+
+  for (; ; )
+    {
+      if ((state & RWLOCK_WRITER) != 0)
+        {
+          if (rwlock_release(rw_lock, &state, state & ~RWLOCK_WRITER))
+            {
+              return OK;
+            }
+        }
+      else if ((state & RWLOCK_READERS_MASK) != 0)
+        {
+          if (rwlock_release(rw_lock, &state, state - 1))
+            {
+              return OK;
+            }
+        }
+      else
+        {
+          return EINVAL;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: pthread_rwlock_rdlock
+ *
+ * Description:
+ *   Locks a read/write lock for reading
+ *
+ ****************************************************************************/
+
+int pthread_rwlock_tryrdlock(FAR pthread_rwlock_t *rw_lock)
+{
+  uint32_t state;
+
+  return tryrdlock(rw_lock, &state);
+}
+
+int pthread_rwlock_clockrdlock(FAR pthread_rwlock_t *rw_lock,
+                               clockid_t clockid,
+                               FAR const struct timespec *ts)
+{
+  uint32_t state;
+  int err;
+
+  while ((err = tryrdlock(rw_lock, &state)) == EBUSY)
+    {
+      err = rwlock_wait(rw_lock, state, clockid, ts);
+      if (err != 0)
+        {
+          break;
+        }
+    }
+
+  return err;
+}
+
+int pthread_rwlock_timedrdlock(FAR pthread_rwlock_t *rw_lock,
+                               FAR const struct timespec *ts)
+{
+  return pthread_rwlock_clockrdlock(rw_lock, CLOCK_REALTIME, ts);
+}
+
+int pthread_rwlock_rdlock(FAR pthread_rwlock_t *rw_lock)
+{
+  return pthread_rwlock_timedrdlock(rw_lock, NULL);
+}
+
+/****************************************************************************
+ * Name: pthread_rwlock_wrlock
+ *
+ * Description:
+ *   Locks a read/write lock for writing
+ *
+ ****************************************************************************/
+
+int pthread_rwlock_trywrlock(FAR pthread_rwlock_t *rw_lock)
+{
+  uint32_t state;
+
+  return trywrlock(rw_lock, &state, false);
+}
+
+int pthread_rwlock_clockwrlock(FAR pthread_rwlock_t *rw_lock,
+                               clockid_t clockid,
+                               FAR const struct timespec *ts)
+{
+  uint32_t state;
+  int err;
+
+  if (trywrlock(rw_lock, &state, false) == OK)
+    {
+      return OK;
+    }
+
+  /* Register as a waiting writer so that new readers hold off */
+
+  do
+    {
+      if ((state & RWLOCK_WRITERS_MASK) == RWLOCK_WRITERS_MASK)
+        {
+          return EAGAIN;
+        }
+    }
+  while (!RWLOCK_CAS(rw_lock, &state, state + RWLOCK_WRITERS_INC));
+
+  while ((err = trywrlock(rw_lock, &state, true)) == EBUSY)
+    {
+      err = rwlock_wait(rw_lock, state, clockid, ts);
+      if (err != 0)
+        {
+          /* Give up.  Readers blocked only because of us may proceed. */
+
+          state = RWLOCK_LOAD(rw_lock);
+          while (!rwlock_release(rw_lock, &state,
+                                 state - RWLOCK_WRITERS_INC))
+            {
+            }
+
+          break;
+        }
+    }
+
+  return err;
+}
+
+int pthread_rwlock_timedwrlock(FAR pthread_rwlock_t *rw_lock,
+                               FAR const struct timespec *ts)
+{
+  return pthread_rwlock_clockwrlock(rw_lock, CLOCK_REALTIME, ts);
+}
+
+int pthread_rwlock_wrlock(FAR pthread_rwlock_t *rw_lock)
+{
+  return pthread_rwlock_timedwrlock(rw_lock, NULL);
+}
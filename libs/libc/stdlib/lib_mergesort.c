@@ -0,0 +1,387 @@
+/****************************************************************************
+ * libs/libc/stdlib/lib_mergesort.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+
+#include "libc.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Runs of this many elements are sorted with insertion sort before
+ * merging.
+ */
+
+#define MSORT_RUN  8
+
+/* The kernel-side copy of the C library cannot create pthreads */
+
+#if defined(CONFIG_LIBC_MERGESORT_NTHREADS) && !defined(__KERNEL__)
+#  define MSORT_NTHREADS CONFIG_LIBC_MERGESORT_NTHREADS
+#else
+#  define MSORT_NTHREADS 1
+#endif
+
+#ifndef CONFIG_LIBC_MERGESORT_THREAD_MIN
+#  define CONFIG_LIBC_MERGESORT_THREAD_MIN 4096
+#endif
+
+#ifndef MIN
+#  define MIN(a,b) ((a) < (b) ? (a) : (b))
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#if MSORT_NTHREADS > 1
+struct msort_chunk_s
+{
+  FAR char *base;        /* First element of the chunk */
+  FAR char *tmp;         /* Scratch space of the same size */
+  size_t nel;            /* Number of elements in the chunk */
+  size_t width;          /* Size of one element */
+  CODE int (*compar)(FAR const void *, FAR const void *);
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: msort_swap
+ ****************************************************************************/
+
+static void msort_swap(FAR char *a, FAR char *b, size_t width)
+{
+  char t;
+
+  while (width-- > 0)
+    {
+      t    = *a;
+      *a++ = *b;
+      *b++ = t;
+    }
+}
+
+/****************************************************************************
+ * Name: msort_insertion
+ *
+ * Description:
+ *   Stable insertion sort of a short run.
+ *
+ ****************************************************************************/
+
+static void msort_insertion(FAR char *base, size_t nel, size_t width,
+                            CODE int (*compar)(FAR const void *,
+                            FAR const void *))
+{
+  FAR char *pm;
+  FAR char *pl;
+
+  for (pm = base + width; pm < base + nel * width; pm += width)
+    {
+      for (pl = pm; pl > base && compar(pl - width, pl) > 0; pl -= width)
+        {
+          msort_swap(pl, pl - width, width);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: msort_merge
+ *
+ * Description:
+ *   Merge the sorted runs src[lo, mid) and src[mid, hi) into dst[lo, hi).
+ *   On equal keys the element from the left run is taken first, which
+ *   keeps the sort stable.
+ *
+ ****************************************************************************/
+
+static void msort_merge(FAR const char *src, FAR char *dst, size_t lo,
+                        size_t mid, size_t hi, size_t width,
+                        CODE int (*compar)(FAR const void *,
+                        FAR const void *))
+{
+  FAR const char *pl = src + lo * width;
+  FAR const char *el = src + mid * width;
+  FAR const char *pr = el;
+  FAR const char *er = src + hi * width;
+  FAR char *pd = dst + lo * width;
+
+  while (pl < el && pr < er)
+    {
+      if (compar(pl, pr) <= 0)
+        {
+          memcpy(pd, pl, width);
+          pl += width;
+        }
+      else
+        {
+          memcpy(pd, pr, width);
+          pr += width;
+        }
+
+      pd += width;
+    }
+
+  memcpy(pd, pl, el - pl);
+  pd += el - pl;
+  memcpy(pd, pr, er - pr);
+}
+
+/****************************************************************************
+ * Name: msort_passes
+ *
+ * Description:
+ *   Bottom-up merge passes over 'base', where runs of 'run' elements are
+ *   already sorted.  The passes alternate between 'base' and 'tmp'; the
+ *   buffer holding the result is returned.
+ *
+ ****************************************************************************/
+
+static FAR char *msort_passes(FAR char *base, FAR char *tmp, size_t nel,
+                              size_t width, size_t run,
+                              CODE int (*compar)(FAR const void *,
+                              FAR const void *))
+{
+  FAR char *src = base;
+  FAR char *dst = tmp;
+  FAR char *t;
+  size_t w;
+  size_t i;
+
+  for (w = run; w < nel; w *= 2)
+    {
+      for (i = 0; i < nel; i += 2 * w)
+        {
+          msort_merge(src, dst, i, MIN(i + w, nel), MIN(i + 2 * w, nel),
+                      width, compar);
+        }
+
+      t   = src;
+      src = dst;
+      dst = t;
+    }
+
+  return src;
+}
+
+/****************************************************************************
+ * Name: msort_range
+ *
+ * Description:
+ *   Sort 'nel' elements in 'base' using 'tmp' as scratch space.  The result
+ *   is always left in 'base'.
+ *
+ ****************************************************************************/
+
+static void msort_range(FAR char *base, FAR char *tmp, size_t nel,
+                        size_t width, CODE int (*compar)(FAR const void *,
+                        FAR const void *))
+{
+  FAR char *result;
+  size_t i;
+
+  for (i = 0; i < nel; i += MSORT_RUN)
+    {
+      msort_insertion(base + i * width, MIN(MSORT_RUN, nel - i), width,
+                      compar);
+    }
+
+  result = msort_passes(base, tmp, nel, width, MSORT_RUN, compar);
+  if (result != base)
+    {
+      memcpy(base, result, nel * width);
+    }
+}
+
+/****************************************************************************
+ * Name: msort_thread
+ ****************************************************************************/
+
+#if MSORT_NTHREADS > 1
+static FAR void *msort_thread(FAR void *arg)
+{
+  FAR struct msort_chunk_s *chunk = (FAR struct msort_chunk_s *)arg;
+
+  msort_range(chunk->base, chunk->tmp, chunk->nel, chunk->width,
+              chunk->compar);
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: msort_parallel
+ *
+ * Description:
+ *   Split the array into CONFIG_LIBC_MERGESORT_NTHREADS chunks whose size
+ *   is a power-of-two multiple of MSORT_RUN, sort them concurrently and
+ *   then merge the chunks.  A chunk whose thread cannot be created is
+ *   sorted by the caller.
+ *
+ ****************************************************************************/
+
+static void msort_parallel(FAR char *base, FAR char *tmp, size_t nel,
+                           size_t width, CODE int (*compar)(FAR const void *,
+                           FAR const void *))
+{
+  struct msort_chunk_s chunks[MSORT_NTHREADS];
+  pthread_t threads[MSORT_NTHREADS];
+  bool started[MSORT_NTHREADS];
+  FAR char *result;
+  size_t size;
+  size_t off;
+  int n;
+  int i;
+
+  /* Chunk sizes must be a power-of-two multiple of MSORT_RUN so that the
+   * final bottom-up passes line up with the chunk boundaries.
+   */
+
+  size = MSORT_RUN;
+  while (size * MSORT_NTHREADS < nel)
+    {
+      size *= 2;
+    }
+
+  for (n = 0, off = 0; off < nel; n++, off += size)
+    {
+      chunks[n].base   = base + off * width;
+      chunks[n].tmp    = tmp + off * width;
+      chunks[n].nel    = MIN(size, nel - off);
+      chunks[n].width  = width;
+      chunks[n].compar = compar;
+    }
+
+  /* The caller sorts the first chunk itself */
+
+  for (i = 1; i < n; i++)
+    {
+      started[i] = pthread_create(&threads[i], NULL, msort_thread,
+                                  &chunks[i]) == 0;
+    }
+
+  msort_thread(&chunks[0]);
+
+  for (i = 1; i < n; i++)
+    {
+      if (started[i])
+        {
+          pthread_join(threads[i], NULL);
+        }
+      else
+        {
+          msort_thread(&chunks[i]);
+        }
+    }
+
+  result = msort_passes(base, tmp, nel, width, size, compar);
+  if (result != base)
+    {
+      memcpy(base, result, nel * width);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mergesort
+ *
+ * Description:
+ *   The mergesort() function sorts an array of 'nel' objects, the initial
+ *   element of which is pointed to by 'base', in the same way as qsort().
+ *   Unlike qsort(), the sort is stable:  elements that compare as equal
+ *   keep their original relative order.  The worst case is O(n log n)
+ *   comparisons and no recursion is used, but a temporary buffer of
+ *   'nel' * 'width' bytes is allocated.
+ *
+ *   If CONFIG_LIBC_MERGESORT_NTHREADS is greater than one, large arrays
+ *   are split into chunks that are sorted concurrently by that many
+ *   threads.
+ *
+ * Returned Value:
+ *   Zero is returned on success.  Otherwise, -1 is returned and errno is
+ *   set to indicate the error:
+ *
+ *   EINVAL - 'nel' * 'width' overflows size_t.
+ *   ENOMEM - The temporary buffer could not be allocated.
+ *
+ ****************************************************************************/
+
+int mergesort(FAR void *base, size_t nel, size_t width,
+              CODE int (*compar)(FAR const void *, FAR const void *))
+{
+  FAR char *tmp;
+
+  if (nel < 2 || width == 0)
+    {
+      return 0;
+    }
+
+  if (nel > SIZE_MAX / width)
+    {
+      set_errno(EINVAL);
+      return -1;
+    }
+
+  if (nel <= MSORT_RUN)
+    {
+      msort_insertion(base, nel, width, compar);
+      return 0;
+    }
+
+  tmp = lib_malloc(nel * width);
+  if (tmp == NULL)
+    {
+      set_errno(ENOMEM);
+      return -1;
+    }
+
+#if MSORT_NTHREADS > 1
+  if (nel >= CONFIG_LIBC_MERGESORT_THREAD_MIN)
+    {
+      msort_parallel(base, tmp, nel, width, compar);
+    }
+  else
+#endif
+    {
+      msort_range(base, tmp, nel, width, compar);
+    }
+
+  lib_free(tmp);
+  return 0;
+}
@@ -93,6 +93,15 @@ static inline void swapfunc(FAR char *a, FAR char *b, int n, int swaptype);
 static inline FAR char *med3(FAR char *a, FAR char *b, FAR char *c,
                              CODE int (*compar)(FAR const void *,
                              FAR const void *));
+static void siftdown(FAR char *base, size_t root, size_t nel, size_t width,
+                     int swaptype, CODE int (*compar)(FAR const void *,
+                     FAR const void *));
+static void heapsort(FAR char *base, size_t nel, size_t width,
+                     CODE int (*compar)(FAR const void *,
+                     FAR const void *));
+static void introsort(FAR void *base, size_t nel, size_t width,
+                      CODE int (*compar)(FAR const void *,
+                      FAR const void *), int depth);
 
 /****************************************************************************
  * Private Functions
@@ -120,50 +129,97 @@ static inline FAR char *med3(FAR char *a, FAR char *b, FAR char *c,
 }
 
 /****************************************************************************
- * Public Function
+ * Name: siftdown
+ *
+ * Description:
+ *   Move the element at index 'root' down the binary heap of 'nel'
+ *   elements until the max-heap property is restored.
+ *
  ****************************************************************************/
 
+static void siftdown(FAR char *base, size_t root, size_t nel, size_t width,
+                     int swaptype, CODE int (*compar)(FAR const void *,
+                     FAR const void *))
+{
+  FAR char *pr;
+  FAR char *pc;
+  size_t child;
+
+  for (; ; )
+    {
+      child = 2 * root + 1;
+      if (child >= nel)
+        {
+          break;
+        }
+
+      pc = base + child * width;
+      if (child + 1 < nel && compar(pc, pc + width) < 0)
+        {
+          child++;
+          pc += width;
+        }
+
+      pr = base + root * width;
+      if (compar(pr, pc) >= 0)
+        {
+          break;
+        }
+
+      swap(pr, pc);
+      root = child;
+    }
+}
+
 /****************************************************************************
- * Name: qsort
+ * Name: heapsort
  *
  * Description:
- *   The qsort() function will sort an array of 'nel' objects, the initial
- *   element of which is pointed to by 'base'. The size of each object, in
- *   bytes, is specified by the 'width" argument. If the 'nel' argument has
- *   the value zero, the comparison function pointed to by 'compar' will not
- *   be called and no rearrangement will take place.
- *
- *   The application will ensure that the comparison function pointed to by
- *   'compar' does not alter the contents of the array. The implementation
- *   may reorder elements of the array between calls to the comparison
- *   function, but will not alter the contents of any individual element.
- *
- *   When the same objects (consisting of 'width" bytes, irrespective of
- *   their current positions in the array) are passed more than once to
- *   the comparison function, the results will be consistent with one
- *   another. That is, they will define a total ordering on the array.
+ *   Sort the array with heapsort.  This is used by introsort() when the
+ *   partitioning is not making progress so that the worst case stays at
+ *   O(n log n).  It uses no recursion.
  *
- *   The contents of the array will be sorted in ascending order according
- *   to a comparison function. The 'compar' argument is a pointer to the
- *   comparison function, which is called with two arguments that point to
- *   the elements being compared. The application will ensure that the
- *   function returns an integer less than, equal to, or greater than 0,
- *   if the first argument is considered respectively less than, equal to,
- *   or greater than the second. If two members compare as equal, their
- *   order in the sorted array is unspecified.
- *
- *   (Based on description from OpenGroup.org).
- *
- * Returned Value:
- *   The qsort() function will not return a value.
+ ****************************************************************************/
+
+static void heapsort(FAR char *base, size_t nel, size_t width,
+                     CODE int (*compar)(FAR const void *,
+                     FAR const void *))
+{
+  size_t i;
+  int swaptype;
+
+  SWAPINIT(base, width);
+
+  /* Build the heap */
+
+  for (i = nel / 2; i-- > 0; )
+    {
+      siftdown(base, i, nel, width, swaptype, compar);
+    }
+
+  /* Then repeatedly move the largest element to the end */
+
+  for (i = nel - 1; i > 0; i--)
+    {
+      swap(base, base + i * width);
+      siftdown(base, 0, i, width, swaptype, compar);
+    }
+}
+
+/****************************************************************************
+ * Name: introsort
  *
- * Notes from the original BSD version:
- *   Qsort routine from Bentley & McIlroy's "Engineering a Sort Function".
+ * Description:
+ *   Quicksort with a recursion depth limit.  When 'depth' partitioning
+ *   steps have been taken without the sub-array becoming small, the
+ *   remainder is sorted with heapsort.  Only the smaller partition is
+ *   sorted recursively, so the stack depth is bounded by log2(nel).
  *
  ****************************************************************************/
 
-void qsort(FAR void *base, size_t nel, size_t width,
-           CODE int(*compar)(FAR const void *, FAR const void *))
+static void introsort(FAR void *base, size_t nel, size_t width,
+                      CODE int (*compar)(FAR const void *,
+                      FAR const void *), int depth)
 {
   FAR char *pa;
   FAR char *pb;
@@ -172,14 +228,22 @@ void qsort(FAR void *base, size_t nel, size_t width,
   FAR char *pl;
   FAR char *pm;
   FAR char *pn;
+  size_t nl;
+  size_t nr;
   int swaptype;
-  int swap_cnt;
   int d;
   int r;
 
 loop:
   SWAPINIT(base, width);
-  swap_cnt = 0;
+
+  if (nel >= 7 && depth-- <= 0)
+    {
+      /* Too many bad partitions, fall back to heapsort */
+
+      heapsort(base, nel, width, compar);
+      return;
+    }
 
   if (nel < 7)
     {
@@ -224,7 +288,6 @@ loop:
         {
           if (r == 0)
             {
-              swap_cnt = 1;
               swap(pa, pb);
               pa += width;
             }
@@ -236,7 +299,6 @@ loop:
         {
           if (r == 0)
             {
-              swap_cnt = 1;
               swap(pc, pd);
               pd -= width;
             }
@@ -250,28 +312,8 @@ loop:
         }
 
       swap(pb, pc);
-      swap_cnt = 1;
-      pb      += width;
-      pc      -= width;
-    }
-
-  if (swap_cnt == 0)
-    {
-      /* Switch to insertion sort */
-
-      for (pm = (FAR char *)base + width;
-           pm < (FAR char *)base + nel * width;
-           pm += width)
-        {
-          for (pl = pm;
-               pl > (FAR char *)base && compar(pl - width, pl) > 0;
-               pl -= width)
-            {
-              swap(pl, pl - width);
-            }
-        }
-
-      return;
+      pb += width;
+      pc -= width;
     }
 
   pn = (FAR char *)base + nel * width;
@@ -281,17 +323,98 @@ loop:
   r  = min(pd - pc, pn - pd - width);
   vecswap(pb, pn - r, r);
 
-  if ((r = pb - pa) > width)
+  /* Recurse into the smaller partition and iterate on the larger one so
+   * that the recursion depth is at most log2(nel).
+   */
+
+  nl = (pb - pa) / width;
+  nr = (pd - pc) / width;
+
+  if (nl < nr)
     {
-      qsort(base, r / width, width, compar);
-    }
+      if (nl > 1)
+        {
+          introsort(base, nl, width, compar, depth);
+        }
 
-  if ((r = pd - pc) > width)
+      base = pn - nr * width;
+      nel  = nr;
+    }
+  else
     {
-      /* Iterate rather than recurse to save stack space */
+      if (nr > 1)
+        {
+          introsort(pn - nr * width, nr, width, compar, depth);
+        }
+
+      nel  = nl;
+    }
 
-      base = pn - r;
-      nel = r / width;
+  if (nel > 1)
+    {
       goto loop;
     }
 }
+
+/****************************************************************************
+ * Public Function
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: qsort
+ *
+ * Description:
+ *   The qsort() function will sort an array of 'nel' objects, the initial
+ *   element of which is pointed to by 'base'. The size of each object, in
+ *   bytes, is specified by the 'width" argument. If the 'nel' argument has
+ *   the value zero, the comparison function pointed to by 'compar' will not
+ *   be called and no rearrangement will take place.
+ *
+ *   The application will ensure that the comparison function pointed to by
+ *   'compar' does not alter the contents of the array. The implementation
+ *   may reorder elements of the array between calls to the comparison
+ *   function, but will not alter the contents of any individual element.
+ *
+ *   When the same objects (consisting of 'width" bytes, irrespective of
+ *   their current positions in the array) are passed more than once to
+ *   the comparison function, the results will be consistent with one
+ *   another. That is, they will define a total ordering on the array.
+ *
+ *   The contents of the array will be sorted in ascending order according
+ *   to a comparison function. The 'compar' argument is a pointer to the
+ *   comparison function, which is called with two arguments that point to
+ *   the elements being compared. The application will ensure that the
+ *   function returns an integer less than, equal to, or greater than 0,
+ *   if the first argument is considered respectively less than, equal to,
+ *   or greater than the second. If two members compare as equal, their
+ *   order in the sorted array is unspecified.
+ *
+ *   (Based on description from OpenGroup.org).
+ *
+ * Returned Value:
+ *   The qsort() function will not return a value.
+ *
+ * Notes from the original BSD version:
+ *   Qsort routine from Bentley & McIlroy's "Engineering a Sort Function".
+ *
+ *   The recursion depth is limited to 2 * log2(nel) partitioning steps,
+ *   after which heapsort is used (introsort), so the worst case is
+ *   O(n log n) and the stack usage is O(log n).  The original switch to
+ *   insertion sort when a partition step made no swaps was removed since
+ *   it is quadratic on crafted input.
+ *
+ ****************************************************************************/
+
+void qsort(FAR void *base, size_t nel, size_t width,
+           CODE int(*compar)(FAR const void *, FAR const void *))
+{
+  size_t n;
+  int depth = 0;
+
+  for (n = nel; n > 1; n >>= 1)
+    {
+      depth += 2;
+    }
+
+  introsort(base, nel, width, compar, depth);
+}
@@ -39,8 +39,11 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
 #include <string.h>
 
+#include "libc.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -65,6 +68,34 @@ FAR void *memchr(FAR const void *s, int c, size_t n)
 
   if (s)
     {
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+      uintptr_t cw = LIBC_WORD_ONES * (unsigned char)c;
+
+      /* Scan bytes until the pointer is word aligned */
+
+      while (n > 0 && ((uintptr_t)p & LIBC_WORD_MASK) != 0)
+        {
+          if (*p == (unsigned char)c)
+            {
+              return (FAR void *)p;
+            }
+
+          p++;
+          n--;
+        }
+
+      /* XOR-ing with the replicated character turns matching bytes into
+       * zero bytes, so skip whole words that contain no match.
+       */
+
+      while (n >= LIBC_WORD_SIZE &&
+             !LIBC_WORD_HASZERO(*(FAR const uintptr_t *)p ^ cw))
+        {
+          p += LIBC_WORD_SIZE;
+          n -= LIBC_WORD_SIZE;
+        }
+#endif
+
       while (n--)
         {
           if (*p == (unsigned char)c)
@@ -39,8 +39,11 @@
 
 #include <nuttx/config.h>
 #include <sys/types.h>
+#include <stdint.h>
 #include <string.h>
 
+#include "libc.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -54,6 +57,53 @@ FAR void *memcpy(FAR void *dest, FAR const void *src, size_t n)
 {
   FAR unsigned char *pout = (FAR unsigned char *)dest;
   FAR unsigned char *pin  = (FAR unsigned char *)src;
+
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+  /* Word-at-a-time copy is only possible if the source and destination
+   * share the same alignment within a word.
+   */
+
+  if (n >= 2 * LIBC_WORD_SIZE &&
+      (((uintptr_t)pout ^ (uintptr_t)pin) & LIBC_WORD_MASK) == 0)
+    {
+      FAR uintptr_t *wout;
+      FAR const uintptr_t *win;
+
+      /* Copy leading bytes until the pointers are word aligned */
+
+      while (((uintptr_t)pout & LIBC_WORD_MASK) != 0)
+        {
+          *pout++ = *pin++;
+          n--;
+        }
+
+      wout = (FAR uintptr_t *)pout;
+      win  = (FAR const uintptr_t *)pin;
+
+      /* Copy four words per iteration, then any remaining whole words */
+
+      while (n >= 4 * LIBC_WORD_SIZE)
+        {
+          wout[0] = win[0];
+          wout[1] = win[1];
+          wout[2] = win[2];
+          wout[3] = win[3];
+          wout   += 4;
+          win    += 4;
+          n      -= 4 * LIBC_WORD_SIZE;
+        }
+
+      while (n >= LIBC_WORD_SIZE)
+        {
+          *wout++ = *win++;
+          n      -= LIBC_WORD_SIZE;
+        }
+
+      pout = (FAR unsigned char *)wout;
+      pin  = (FAR unsigned char *)win;
+    }
+#endif
+
   while (n-- > 0) *pout++ = *pin++;
   return dest;
 }
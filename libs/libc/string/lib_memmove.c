@@ -39,8 +39,11 @@
 
 #include <nuttx/config.h>
 #include <sys/types.h>
+#include <stdint.h>
 #include <string.h>
 
+#include "libc.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -51,11 +54,42 @@ FAR void *memmove(FAR void *dest, FAR const void *src, size_t count)
   FAR char *tmp;
   FAR char *s;
 
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+  /* Words can be moved only if both pointers share the same alignment */
+
+  bool wordwise = (count >= 2 * LIBC_WORD_SIZE &&
+                   (((uintptr_t)dest ^ (uintptr_t)src) & LIBC_WORD_MASK) == 0);
+#endif
+
   if (dest <= src)
     {
       tmp = (FAR char *) dest;
       s   = (FAR char *) src;
 
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+      if (wordwise)
+        {
+          while (((uintptr_t)tmp & LIBC_WORD_MASK) != 0)
+            {
+              *tmp++ = *s++;
+              count--;
+            }
+
+          /* Copying forward one word at a time is safe even if the regions
+           * overlap, since every source word is read before the
+           * destination catches up with it.
+           */
+
+          while (count >= LIBC_WORD_SIZE)
+            {
+              *(FAR uintptr_t *)tmp = *(FAR const uintptr_t *)s;
+              tmp   += LIBC_WORD_SIZE;
+              s     += LIBC_WORD_SIZE;
+              count -= LIBC_WORD_SIZE;
+            }
+        }
+#endif
+
       while (count--)
         {
           *tmp++ = *s++;
@@ -66,6 +100,25 @@ FAR void *memmove(FAR void *dest, FAR const void *src, size_t count)
       tmp = (FAR char *) dest + count;
       s   = (FAR char *) src + count;
 
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+      if (wordwise)
+        {
+          while (((uintptr_t)tmp & LIBC_WORD_MASK) != 0)
+            {
+              *--tmp = *--s;
+              count--;
+            }
+
+          while (count >= LIBC_WORD_SIZE)
+            {
+              tmp   -= LIBC_WORD_SIZE;
+              s     -= LIBC_WORD_SIZE;
+              count -= LIBC_WORD_SIZE;
+              *(FAR uintptr_t *)tmp = *(FAR const uintptr_t *)s;
+            }
+        }
+#endif
+
       while (count--)
         {
           *--tmp = *--s;
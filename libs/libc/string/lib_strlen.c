@@ -39,8 +39,11 @@
 
 #include <nuttx/config.h>
 #include <sys/types.h>
+#include <stdint.h>
 #include <string.h>
 
+#include "libc.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -49,7 +52,32 @@
 size_t strlen(const char *s)
 {
   const char *sc;
-  for (sc = s; *sc != '\0'; ++sc);
+
+#ifdef CONFIG_LIBC_STRING_OPTSPEED
+  FAR const uintptr_t *ws;
+
+  /* Scan bytes until the pointer is word aligned */
+
+  for (sc = s; ((uintptr_t)sc & LIBC_WORD_MASK) != 0; ++sc)
+    {
+      if (*sc == '\0')
+        {
+          return sc - s;
+        }
+    }
+
+  /* Then scan a word at a time until some byte in the word is zero.  An
+   * aligned word never straddles a page boundary, so reading past the
+   * terminator within the final word is harmless.
+   */
+
+  for (ws = (FAR const uintptr_t *)sc; !LIBC_WORD_HASZERO(*ws); ws++);
+  sc = (FAR const char *)ws;
+#else
+  sc = s;
+#endif
+
+  for (; *sc != '\0'; ++sc);
   return sc - s;
 }
 #endif
@@ -0,0 +1,544 @@
+/****************************************************************************
+ * libs/libdsp/lib_observer_b16.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <dspb16.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define ANGLE_DIFF_THR (b16PI)
+
+/* SMO gains and filters limits */
+
+#define SMO_G_MAX       (0x0000ffbe)   /* 0.999 */
+#define SMO_FILTER_MAX  (0x0000fd71)   /* 0.99 */
+#define SMO_FILTER_MIN  (0x00000148)   /* 0.005 */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: motor_observer_init_b16
+ *
+ * Description:
+ *   Initialize motor observer
+ *
+ * Input Parameters:
+ *   observer - pointer to the common observer data
+ *   ao       - pointer to the angle specific observer data
+ *   so       - pointer to the speed specific observer data
+ *   per      - observer execution period
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void motor_observer_init_b16(FAR struct motor_observer_b16_s *observer,
+                             FAR void *ao, FAR void *so, b16_t per)
+{
+  DEBUGASSERT(observer != NULL);
+  DEBUGASSERT(ao != NULL);
+  DEBUGASSERT(so != NULL);
+  DEBUGASSERT(per > 0);
+
+  /* Reset observer data */
+
+  memset(observer, 0, sizeof(struct motor_observer_b16_s));
+
+  /* Set observer period */
+
+  observer->per = per;
+
+  /* Connect angle estimation observer data */
+
+  observer->ao = ao;
+
+  /* Connect speed estimation observer data */
+
+  observer->so = so;
+}
+
+/****************************************************************************
+ * Name: motor_observer_smo_init_b16
+ *
+ * Description:
+ *   Initialize motor sliding mode observer.
+ *
+ * Input Parameters:
+ *   smo     - pointer to the sliding mode observer private data
+ *   kslide  - SMO gain
+ *   err_max - linear region upper limit
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void motor_observer_smo_init_b16(FAR struct motor_observer_smo_b16_s *smo,
+                                 b16_t kslide,
+                                 b16_t err_max)
+{
+  DEBUGASSERT(smo != NULL);
+  DEBUGASSERT(kslide > 0);
+  DEBUGASSERT(err_max > 0);
+
+  /* Reset structure */
+
+  memset(smo, 0, sizeof(struct motor_observer_smo_b16_s));
+
+  /* Initialize structure */
+
+  smo->k_slide = kslide;
+  smo->err_max = err_max;
+}
+
+/****************************************************************************
+ * Name: motor_observer_smo_b16
+ *
+ * Description:
+ *  One step of the SMO observer.
+ *  REFERENCE: http://ww1.microchip.com/downloads/en/AppNotes/01078B.pdf
+ *
+ *  Below some theoretical backgrounds about SMO.
+ *
+ *  The digitalized motor model can be represent as:
+ *
+ *    d(i_s.)/dt = (-R/L)*i_s. + (1/L)*(v_s - e_s. - z)
+ *
+ *  We compare estimated current (i_s.) with measured current (i_s):
+ *
+ *    err = i_s. - i_s
+ *
+ *  and get correction factor (z):
+ *
+ *    sign = sing(err)
+ *    z = sign*K_SLIDE
+ *
+ *  Once the digitalized model is compensated, we estimate BEMF (e_s.) by
+ *  filtering z:
+ *
+ *    e_s. = low_pass(z)
+ *
+ *  The estimated BEMF is filtered once again and used to approximate the
+ *  motor angle:
+ *
+ *    e_filtered_s. = low_pass(e_s.)
+ *    theta = arctan(-e_alpha/e_beta)
+ *
+ *  The estimated theta is phase-shifted due to low pass filtration, so we
+ *  need some phase compensation. More details below.
+ *
+ *  where:
+ *    v_s  - phase input voltage vector
+ *    i_s. - estimated phase current vector
+ *    i_s  - phase current vector
+ *    e_s. - estimated phase BEMF vector
+ *    R    - motor winding resistance
+ *    L    - motor winding inductance
+ *    z    - output correction factor voltage
+ *
+ * Input Parameters:
+ *   o      - (in/out) pointer to the common observer data
+ *   i_ab   - (in) inverter alpha-beta current
+ *   v_ab   - (in) inverter alpha-beta voltage
+ *   phy    - (in) pointer to the motor physical parameters
+ *   dir    - (in) rotation direction (1.0 for CW, -1.0 for CCW)
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void motor_observer_smo_b16(FAR struct motor_observer_b16_s *o,
+                            FAR ab_frame_b16_t *i_ab,
+                            FAR ab_frame_b16_t *v_ab,
+                            FAR struct motor_phy_params_b16_s *phy,
+                            b16_t dir)
+{
+  DEBUGASSERT(o != NULL);
+  DEBUGASSERT(i_ab != NULL);
+  DEBUGASSERT(v_ab != NULL);
+  DEBUGASSERT(phy != NULL);
+
+  FAR struct motor_observer_smo_b16_s *smo =
+    (FAR struct motor_observer_smo_b16_s *)o->ao;
+  FAR ab_frame_b16_t *emf    = &smo->emf;
+  FAR ab_frame_b16_t *emf_f  = &smo->emf_f;
+  FAR ab_frame_b16_t *z      = &smo->z;
+  FAR ab_frame_b16_t *i_est  = &smo->i_est;
+  FAR ab_frame_b16_t *v_err  = &smo->v_err;
+  FAR ab_frame_b16_t *i_err  = &smo->i_err;
+  FAR ab_frame_b16_t *sign   = &smo->sign;
+  b16_t i_err_a_abs  = 0;
+  b16_t i_err_b_abs  = 0;
+  b16_t angle        = 0;
+  b16_t filter       = 0;
+
+  /* REVISIT: observer works only when IQ current is high enough */
+
+  /* Calculate observer gains */
+
+  smo->F = (b16ONE - b16mulb16(o->per,
+                               b16mulb16(phy->res, phy->one_by_ind)));
+  smo->G = b16mulb16(o->per, phy->one_by_ind);
+
+  /* Saturate F gain */
+
+  if (smo->F < 0)
+    {
+      smo->F = 0;
+    }
+
+  /* Saturate G gain */
+
+  if (smo->G > SMO_G_MAX)
+    {
+      smo->G = SMO_G_MAX;
+    }
+
+  /* Configure low pass filters
+   *
+   * We tune low-pass filters to achieve cutoff frequency equal to
+   * input singal frequency. This gives us constant phase shift between
+   * input and outpu signals equals to:
+   *
+   *   phi = -arctan(f_in/f_c) = -arctan(1) = -45deg = -PI/4
+   *
+   * Input signal frequency is equal to the frequency of the motor currents,
+   * which give us:
+   *
+   *   f_c = omega_e/(2*PI)
+   *   omega_m = omega_e/pole_pairs
+   *   f_c = omega_m*pole_pairs/(2*PI)
+   *
+   *   filter = T * (2*PI) * f_c
+   *   filter = T * omega_m * pole_pairs
+   *
+   *   T          - [s] period at which the digital filter is being
+   *                calculated
+   *   f_in       - [Hz] input frequency of the filter
+   *   f_c        - [Hz] cutoff frequency of the filter
+   *   omega_m    - [rad/s] mechanical angular velocity
+   *   omega_e    - [rad/s] electrical angular velocity
+   *   pole_pairs - pole pairs
+   *
+   */
+
+  filter = b16muli(b16mulb16(o->per, o->speed), phy->p);
+
+  /* Limit SMO filters
+   * REVISIT: lowest filter limit should depend on minimum speed:
+   *          filter = T * (2*PI) * f_c = T * omega0
+   *
+   */
+
+  if (filter >= b16ONE)
+    {
+      filter = SMO_FILTER_MAX;
+    }
+  else if (filter <= 0)
+    {
+      filter = SMO_FILTER_MIN;
+    }
+
+  smo->emf_lp_filter1 = filter;
+  smo->emf_lp_filter2 = smo->emf_lp_filter1;
+
+  /* Get voltage error: v_err = v_ab - emf */
+
+  v_err->a = v_ab->a - emf->a;
+  v_err->b = v_ab->b - emf->b;
+
+  /* Estimate stator current */
+
+  i_est->a = b16mulb16(smo->F, i_est->a) +
+             b16mulb16(smo->G, v_err->a - z->a);
+  i_est->b = b16mulb16(smo->F, i_est->b) +
+             b16mulb16(smo->G, v_err->b - z->b);
+
+  /* Get motor current error */
+
+  i_err->a = i_ab->a - i_est->a;
+  i_err->b = i_ab->b - i_est->b;
+
+  /* Slide-mode controller */
+
+  sign->a = (i_err->a > 0 ? b16ONE : -b16ONE);
+  sign->b = (i_err->b > 0 ? b16ONE : -b16ONE);
+
+  /* Get current error absolute value - just multiply value with its sign */
+
+  i_err_a_abs = b16mulb16(i_err->a, sign->a);
+  i_err_b_abs = b16mulb16(i_err->b, sign->b);
+
+  /* Calculate new output correction factor voltage */
+
+  if (i_err_a_abs < smo->err_max)
+    {
+      /* Enter linear region if error is small enough */
+
+      z->a = b16divb16(b16mulb16(i_err->a, smo->k_slide),
+                       smo->err_max);
+    }
+  else
+    {
+      /* Non-linear region */
+
+      z->a = b16mulb16(sign->a, smo->k_slide);
+    }
+
+  if (i_err_b_abs < smo->err_max)
+    {
+      /* Enter linear region if error is small enough */
+
+      z->b = b16divb16(b16mulb16(i_err->b, smo->k_slide),
+                       smo->err_max);
+    }
+  else
+    {
+      /* Non-linear region */
+
+      z->b = b16mulb16(sign->b, smo->k_slide);
+    }
+
+  /* Filter z to obtain estimated emf */
+
+  LP_FILTER_B16(emf->a, z->a, smo->emf_lp_filter1);
+  LP_FILTER_B16(emf->b, z->b, smo->emf_lp_filter1);
+
+  /* Filter emf one more time before angle stimation */
+
+  LP_FILTER_B16(emf_f->a, emf->a, smo->emf_lp_filter2);
+  LP_FILTER_B16(emf_f->b, emf->b, smo->emf_lp_filter2);
+
+  /* Estimate phase angle according to:
+   *   emf_a = -|emf| * sin(th)
+   *   emf_b =  |emf| * cos(th)
+   *   th = atan2(-emf_a, emf->b)
+   */
+
+  angle = fast_atan2_b16(-emf->a, emf->b);
+
+  /* Angle compensation.
+   * Due to low pass filtering we have some delay in estimated phase angle.
+   *
+   * Adaptive filters introduced above cause -PI/4 phase shift for each
+   * filter. We use 2 times filtering which give us constant -PI/2 (-90deg)
+   * phase shift.
+   */
+
+  angle = angle + b16mulb16(dir, b16HALFPI);
+
+  /* Normalize angle to range <0, 2PI> */
+
+  angle_norm_2pi_b16(&angle, 0, b16TWOPI);
+
+  /* Store estimated angle in observer data */
+
+  o->angle = angle;
+}
+
+/****************************************************************************
+ * Name: motor_sobserver_div_init_b16
+ *
+ * Description:
+ *   Initialize DIV speed observer
+ *
+ * Input Parameters:
+ *   so     - (in/out) pointer to the DIV speed observer data
+ *   sample - (in) number of mechanical angle samples
+ *   filter - (in) low-pass filter for final omega
+ *   per    - (in) speed observer execution period
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void motor_sobserver_div_init_b16(FAR struct motor_sobserver_div_b16_s *so,
+                                  uint8_t samples,
+                                  b16_t filter,
+                                  b16_t per)
+{
+  DEBUGASSERT(so != NULL);
+  DEBUGASSERT(samples > 0);
+  DEBUGASSERT(filter > 0);
+
+  /* Reset observer data */
+
+  memset(so, 0, sizeof(struct motor_sobserver_div_b16_s));
+
+  /* Store number of samples for DIV observer */
+
+  so->samples = samples;
+
+  /* Store low-pass filter for DIV observer speed */
+
+  so->filter  = filter;
+
+  /*  */
+
+  so->one_by_dt = b16divb16(b16ONE, b16muli(per, so->samples));
+}
+
+/****************************************************************************
+ * Name: motor_sobserver_div_b16
+ *
+ * Description:
+ *   Estimate motor mechanical speed based on motor mechanical angle
+ *   difference.
+ *
+ * Input Parameters:
+ *   o      - (in/out) pointer to the common observer data
+ *   angle  - (in) mechanical angle normalized to <0.0, 2PI>
+ *   dir    - (in) mechanical rotation direction. Valid values:
+ *                 DIR_CW_B16 or DIR_CCW_B16
+ *
+ ****************************************************************************/
+
+void motor_sobserver_div_b16(FAR struct motor_observer_b16_s *o,
+                             b16_t angle, b16_t dir)
+{
+  DEBUGASSERT(o != NULL);
+  DEBUGASSERT(angle >= 0 && angle <= b16TWOPI);
+  DEBUGASSERT(dir == DIR_CW_B16 || dir == DIR_CCW_B16);
+
+  FAR struct motor_sobserver_div_b16_s *so =
+    (FAR struct motor_sobserver_div_b16_s *)o->so;
+  volatile b16_t omega = 0;
+
+  /* Get angle diff */
+
+  so->angle_diff = angle - so->angle_prev;
+
+  /* Correct angle if we crossed angle boundary
+   * REVISIT:
+   */
+
+  if ((dir == DIR_CW_B16 && so->angle_diff < -ANGLE_DIFF_THR) ||
+      (dir == DIR_CCW_B16 && so->angle_diff > ANGLE_DIFF_THR))
+    {
+      /* Correction sign depends on rotation direction */
+
+      so->angle_diff += b16mulb16(dir, b16TWOPI);
+    }
+
+  /* Get absoulte value */
+
+  if (so->angle_diff < 0)
+    {
+      so->angle_diff = -so->angle_diff;
+    }
+
+  /* Accumulate angle only if sample is valid */
+
+  so->angle_acc += so->angle_diff;
+
+  /* Increase counter */
+
+  so->cntr += 1;
+
+  /* Accumulate angle until we get configured number of samples */
+
+  if (so->cntr >= so->samples)
+    {
+      /* Estimate omega using accumulated angle samples.
+       * In this case use simple estimation:
+       *
+       *   omega = delta_theta/delta_time
+       *   speed_now = low_pass(omega)
+       *
+       */
+
+      omega = b16mulb16(so->angle_acc, so->one_by_dt);
+
+      /* Store filtered omega.
+       *
+       * REVISIT: cut-off frequency for this filter should be
+       *          (probably) set according to minimum supported omega:
+       *
+       *          filter = T * (2*PI) * f_c = T * omega0
+       *
+       *          where:
+       *             omega0 - minimum angular speed
+       *             T      - speed estimation period (samples*one_by_dt)
+       */
+
+      LP_FILTER_B16(o->speed, omega, so->filter);
+
+      /* Reset samples counter and accumulated angle */
+
+      so->cntr = 0;
+      so->angle_acc = 0;
+    }
+
+  /* Store current angle as previous angle */
+
+  so->angle_prev = angle;
+}
+
+/****************************************************************************
+ * Name: motor_observer_speed_get_b16
+ *
+ * Description:
+ *   Get the estmiated motor mechanical speed from the observer
+ *
+ * Input Parameters:
+ *   o      - (in/out) pointer to the common observer data
+ *
+ * Returned Value:
+ *   Return estimated motor mechanical speed from observer
+ *
+ ****************************************************************************/
+
+b16_t motor_observer_speed_get_b16(FAR struct motor_observer_b16_s *o)
+{
+  DEBUGASSERT(o != NULL);
+
+  return o->speed;
+}
+
+/****************************************************************************
+ * Name: motor_observer_angle_get_b16
+ *
+ * Description:
+ *   Get the estmiated motor electrical angle from the observer
+ *
+ * Input Parameters:
+ *   o      - (in/out) pointer to the common observer data
+ *
+ * Returned Value:
+ *   Return estimated motor mechanical angle from observer
+ *
+ ****************************************************************************/
+
+b16_t motor_observer_angle_get_b16(FAR struct motor_observer_b16_s *o)
+{
+  DEBUGASSERT(o != NULL);
+
+  return o->angle;
+}
@@ -53,6 +53,7 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <queue.h>
 #include <errno.h>
 
@@ -364,12 +365,45 @@ int arp_find(in_addr_t ipaddr, FAR struct ether_addr *ethaddr);
  * Input Parameters:
  *   ipaddr - Refers to an IP address in network order
  *
+ * Returned Value:
+ *   Zero (OK) if the entry was removed; -ENOENT if there is no valid entry
+ *   for the address.
+ *
  * Assumptions
  *   The network is locked to assure exclusive access to the ARP table.
  *
  ****************************************************************************/
 
-void arp_delete(in_addr_t ipaddr);
+int arp_delete(in_addr_t ipaddr);
+
+/****************************************************************************
+ * Name: arp_suppress
+ *
+ * Description:
+ *   Called when there is no ARP table entry for an outgoing packet.  This
+ *   consults the negative cache of addresses that recently failed to
+ *   resolve so that a burst of packets to an unreachable host does not
+ *   generate a burst of ARP requests.
+ *
+ * Input Parameters:
+ *   ipaddr - Refers to an IP address in network order
+ *
+ * Returned Value:
+ *   True if an ARP request for the address was sent less than
+ *   CONFIG_NET_ARP_NEGCACHE_MSEC ago and the packet should be dropped.
+ *   Otherwise, the time of the request about to be sent is recorded and
+ *   false is returned.
+ *
+ * Assumptions
+ *   The network is locked to assure exclusive access to the ARP table.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_ARP_NEGCACHE_MSEC > 0
+bool arp_suppress(in_addr_t ipaddr);
+#else
+#  define arp_suppress(i) (false)
+#endif
 
 /****************************************************************************
  * Name: arp_update
@@ -474,7 +508,8 @@ void arp_dump(FAR struct arp_hdr_s *arp);
 #  define arp_wait(n,t) (0)
 #  define arp_notify(i)
 #  define arp_find(i,e) (-ENOSYS)
-#  define arp_delete(i)
+#  define arp_delete(i) (-ENOSYS)
+#  define arp_suppress(i) (false)
 #  define arp_update(i,m);
 #  define arp_hdr_update(i,m);
 #  define arp_snapshot(s,n) (0)
@@ -255,6 +255,18 @@ void arp_out(FAR struct net_driver_s *dev)
   ret = arp_find(ipaddr, &ethaddr);
   if (ret < 0)
     {
+      /* If a request for this address was sent very recently, just drop
+       * the packet rather than flood the network with ARP requests.
+       */
+
+      if (arp_suppress(ipaddr))
+        {
+          ninfo("ARP request for IP %08lx suppressed\n",
+                (unsigned long)ipaddr);
+          dev->d_len = 0;
+          return;
+        }
+
       ninfo("ARP request for IP %08lx\n", (unsigned long)ipaddr);
 
       /* The destination address was not in our ARP table, so we overwrite
@@ -48,6 +48,8 @@
 
 #include <sys/ioctl.h>
 #include <stdint.h>
+#include <stdbool.h>
+#include <queue.h>
 #include <string.h>
 #include <debug.h>
 
@@ -55,6 +57,7 @@
 #include <net/ethernet.h>
 
 #include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
@@ -70,7 +73,27 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+#ifndef CONFIG_NET_ARPTAB_ALLOC
+#  define CONFIG_NET_ARPTAB_ALLOC 0
+#endif
+
+#ifndef CONFIG_NET_ARP_HASHBITS
+#  define CONFIG_NET_ARP_HASHBITS 4
+#endif
+
+#ifndef CONFIG_NET_ARP_NEGCACHE_MSEC
+#  define CONFIG_NET_ARP_NEGCACHE_MSEC 0
+#endif
+
 #define ARP_MAXAGE_TICK SEC2TICK(10 * CONFIG_NET_ARP_MAXAGE)
+#define ARP_NEGAGE_TICK MSEC2TICK(CONFIG_NET_ARP_NEGCACHE_MSEC)
+
+#define ARP_HASHSIZE    (1 << CONFIG_NET_ARP_HASHBITS)
+#define ARP_HASHMASK    (ARP_HASHSIZE - 1)
+
+/* Entry flags */
+
+#define ARP_INCOMPLETE  (1 << 0) /* Negative entry: request outstanding */
 
 /****************************************************************************
  * Private Types
@@ -82,13 +105,50 @@ struct arp_table_info_s
   FAR struct ether_addr *ai_ethaddr;  /* Location to return the MAC address */
 };
 
+/* Each ARP table entry is on a hash chain for lookup and on a list in
+ * order of last update.  Because all entries on a list share the same
+ * lifetime, the list is also in order of expiry:  the head of the list is
+ * always the next entry to expire (or a free entry).  Negative entries
+ * have a shorter lifetime and are kept on a list of their own so that
+ * unresolved addresses never push out valid mappings.
+ */
+
+struct arp_node_s
+{
+  dq_entry_t             an_lru;      /* Link in the LRU list (must be first) */
+  FAR struct arp_node_s *an_hnext;    /* Next entry in the same hash bucket */
+  struct arp_entry_s     an_entry;    /* The ARP table entry */
+  uint8_t                an_flags;    /* See ARP_* entry flags */
+};
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
-/* The table of known address mappings */
+/* The pre-allocated table of known address mappings */
+
+static struct arp_node_s g_arptable[CONFIG_NET_ARPTAB_SIZE];
 
-static struct arp_entry_s g_arptable[CONFIG_NET_ARPTAB_SIZE];
+/* Hash index into the table, keyed on the IPv4 address */
+
+static FAR struct arp_node_s *g_arphash[ARP_HASHSIZE];
+
+/* All table entries, least recently updated (or free) first */
+
+static dq_queue_t g_arplru;
+static bool g_arpinit;
+
+#if CONFIG_NET_ARP_NEGCACHE_MSEC > 0
+/* Negative entries, least recently updated first */
+
+static dq_queue_t g_arpneg;
+#endif
+
+#if CONFIG_NET_ARPTAB_ALLOC > 0
+/* The number of entries allocated beyond CONFIG_NET_ARPTAB_SIZE */
+
+static unsigned int g_arpnalloc;
+#endif
 
 /****************************************************************************
  * Private Functions
@@ -141,32 +201,260 @@ static int arp_match(FAR struct net_driver_s *dev, FAR void *arg)
 }
 
 /****************************************************************************
- * Name: arp_return_old_entry
+ * Name: arp_initialize
  *
  * Description:
- *   Compare and return the old ARP table entry.
+ *   Put all of the pre-allocated entries on the LRU list on first use.
  *
  ****************************************************************************/
 
-static FAR struct arp_entry_s *
-arp_return_old_entry(FAR struct arp_entry_s *e1, FAR struct arp_entry_s *e2)
+static void arp_initialize(void)
 {
-  if (e1->at_ipaddr == 0)
+  int i;
+
+  if (!g_arpinit)
     {
-      return e1;
+      dq_init(&g_arplru);
+#if CONFIG_NET_ARP_NEGCACHE_MSEC > 0
+      dq_init(&g_arpneg);
+#endif
+
+      for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; i++)
+        {
+          dq_addlast(&g_arptable[i].an_lru, &g_arplru);
+        }
+
+      g_arpinit = true;
     }
-  else if (e2->at_ipaddr == 0)
+}
+
+/****************************************************************************
+ * Name: arp_hash
+ *
+ * Description:
+ *   Fold an IPv4 address into a hash bucket index.
+ *
+ ****************************************************************************/
+
+static inline unsigned int arp_hash(in_addr_t ipaddr)
+{
+  uint32_t hash = (uint32_t)ipaddr;
+
+  hash ^= hash >> 16;
+  hash ^= hash >> 8;
+  return hash & ARP_HASHMASK;
+}
+
+/****************************************************************************
+ * Name: arp_expired
+ *
+ * Description:
+ *   Return true if the entry is free or has aged out.
+ *
+ ****************************************************************************/
+
+static bool arp_expired(FAR struct arp_node_s *node, clock_t now)
+{
+  if (node->an_entry.at_ipaddr == 0)
     {
-      return e2;
+      return true;
     }
-  else if ((int)(e1->at_time - e2->at_time) <= 0)
+
+  if ((node->an_flags & ARP_INCOMPLETE) != 0)
     {
-      return e1;
+      return now - node->an_entry.at_time > ARP_NEGAGE_TICK;
     }
-  else
+
+  return now - node->an_entry.at_time > ARP_MAXAGE_TICK;
+}
+
+/****************************************************************************
+ * Name: arp_findnode
+ *
+ * Description:
+ *   Return the table entry (valid, expired or incomplete) for the IPv4
+ *   address, or NULL if there is none.
+ *
+ ****************************************************************************/
+
+static FAR struct arp_node_s *arp_findnode(in_addr_t ipaddr)
+{
+  FAR struct arp_node_s *node;
+
+  if (ipaddr == 0)
+    {
+      return NULL;
+    }
+
+  for (node = g_arphash[arp_hash(ipaddr)]; node != NULL;
+       node = node->an_hnext)
+    {
+      if (net_ipv4addr_cmp(node->an_entry.at_ipaddr, ipaddr))
+        {
+          return node;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: arp_unhash
+ *
+ * Description:
+ *   Remove an entry from its hash chain and mark it free.
+ *
+ ****************************************************************************/
+
+static void arp_unhash(FAR struct arp_node_s *node)
+{
+  FAR struct arp_node_s **pp;
+
+  for (pp = &g_arphash[arp_hash(node->an_entry.at_ipaddr)]; *pp != NULL;
+       pp = &(*pp)->an_hnext)
+    {
+      if (*pp == node)
+        {
+          *pp = node->an_hnext;
+          break;
+        }
+    }
+
+  node->an_hnext           = NULL;
+  node->an_entry.at_ipaddr = 0;
+  node->an_flags           = 0;
+}
+
+/****************************************************************************
+ * Name: arp_list
+ *
+ * Description:
+ *   Return the list that holds the entry:  Negative entries are on their
+ *   own list, all others (including free entries) are on the LRU list.
+ *
+ ****************************************************************************/
+
+static FAR dq_queue_t *arp_list(FAR struct arp_node_s *node)
+{
+#if CONFIG_NET_ARP_NEGCACHE_MSEC > 0
+  if ((node->an_flags & ARP_INCOMPLETE) != 0)
+    {
+      return &g_arpneg;
+    }
+#endif
+
+  return &g_arplru;
+}
+
+/****************************************************************************
+ * Name: arp_requeue
+ *
+ * Description:
+ *   Set the flags of an updated entry and move it to the tail of the list
+ *   for its new kind.
+ *
+ ****************************************************************************/
+
+static void arp_requeue(FAR struct arp_node_s *node, uint8_t flags)
+{
+  dq_rem(&node->an_lru, arp_list(node));
+  node->an_flags = flags;
+  dq_addlast(&node->an_lru, arp_list(node));
+}
+
+/****************************************************************************
+ * Name: arp_victim
+ *
+ * Description:
+ *   Select the entry to re-use for a new IPv4 address.  In order of
+ *   preference, this is a free or expired entry, an expired negative
+ *   entry, a newly allocated entry if the table may still grow, the least
+ *   recently updated negative entry and, only if there is nothing else,
+ *   the least recently updated valid entry.
+ *
+ ****************************************************************************/
+
+static FAR struct arp_node_s *arp_victim(clock_t now)
+{
+  FAR struct arp_node_s *node;
+#if CONFIG_NET_ARP_NEGCACHE_MSEC > 0
+  FAR struct arp_node_s *neg;
+#endif
+
+  node = (FAR struct arp_node_s *)dq_peek(&g_arplru);
+  if (node != NULL && arp_expired(node, now))
+    {
+      return node;
+    }
+
+#if CONFIG_NET_ARP_NEGCACHE_MSEC > 0
+  neg = (FAR struct arp_node_s *)dq_peek(&g_arpneg);
+  if (neg != NULL && arp_expired(neg, now))
+    {
+      return neg;
+    }
+#endif
+
+#if CONFIG_NET_ARPTAB_ALLOC > 0
+  if (g_arpnalloc < CONFIG_NET_ARPTAB_ALLOC)
+    {
+      FAR struct arp_node_s *newnode;
+
+      newnode = (FAR struct arp_node_s *)
+        kmm_zalloc(sizeof(struct arp_node_s));
+      if (newnode != NULL)
+        {
+          dq_addfirst(&newnode->an_lru, &g_arplru);
+          g_arpnalloc++;
+          return newnode;
+        }
+    }
+#endif
+
+#if CONFIG_NET_ARP_NEGCACHE_MSEC > 0
+  /* The LRU list may be empty if all entries are negative */
+
+  if (neg != NULL)
     {
-      return e2;
+      return neg;
     }
+#endif
+
+  return node;
+}
+
+/****************************************************************************
+ * Name: arp_allocnode
+ *
+ * Description:
+ *   Get an entry for a new IPv4 address.  The entry is returned in the
+ *   hash chain for the address and at the tail of the list for its kind,
+ *   with only the IP address and 'flags' set.
+ *
+ ****************************************************************************/
+
+static FAR struct arp_node_s *arp_allocnode(in_addr_t ipaddr, clock_t now,
+                                            uint8_t flags)
+{
+  FAR struct arp_node_s *node;
+  unsigned int hash;
+
+  node = arp_victim(now);
+  dq_rem(&node->an_lru, arp_list(node));
+
+  if (node->an_entry.at_ipaddr != 0)
+    {
+      arp_unhash(node);
+    }
+
+  hash                     = arp_hash(ipaddr);
+  node->an_entry.at_ipaddr = ipaddr;
+  node->an_hnext           = g_arphash[hash];
+  node->an_flags           = flags;
+  g_arphash[hash]          = node;
+
+  dq_addlast(&node->an_lru, arp_list(node));
+  return node;
 }
 
 /****************************************************************************
@@ -195,43 +483,30 @@ arp_return_old_entry(FAR struct arp_entry_s *e1, FAR struct arp_entry_s *e2)
 
 int arp_update(in_addr_t ipaddr, FAR uint8_t *ethaddr)
 {
-  FAR struct arp_entry_s *tabptr = &g_arptable[0];
-  int i;
+  FAR struct arp_node_s *node;
+  clock_t now = clock_systime_ticks();
+
+  arp_initialize();
 
-  /* Walk through the ARP mapping table and try to find an entry to
-   * update. If none is found, the IP -> MAC address mapping is
-   * inserted in the ARP table.
+  /* Find the existing entry for this address.  If there is none, re-use
+   * the least valuable entry.
    */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  node = arp_findnode(ipaddr);
+  if (node == NULL)
     {
-      /* Check if the source IP address of the incoming packet matches
-       * the IP address in this ARP table entry.
-       */
-
-      if (g_arptable[i].at_ipaddr != 0 &&
-          net_ipv4addr_cmp(ipaddr, g_arptable[i].at_ipaddr))
-        {
-          /* An old entry found, break. */
-
-          tabptr = &g_arptable[i];
-          break;
-        }
-      else
-        {
-          /* Record the oldest entry. */
-
-          tabptr = arp_return_old_entry(tabptr, &g_arptable[i]);
-        }
+      node = arp_allocnode(ipaddr, now, 0);
     }
+  else
+    {
+      /* Move the refreshed entry to the end of the LRU list */
 
-  /* Now, tabptr is the ARP table entry which we will fill with the new
-   * information.
-   */
+      arp_requeue(node, node->an_flags & ~ARP_INCOMPLETE);
+    }
 
-  tabptr->at_ipaddr = ipaddr;
-  memcpy(tabptr->at_ethaddr.ether_addr_octet, ethaddr, ETHER_ADDR_LEN);
-  tabptr->at_time = clock_systime_ticks();
+  memcpy(node->an_entry.at_ethaddr.ether_addr_octet, ethaddr,
+         ETHER_ADDR_LEN);
+  node->an_entry.at_time = now;
   return OK;
 }
 
@@ -281,19 +556,15 @@ void arp_hdr_update(FAR uint16_t *pipaddr, FAR uint8_t *ethaddr)
 
 FAR struct arp_entry_s *arp_lookup(in_addr_t ipaddr)
 {
-  FAR struct arp_entry_s *tabptr;
-  int i;
+  FAR struct arp_node_s *node;
 
   /* Check if the IPv4 address is already in the ARP table. */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  node = arp_findnode(ipaddr);
+  if (node != NULL && (node->an_flags & ARP_INCOMPLETE) == 0 &&
+      !arp_expired(node, clock_systime_ticks()))
     {
-      tabptr = &g_arptable[i];
-      if (net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr) &&
-          clock_systime_ticks() - tabptr->at_time <= ARP_MAXAGE_TICK)
-        {
-          return tabptr;
-        }
+      return &node->an_entry;
     }
 
   /* Not found */
@@ -364,6 +635,60 @@ int arp_find(in_addr_t ipaddr, FAR struct ether_addr *ethaddr)
   return -ENOENT;
 }
 
+/****************************************************************************
+ * Name: arp_suppress
+ *
+ * Description:
+ *   Called when there is no ARP table entry for an outgoing packet.  This
+ *   consults the negative cache of addresses that recently failed to
+ *   resolve so that a burst of packets to an unreachable host does not
+ *   generate a burst of ARP requests.
+ *
+ * Input Parameters:
+ *   ipaddr - Refers to an IP address in network order
+ *
+ * Returned Value:
+ *   True if an ARP request for the address was sent less than
+ *   CONFIG_NET_ARP_NEGCACHE_MSEC ago and the packet should be dropped.
+ *   Otherwise, the time of the request about to be sent is recorded and
+ *   false is returned.
+ *
+ * Assumptions
+ *   The network is locked to assure exclusive access to the ARP table.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_ARP_NEGCACHE_MSEC > 0
+bool arp_suppress(in_addr_t ipaddr)
+{
+  FAR struct arp_node_s *node;
+  clock_t now = clock_systime_ticks();
+
+  arp_initialize();
+
+  node = arp_findnode(ipaddr);
+  if (node != NULL && (node->an_flags & ARP_INCOMPLETE) != 0 &&
+      !arp_expired(node, now))
+    {
+      return true;
+    }
+
+  /* Record the request.  A stale positive entry is converted in place. */
+
+  if (node == NULL)
+    {
+      node = arp_allocnode(ipaddr, now, ARP_INCOMPLETE);
+    }
+  else
+    {
+      arp_requeue(node, node->an_flags | ARP_INCOMPLETE);
+    }
+
+  node->an_entry.at_time = now;
+  return false;
+}
+#endif
+
 /****************************************************************************
  * Name: arp_delete
  *
@@ -373,24 +698,33 @@ int arp_find(in_addr_t ipaddr, FAR struct ether_addr *ethaddr)
  * Input Parameters:
  *   ipaddr - Refers to an IP address in network order
  *
+ * Returned Value:
+ *   Zero (OK) if the entry was removed; -ENOENT if there is no valid entry
+ *   for the address.
+ *
  * Assumptions
  *   The network is locked to assure exclusive access to the ARP table.
  *
  ****************************************************************************/
 
-void arp_delete(in_addr_t ipaddr)
+int arp_delete(in_addr_t ipaddr)
 {
-  FAR struct arp_entry_s *tabptr;
+  FAR struct arp_node_s *node;
 
   /* Check if the IPv4 address is in the ARP table. */
 
-  tabptr = arp_lookup(ipaddr);
-  if (tabptr != NULL)
+  if (arp_lookup(ipaddr) == NULL)
     {
-      /* Yes.. Set the IP address to zero to "delete" it */
-
-      tabptr->at_ipaddr = 0;
+      return -ENOENT;
     }
+
+  /* Yes.. Free the entry and make it the first to be re-used */
+
+  node = arp_findnode(ipaddr);
+  dq_rem(&node->an_lru, arp_list(node));
+  arp_unhash(node);
+  dq_addfirst(&node->an_lru, &g_arplru);
+  return OK;
 }
 
 /****************************************************************************
@@ -417,22 +751,25 @@ void arp_delete(in_addr_t ipaddr)
 unsigned int arp_snapshot(FAR struct arp_entry_s *snapshot,
                           unsigned int nentries)
 {
-  FAR struct arp_entry_s *tabptr;
+  FAR struct arp_node_s *node;
   clock_t now;
   unsigned int ncopied;
-  int i;
 
-  /* Copy all non-empty, non-expired entries in the ARP table. */
+  arp_initialize();
+
+  /* Copy all valid entries in the ARP table, most recently updated
+   * first.
+   */
 
-  for (i = 0, now = clock_systime_ticks(), ncopied = 0;
-       nentries > ncopied && i < CONFIG_NET_ARPTAB_SIZE;
-       i++)
+  for (node = (FAR struct arp_node_s *)dq_tail(&g_arplru),
+       now = clock_systime_ticks(), ncopied = 0;
+       node != NULL && nentries > ncopied;
+       node = (FAR struct arp_node_s *)dq_prev(&node->an_lru))
     {
-      tabptr = &g_arptable[i];
-      if (tabptr->at_ipaddr != 0 &&
-          now - tabptr->at_time <= ARP_MAXAGE_TICK)
+      if ((node->an_flags & ARP_INCOMPLETE) == 0 && !arp_expired(node, now))
         {
-          memcpy(&snapshot[ncopied], tabptr, sizeof(struct arp_entry_s));
+          memcpy(&snapshot[ncopied], &node->an_entry,
+                 sizeof(struct arp_entry_s));
           ncopied++;
         }
     }
@@ -42,8 +42,11 @@
 
 #include <nuttx/config.h>
 
+#include <sys/types.h>
 #include <stdint.h>
 
+#include <netinet/in.h>
+
 #undef HAVE_FWDALLOC
 #ifdef CONFIG_NET_IPFORWARD
 
@@ -57,6 +60,14 @@
 #  define CONFIG_NET_IPFORWARD_NSTRUCT 4
 #endif
 
+#ifndef CONFIG_NET_IPFORWARD_FLOWBITS
+#  define CONFIG_NET_IPFORWARD_FLOWBITS 5
+#endif
+
+#ifndef CONFIG_NET_IPFORWARD_FLOWAGE
+#  define CONFIG_NET_IPFORWARD_FLOWAGE 60
+#endif
+
 /* Allocate a new IP forwarding data callback */
 
 #define ipfwd_callback_alloc(dev)   devif_callback_alloc(dev, &(dev)->d_conncb)
@@ -83,6 +94,32 @@ struct forward_s
 #endif
 };
 
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+/* One entry in the IPv4 forwarding flow cache.  A flow is identified by
+ * the 5-tuple of its packets.  Once the first packet of a flow has been
+ * routed, the egress device is remembered here so that the following
+ * packets are forwarded without a routing decision.
+ */
+
+struct ipv4_flow_s
+{
+  FAR struct net_driver_s *fl_dev;        /* Egress device (NULL: unused) */
+  in_addr_t                fl_srcipaddr;  /* Source IPv4 address */
+  in_addr_t                fl_destipaddr; /* Destination IPv4 address */
+  uint16_t                 fl_srcport;    /* Source port (TCP/UDP only) */
+  uint16_t                 fl_destport;   /* Destination port (TCP/UDP) */
+  uint8_t                  fl_proto;      /* IP protocol */
+  clock_t                  fl_time;       /* Time of last use */
+  uint32_t                 fl_packets;    /* Packets forwarded */
+  uint32_t                 fl_bytes;      /* Bytes forwarded */
+};
+
+/* Type of the call out function pointer provided to ipv4_flow_foreach() */
+
+typedef int (*ipv4_flow_handler_t)(FAR const struct ipv4_flow_s *flow,
+                                   FAR void *arg);
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -375,5 +412,93 @@ void ipv4_dropstats(FAR struct ipv4_hdr_s *ipv4);
 #  define ipv4_dropstats(ipv4)
 #endif
 
+/****************************************************************************
+ * Name: ipv4_flow_find
+ *
+ * Description:
+ *   Find the flow cache entry for a packet to be forwarded.
+ *
+ * Input Parameters:
+ *   ipv4 - A pointer to the IPv4 header of the packet
+ *   len  - The length of the packet starting at the IPv4 header
+ *
+ * Returned Value:
+ *   The matching, unexpired flow entry or NULL if there is none.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+FAR struct ipv4_flow_s *ipv4_flow_find(FAR const struct ipv4_hdr_s *ipv4,
+                                       unsigned int len);
+#endif
+
+/****************************************************************************
+ * Name: ipv4_flow_add
+ *
+ * Description:
+ *   Record the egress device chosen for a packet, replacing whatever flow
+ *   occupied the same cache slot.
+ *
+ * Input Parameters:
+ *   ipv4 - A pointer to the IPv4 header of the packet
+ *   len  - The length of the packet starting at the IPv4 header
+ *   dev  - The device on which the packet will be forwarded
+ *
+ * Returned Value:
+ *   The new flow entry or NULL if the packet cannot be cached (for example
+ *   because it is a fragment).
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+FAR struct ipv4_flow_s *ipv4_flow_add(FAR const struct ipv4_hdr_s *ipv4,
+                                      unsigned int len,
+                                      FAR struct net_driver_s *dev);
+#endif
+
+/****************************************************************************
+ * Name: ipv4_flow_flush
+ *
+ * Description:
+ *   Discard all cached flows.  This must be called whenever a forwarding
+ *   decision may change:  when a network device is taken down or
+ *   unregistered, and when addresses or routes are modified.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+void ipv4_flow_flush(void);
+#endif
+
+/****************************************************************************
+ * Name: ipv4_flow_foreach
+ *
+ * Description:
+ *   Traverse the active entries in the flow cache.
+ *
+ * Input Parameters:
+ *   handler - Will be called for each active flow.
+ *   arg     - An arbitrary value that will be passed to the handler.
+ *
+ * Returned Value:
+ *   Zero (OK) returned if the entire cache was traversed.  Handlers may
+ *   terminate the traversal early with any non-zero value, which is then
+ *   returned.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+int ipv4_flow_foreach(ipv4_flow_handler_t handler, FAR void *arg);
+#endif
+
 #endif /* CONFIG_NET_IPFORWARD */
 #endif /* __NET_IPFORWARD_IPFORWARD_H */
@@ -0,0 +1,301 @@
+/****************************************************************************
+ * net/ipforward/ipv4_flow.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/netdev.h>
+
+#include "ipforward/ipforward.h"
+
+#if defined(CONFIG_NET_IPFORWARD_FLOWCACHE) && defined(CONFIG_NET_IPv4)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define FLOW_NENTRIES   (1 << CONFIG_NET_IPFORWARD_FLOWBITS)
+#define FLOW_MASK       (FLOW_NENTRIES - 1)
+#define FLOW_MAXAGE     SEC2TICK(CONFIG_NET_IPFORWARD_FLOWAGE)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The flow cache is direct-mapped:  each flow can only live in the slot
+ * selected by the hash of its 5-tuple, so a lookup is a single compare.
+ * A new flow simply replaces any older flow in its slot.
+ */
+
+static struct ipv4_flow_s g_ipv4_flows[FLOW_NENTRIES];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipv4_flow_key
+ *
+ * Description:
+ *   Extract the 5-tuple of a packet into 'key'.  Returns false if the
+ *   packet is a fragment (only the first fragment carries the ports) or is
+ *   too short.
+ *
+ ****************************************************************************/
+
+static bool ipv4_flow_key(FAR const struct ipv4_hdr_s *ipv4,
+                          unsigned int len, FAR struct ipv4_flow_s *key)
+{
+  FAR const uint16_t *ports;
+  unsigned int iphdrlen;
+
+  if ((ipv4->ipoffset[0] & ((IP_FLAG_MOREFRAGS >> 8) | 0x1f)) != 0 ||
+      ipv4->ipoffset[1] != 0)
+    {
+      return false;
+    }
+
+  key->fl_srcipaddr  = net_ip4addr_conv32(ipv4->srcipaddr);
+  key->fl_destipaddr = net_ip4addr_conv32(ipv4->destipaddr);
+  key->fl_proto      = ipv4->proto;
+  key->fl_srcport    = 0;
+  key->fl_destport   = 0;
+
+  if (ipv4->proto == IP_PROTO_TCP || ipv4->proto == IP_PROTO_UDP)
+    {
+      /* Both TCP and UDP headers begin with the source and destination
+       * ports.
+       */
+
+      iphdrlen = (ipv4->vhl & IPv4_HLMASK) << 2;
+      if (len < iphdrlen + 4)
+        {
+          return false;
+        }
+
+      ports            = (FAR const uint16_t *)
+                         ((FAR const uint8_t *)ipv4 + iphdrlen);
+      key->fl_srcport  = ports[0];
+      key->fl_destport = ports[1];
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: ipv4_flow_hash
+ ****************************************************************************/
+
+static inline unsigned int ipv4_flow_hash(FAR const struct ipv4_flow_s *key)
+{
+  uint32_t hash;
+
+  hash  = key->fl_srcipaddr ^ key->fl_destipaddr ^ key->fl_proto;
+  hash ^= ((uint32_t)key->fl_srcport << 16) | key->fl_destport;
+  hash ^= hash >> 16;
+  hash ^= hash >> 8;
+  return hash & FLOW_MASK;
+}
+
+/****************************************************************************
+ * Name: ipv4_flow_match
+ ****************************************************************************/
+
+static inline bool ipv4_flow_match(FAR const struct ipv4_flow_s *flow,
+                                   FAR const struct ipv4_flow_s *key)
+{
+  return flow->fl_srcipaddr == key->fl_srcipaddr &&
+         flow->fl_destipaddr == key->fl_destipaddr &&
+         flow->fl_srcport == key->fl_srcport &&
+         flow->fl_destport == key->fl_destport &&
+         flow->fl_proto == key->fl_proto;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipv4_flow_find
+ *
+ * Description:
+ *   Find the flow cache entry for a packet to be forwarded.
+ *
+ * Input Parameters:
+ *   ipv4 - A pointer to the IPv4 header of the packet
+ *   len  - The length of the packet starting at the IPv4 header
+ *
+ * Returned Value:
+ *   The matching, unexpired flow entry or NULL if there is none.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+FAR struct ipv4_flow_s *ipv4_flow_find(FAR const struct ipv4_hdr_s *ipv4,
+                                       unsigned int len)
+{
+  FAR struct ipv4_flow_s *flow;
+  struct ipv4_flow_s key;
+  clock_t now;
+
+  if (!ipv4_flow_key(ipv4, len, &key))
+    {
+      return NULL;
+    }
+
+  flow = &g_ipv4_flows[ipv4_flow_hash(&key)];
+  if (flow->fl_dev == NULL || !ipv4_flow_match(flow, &key))
+    {
+      return NULL;
+    }
+
+  now = clock_systime_ticks();
+  if (now - flow->fl_time > FLOW_MAXAGE)
+    {
+      /* Idle for too long.  Re-validate the route. */
+
+      flow->fl_dev = NULL;
+      return NULL;
+    }
+
+  flow->fl_time = now;
+  return flow;
+}
+
+/****************************************************************************
+ * Name: ipv4_flow_add
+ *
+ * Description:
+ *   Record the egress device chosen for a packet, replacing whatever flow
+ *   occupied the same cache slot.
+ *
+ * Input Parameters:
+ *   ipv4 - A pointer to the IPv4 header of the packet
+ *   len  - The length of the packet starting at the IPv4 header
+ *   dev  - The device on which the packet will be forwarded
+ *
+ * Returned Value:
+ *   The new flow entry or NULL if the packet cannot be cached (for example
+ *   because it is a fragment).
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+FAR struct ipv4_flow_s *ipv4_flow_add(FAR const struct ipv4_hdr_s *ipv4,
+                                      unsigned int len,
+                                      FAR struct net_driver_s *dev)
+{
+  FAR struct ipv4_flow_s *flow;
+  struct ipv4_flow_s key;
+
+  if (!ipv4_flow_key(ipv4, len, &key))
+    {
+      return NULL;
+    }
+
+  flow = &g_ipv4_flows[ipv4_flow_hash(&key)];
+  memcpy(flow, &key, sizeof(struct ipv4_flow_s));
+
+  flow->fl_dev     = dev;
+  flow->fl_time    = clock_systime_ticks();
+  flow->fl_packets = 0;
+  flow->fl_bytes   = 0;
+  return flow;
+}
+
+/****************************************************************************
+ * Name: ipv4_flow_flush
+ *
+ * Description:
+ *   Discard all cached flows.  This must be called whenever a forwarding
+ *   decision may change:  when a network device is taken down or
+ *   unregistered, and when addresses or routes are modified.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void ipv4_flow_flush(void)
+{
+  int i;
+
+  for (i = 0; i < FLOW_NENTRIES; i++)
+    {
+      g_ipv4_flows[i].fl_dev = NULL;
+    }
+}
+
+/****************************************************************************
+ * Name: ipv4_flow_foreach
+ *
+ * Description:
+ *   Traverse the active entries in the flow cache.
+ *
+ * Input Parameters:
+ *   handler - Will be called for each active flow.
+ *   arg     - An arbitrary value that will be passed to the handler.
+ *
+ * Returned Value:
+ *   Zero (OK) returned if the entire cache was traversed.  Handlers may
+ *   terminate the traversal early with any non-zero value, which is then
+ *   returned.
+ *
+ ****************************************************************************/
+
+int ipv4_flow_foreach(ipv4_flow_handler_t handler, FAR void *arg)
+{
+  FAR struct ipv4_flow_s *flow;
+  clock_t now;
+  int ret = OK;
+  int i;
+
+  net_lock();
+  now = clock_systime_ticks();
+
+  for (i = 0; i < FLOW_NENTRIES && ret == OK; i++)
+    {
+      flow = &g_ipv4_flows[i];
+      if (flow->fl_dev != NULL && now - flow->fl_time <= FLOW_MAXAGE)
+        {
+          ret = handler(flow, arg);
+        }
+    }
+
+  net_unlock();
+  return ret;
+}
+
+#endif /* CONFIG_NET_IPFORWARD_FLOWCACHE && CONFIG_NET_IPv4 */
@@ -152,8 +152,9 @@ static int ipv4_hdrsize(FAR struct ipv4_hdr_s *ipv4)
 
 static int ipv4_decr_ttl(FAR struct ipv4_hdr_s *ipv4)
 {
-  uint16_t iphdrlen;
-  uint16_t sum;
+  uint16_t oldword;
+  uint16_t newword;
+  uint32_t sum;
   int ttl;
 
   /* Check time-to-live (TTL) */
@@ -174,29 +175,22 @@ static int ipv4_decr_ttl(FAR struct ipv4_hdr_s *ipv4)
 
   /* Save the updated TTL value */
 
+  oldword   = ((uint16_t)ipv4->ttl << 8) | ipv4->proto;
+  newword   = ((uint16_t)ttl << 8) | ipv4->proto;
   ipv4->ttl = ttl;
 
-  /* Get the IP header length (accounting for possible options). */
-
-  iphdrlen = (ipv4->vhl & IPv4_HLMASK) << 2;
-
-  /* Re-calculate the IPv4 checksum.  This checksum is the Internet checksum
-   * of the 20 bytes of the IPv4 header.  This checksum will be different
-   * because we just modify the IPv4 TTL.
+  /* Only the 16-bit word holding the TTL changed, so update the IPv4
+   * header checksum incrementally rather than re-calculating it over the
+   * whole header (RFC 1624, eqn. 3):  HC' = ~(~HC + ~m + m')
    */
 
-  ipv4->ipchksum = 0;
-  sum            = chksum(0, (FAR const uint8_t *)ipv4, iphdrlen);
-  if (sum == 0)
-    {
-      sum = 0xffff;
-    }
-  else
-    {
-      sum = htons(sum);
-    }
+  sum  = (uint16_t)~ntohs(ipv4->ipchksum);
+  sum += (uint16_t)~oldword;
+  sum += newword;
+  sum  = (sum & 0xffff) + (sum >> 16);
+  sum  = (sum & 0xffff) + (sum >> 16);
 
-  ipv4->ipchksum = ~sum;
+  ipv4->ipchksum = htons((uint16_t)~sum);
   return ttl;
 }
 
@@ -444,18 +438,42 @@ int ipv4_forward(FAR struct net_driver_s *dev, FAR struct ipv4_hdr_s *ipv4)
   in_addr_t destipaddr;
   in_addr_t srcipaddr;
   FAR struct net_driver_s *fwddev;
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  FAR struct ipv4_flow_s *flow;
+  uint16_t len = dev->d_len;
+#endif
   int ret;
 
-  /* Search for a device that can forward this packet. */
-
-  destipaddr = net_ip4addr_conv32(ipv4->destipaddr);
-  srcipaddr  = net_ip4addr_conv32(ipv4->srcipaddr);
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  /* If this packet belongs to a flow that was already routed, re-use the
+   * egress device of that flow.
+   */
 
-  fwddev     = netdev_findby_ripv4addr(srcipaddr, destipaddr);
-  if (fwddev == NULL)
+  flow = ipv4_flow_find(ipv4, len);
+  if (flow != NULL)
+    {
+      fwddev = flow->fl_dev;
+    }
+  else
+#endif
     {
-      nwarn("WARNING: Not routable\n");
-      return (ssize_t)-ENETUNREACH;
+      /* Search for a device that can forward this packet. */
+
+      destipaddr = net_ip4addr_conv32(ipv4->destipaddr);
+      srcipaddr  = net_ip4addr_conv32(ipv4->srcipaddr);
+
+      fwddev     = netdev_findby_ripv4addr(srcipaddr, destipaddr);
+      if (fwddev == NULL)
+        {
+          nwarn("WARNING: Not routable\n");
+          return (ssize_t)-ENETUNREACH;
+        }
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+      /* Remember the routing decision for the rest of the flow */
+
+      flow = ipv4_flow_add(ipv4, len, fwddev);
+#endif
     }
 
   /* Check if we are forwarding on the same device that we received the
@@ -472,6 +490,14 @@ int ipv4_forward(FAR struct net_driver_s *dev, FAR struct ipv4_hdr_s *ipv4)
           nwarn("WARNING: ipv4_dev_forward failed: %d\n", ret);
           goto drop;
         }
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+      if (flow != NULL)
+        {
+          flow->fl_packets++;
+          flow->fl_bytes += len;
+        }
+#endif
     }
   else
     {
@@ -56,6 +56,25 @@
 
 #ifdef CONFIG_NET_IPv6
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_NET_IPv6_NCONF_HASHBITS
+#  define CONFIG_NET_IPv6_NCONF_HASHBITS 3
+#endif
+
+#define NEIGHBOR_HASHSIZE (1 << CONFIG_NET_IPv6_NCONF_HASHBITS)
+#define NEIGHBOR_HASHMASK (NEIGHBOR_HASHSIZE - 1)
+
+/* Fold the interface identifier of an IPv6 address into a hash bucket
+ * index.
+ */
+
+#define neighbor_hash(a) \
+  ((unsigned int)((a)[4] ^ (a)[5] ^ (a)[6] ^ (a)[7] ^ \
+                  (((a)[6] ^ (a)[7]) >> 8)) & NEIGHBOR_HASHMASK)
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -66,6 +85,15 @@
 
 extern struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
 
+/* Hash index into the Neighbor table.  Entries whose addresses hash to the
+ * same bucket are chained through g_neighbor_hnext[], which is indexed in
+ * parallel with g_neighbors[].  Unused entries are not in the index.
+ */
+
+extern FAR struct neighbor_entry_s *g_neighbor_hash[NEIGHBOR_HASHSIZE];
+extern FAR struct neighbor_entry_s *
+  g_neighbor_hnext[CONFIG_NET_IPv6_NCONF_ENTRIES];
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
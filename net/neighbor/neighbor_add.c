@@ -55,6 +55,7 @@
 #include <nuttx/net/neighbor.h>
 
 #include "netdev/netdev.h"
+#include "inet/inet.h"
 #include "neighbor/neighbor.h"
 
 /****************************************************************************
@@ -81,6 +82,8 @@
 void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
                   FAR uint8_t *addr)
 {
+  FAR struct neighbor_entry_s *neighbor;
+  FAR struct neighbor_entry_s **pp;
   uint8_t lltype;
   clock_t oldest_time;
   int     oldest_ndx;
@@ -88,46 +91,75 @@ void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
 
   DEBUGASSERT(dev != NULL && addr != NULL);
 
-  /* Find the matching entry, first unused entry, or the oldest used entry.
-   * The unused entry will have ne_time == 0 and should generate the oldest
-   * time.  REVISIT:  Could this fail on clock wraparound?  A more explicit
-   * check might be to compare ne_ipaddr with the IPv6 unspecified address.
-   */
+  /* Look for a matching entry in the hash index first */
 
-  oldest_time = g_neighbors[0].ne_time;
-  oldest_ndx  = 0;
-  lltype      = dev->d_lltype;
+  lltype = dev->d_lltype;
 
-  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+  for (neighbor = g_neighbor_hash[neighbor_hash(ipaddr)];
+       neighbor != NULL;
+       neighbor = g_neighbor_hnext[neighbor - g_neighbors])
     {
-      if (g_neighbors[i].ne_addr.na_lltype == lltype &&
-          net_ipv6addr_cmp(g_neighbors[i].ne_ipaddr, ipaddr))
+      if (neighbor->ne_addr.na_lltype == lltype &&
+          net_ipv6addr_cmp(neighbor->ne_ipaddr, ipaddr))
         {
-          oldest_ndx = i;
           break;
         }
+    }
+
+  if (neighbor == NULL)
+    {
+      /* Not found.. Use the first unused entry, or the oldest used entry.
+       * The unused entry will have ne_time == 0 and should generate the
+       * oldest time.  REVISIT:  Could this fail on clock wraparound?  A
+       * more explicit check might be to compare ne_ipaddr with the IPv6
+       * unspecified address.
+       */
 
-      if ((int)(g_neighbors[i].ne_time - oldest_time) < 0)
+      oldest_time = g_neighbors[0].ne_time;
+      oldest_ndx  = 0;
+
+      for (i = 1; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
         {
-          oldest_ndx = i;
-          oldest_time = g_neighbors[i].ne_time;
+          if ((int)(g_neighbors[i].ne_time - oldest_time) < 0)
+            {
+              oldest_ndx = i;
+              oldest_time = g_neighbors[i].ne_time;
+            }
         }
-    }
 
-  /* Use the oldest or first free entry (either pointed to by the
-   * "oldest_ndx" variable).
-   */
+      neighbor = &g_neighbors[oldest_ndx];
+
+      /* Remove the old association from the hash index */
+
+      if (!net_ipv6addr_cmp(neighbor->ne_ipaddr, g_ipv6_unspecaddr))
+        {
+          for (pp = &g_neighbor_hash[neighbor_hash(neighbor->ne_ipaddr)];
+               *pp != NULL;
+               pp = &g_neighbor_hnext[*pp - g_neighbors])
+            {
+              if (*pp == neighbor)
+                {
+                  *pp = g_neighbor_hnext[oldest_ndx];
+                  break;
+                }
+            }
+        }
+
+      /* And add the new one */
+
+      net_ipv6addr_copy(neighbor->ne_ipaddr, ipaddr);
+      g_neighbor_hnext[oldest_ndx] = g_neighbor_hash[neighbor_hash(ipaddr)];
+      g_neighbor_hash[neighbor_hash(ipaddr)] = neighbor;
+    }
 
-  g_neighbors[oldest_ndx].ne_time = clock_systime_ticks();
-  net_ipv6addr_copy(g_neighbors[oldest_ndx].ne_ipaddr, ipaddr);
+  neighbor->ne_time = clock_systime_ticks();
 
-  g_neighbors[oldest_ndx].ne_addr.na_lltype = lltype;
-  g_neighbors[oldest_ndx].ne_addr.na_llsize = netdev_lladdrsize(dev);
+  neighbor->ne_addr.na_lltype = lltype;
+  neighbor->ne_addr.na_llsize = netdev_lladdrsize(dev);
 
-  memcpy(&g_neighbors[oldest_ndx].ne_addr.u, addr,
-         g_neighbors[oldest_ndx].ne_addr.na_llsize);
+  memcpy(&neighbor->ne_addr.u, addr, neighbor->ne_addr.na_llsize);
 
   /* Dump the contents of the new entry */
 
-  neighbor_dumpentry("Added entry", &g_neighbors[oldest_ndx]);
+  neighbor_dumpentry("Added entry", neighbor);
 }
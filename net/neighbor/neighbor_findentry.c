@@ -70,12 +70,12 @@
 
 FAR struct neighbor_entry_s *neighbor_findentry(const net_ipv6addr_t ipaddr)
 {
-  int i;
+  FAR struct neighbor_entry_s *neighbor;
 
-  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+  for (neighbor = g_neighbor_hash[neighbor_hash(ipaddr)];
+       neighbor != NULL;
+       neighbor = g_neighbor_hnext[neighbor - g_neighbors])
     {
-      FAR struct neighbor_entry_s *neighbor = &g_neighbors[i];
-
       if (net_ipv6addr_cmp(neighbor->ne_ipaddr, ipaddr))
         {
           neighbor_dumpentry("Entry found", neighbor);
@@ -56,6 +56,11 @@
 
 struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
 
+/* Hash index into the Neighbor table */
+
+FAR struct neighbor_entry_s *g_neighbor_hash[NEIGHBOR_HASHSIZE];
+FAR struct neighbor_entry_s *g_neighbor_hnext[CONFIG_NET_IPv6_NCONF_ENTRIES];
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -89,6 +89,7 @@
 #include "igmp/igmp.h"
 #include "icmpv6/icmpv6.h"
 #include "route/route.h"
+#include "ipforward/ipforward.h"
 #include "netlink/netlink.h"
 
 /****************************************************************************
@@ -1295,23 +1296,9 @@ static int netdev_arp_ioctl(FAR struct socket *psock, int cmd,
               FAR struct sockaddr_in *addr =
                 (FAR struct sockaddr_in *)&req->arp_pa;
 
-              /* Find the existing ARP entry for this protocol address. */
+              /* Delete the existing ARP entry for this protocol address. */
 
-              FAR struct arp_entry_s *entry =
-                arp_lookup(addr->sin_addr.s_addr);
-              if (entry != NULL)
-                {
-                  /* The ARP table is fixed size; an entry is deleted
-                   * by nullifying its protocol address.
-                   */
-
-                  entry->at_ipaddr = 0;
-                  ret = OK;
-                }
-              else
-                {
-                  ret = -ENOENT;
-                }
+              ret = arp_delete(addr->sin_addr.s_addr);
             }
           else
             {
@@ -1750,6 +1737,30 @@ int psock_vioctl(FAR struct socket *psock, int cmd, va_list ap)
     }
 #endif
 
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  /* Address and routing changes invalidate cached forwarding decisions */
+
+  if (ret >= 0)
+    {
+      switch (cmd)
+        {
+          case SIOCSIFADDR:
+          case SIOCSIFDSTADDR:
+          case SIOCSIFNETMASK:
+          case SIOCDIFADDR:
+          case SIOCADDRT:
+          case SIOCDELRT:
+            net_lock();
+            ipv4_flow_flush();
+            net_unlock();
+            break;
+
+          default:
+            break;
+        }
+    }
+#endif
+
   return ret;
 }
 
@@ -1872,6 +1883,14 @@ void netdev_ifdown(FAR struct net_driver_s *dev)
 
       devif_dev_event(dev, NULL, NETDEV_DOWN);
 
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+      /* Forget flows that were being forwarded through this device */
+
+      net_lock();
+      ipv4_flow_flush();
+      net_unlock();
+#endif
+
 #ifdef CONFIG_NETDOWN_NOTIFIER
       /* Provide signal notifications to threads that want to be
        * notified of the network down state via signal.
@@ -52,6 +52,7 @@
 
 #include "utils/utils.h"
 #include "netdev/netdev.h"
+#include "ipforward/ipforward.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -160,6 +161,12 @@ int netdev_unregister(FAR struct net_driver_s *dev)
           curr->flink = NULL;
         }
 
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+      /* The flow cache must not retain references to the device */
+
+      ipv4_flow_flush();
+#endif
+
 #ifdef CONFIG_NETDEV_IFINDEX
       free_ifindex(dev->d_ifindex);
 #endif
@@ -74,12 +74,19 @@
 #  define STAT_INDEX     0
 #  ifdef CONFIG_NET_MLD
 #    define MLD_INDEX    1
-#    define _ROUTE_INDEX 2
+#    define _FLOWS_INDEX 2
 #  else
-#    define _ROUTE_INDEX 1
+#    define _FLOWS_INDEX 1
 #  endif
 #else
-#  define _ROUTE_INDEX   0
+#  define _FLOWS_INDEX   0
+#endif
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+#  define FLOWS_INDEX    _FLOWS_INDEX
+#  define _ROUTE_INDEX   (_FLOWS_INDEX + 1)
+#else
+#  define _ROUTE_INDEX   _FLOWS_INDEX
 #endif
 
 #ifdef CONFIG_NET_ROUTE
@@ -195,6 +202,19 @@ static int netprocfs_open(FAR struct file *filep, FAR const char *relpath,
 #endif
 #endif
 
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  /* "net/flows" is an acceptable value for the relpath only if the IPv4
+   * forwarding flow cache is enabled.
+   */
+
+  if (strcmp(relpath, "net/flows") == 0)
+    {
+      entry = NETPROCFS_SUBDIR_FLOWS;
+      dev   = NULL;
+    }
+  else
+#endif
+
 #ifdef CONFIG_NET_ROUTE
   /* "net/route" is an acceptable value for the relpath only if routing
    * table support is initialized.
@@ -325,6 +345,16 @@ static ssize_t netprocfs_read(FAR struct file *filep, FAR char *buffer,
 #endif
 #endif
 
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+      case NETPROCFS_SUBDIR_FLOWS:
+
+        /* Show the IPv4 forwarding flow cache */
+
+        nreturned = netprocfs_read_flows(priv, buffer, buflen,
+                                         filep->f_pos);
+        break;
+#endif
+
 #ifdef CONFIG_NET_ROUTE
       case NETPROCFS_SUBDIR_ROUTE:
         nerr("ERROR: Cannot read from directory net/route\n");
@@ -446,6 +476,9 @@ static int netprocfs_opendir(FAR const char *relpath,
       level1->base.nentries++;
 #endif
 #endif
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+      level1->base.nentries++;
+#endif
 #ifdef CONFIG_NET_ROUTE
       level1->base.nentries++;
 #endif
@@ -552,6 +585,16 @@ static int netprocfs_readdir(FAR struct fs_dirent_s *dir)
       else
 #endif
 #endif
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+      if (index == FLOWS_INDEX)
+        {
+          /* Copy the flow cache directory entry */
+
+          dir->fd_dir.d_type = DTYPE_FILE;
+          strncpy(dir->fd_dir.d_name, "flows", NAME_MAX + 1);
+        }
+      else
+#endif
 #ifdef CONFIG_NET_ROUTE
       if (index == ROUTE_INDEX)
         {
@@ -683,6 +726,15 @@ static int netprocfs_stat(FAR const char *relpath, FAR struct stat *buf)
   else
 #endif
 #endif
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  /* Check for the flow cache "net/flows" */
+
+  if (strcmp(relpath, "net/flows") == 0)
+    {
+      buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+    }
+  else
+#endif
 #ifdef CONFIG_NET_ROUTE
   /* Check for network statistics "net/stat" */
 
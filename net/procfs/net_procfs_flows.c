@@ -0,0 +1,189 @@
+/****************************************************************************
+ * net/procfs/net_procfs_flows.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <debug.h>
+
+#include <arpa/inet.h>
+
+#include <nuttx/fs/procfs.h>
+#include <nuttx/net/netdev.h>
+
+#include "ipforward/ipforward.h"
+#include "procfs/procfs.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_NET) && \
+    defined(CONFIG_NET_IPFORWARD_FLOWCACHE)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The structure is used when traversing the flow cache */
+
+struct flow_info_s
+{
+  FAR char *line;                    /* Intermediate line buffer pointer */
+  FAR char *buffer;                  /* User buffer */
+  size_t    linelen;                 /* Size of the intermediate buffer */
+  size_t    buflen;                  /* Size of the user buffer */
+  size_t    remaining;               /* Bytes remaining in user buffer */
+  size_t    totalsize;               /* Accumulated size of the copy */
+  off_t     offset;                  /* Skip offset */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: flow_sprintf
+ ****************************************************************************/
+
+static void flow_sprintf(FAR struct flow_info_s *info,
+                         FAR const char *fmt, ...)
+{
+  size_t linesize;
+  size_t copysize;
+  va_list ap;
+
+  /* Print the format and data to a line buffer */
+
+  va_start(ap, fmt);
+  linesize = vsnprintf(info->line, info->linelen, fmt, ap);
+  va_end(ap);
+
+  if (linesize >= info->linelen)
+    {
+      linesize = info->linelen - 1;
+    }
+
+  /* Copy the line buffer to the user buffer */
+
+  copysize = procfs_memcpy(info->line, linesize,
+                           info->buffer, info->remaining,
+                           &info->offset);
+
+  /* Update counts and pointers */
+
+  info->totalsize += copysize;
+  info->buffer    += copysize;
+  info->remaining -= copysize;
+}
+
+/****************************************************************************
+ * Name: flow_entry
+ *
+ * Description:
+ *   Format (one flow per line):
+ *
+ *   SOURCE                DESTINATION            PR DEVICE      PACKETS ...
+ *   xxx.xxx.xxx.xxx:ppppp xxx.xxx.xxx.xxx:ppppp nnn dddddddd nnnnnnnnnn ...
+ *
+ ****************************************************************************/
+
+static int flow_entry(FAR const struct ipv4_flow_s *flow, FAR void *arg)
+{
+  FAR struct flow_info_s *info = (FAR struct flow_info_s *)arg;
+  char addr[INET_ADDRSTRLEN];
+  char src[INET_ADDRSTRLEN + 6];
+  char dest[INET_ADDRSTRLEN + 6];
+
+  DEBUGASSERT(info != NULL);
+
+  inet_ntop(AF_INET, &flow->fl_srcipaddr, addr, INET_ADDRSTRLEN);
+  snprintf(src, sizeof(src), "%s:%u", addr, ntohs(flow->fl_srcport));
+
+  inet_ntop(AF_INET, &flow->fl_destipaddr, addr, INET_ADDRSTRLEN);
+  snprintf(dest, sizeof(dest), "%s:%u", addr, ntohs(flow->fl_destport));
+
+  flow_sprintf(info, "%-21s %-21s %3u %-8s %10lu %10lu\n",
+               src, dest, flow->fl_proto, flow->fl_dev->d_ifname,
+               (unsigned long)flow->fl_packets,
+               (unsigned long)flow->fl_bytes);
+
+  return (info->totalsize >= info->buflen) ? 1 : 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netprocfs_read_flows
+ *
+ * Description:
+ *   Read and format the IPv4 forwarding flow cache.
+ *
+ * Input Parameters:
+ *   priv   - A reference to the network procfs file structure
+ *   buffer - The user-provided buffer into which the flow cache content
+ *            will be returned.
+ *   buflen - The size in bytes of the user provided buffer.
+ *   offset - The file offset of the first byte to return.
+ *
+ * Returned Value:
+ *   The number of bytes returned; zero at the end of the file.
+ *
+ ****************************************************************************/
+
+ssize_t netprocfs_read_flows(FAR struct netprocfs_file_s *priv,
+                             FAR char *buffer, size_t buflen, off_t offset)
+{
+  struct flow_info_s info;
+
+  memset(&info, 0, sizeof(struct flow_info_s));
+  info.line      = priv->line;
+  info.buffer    = buffer;
+  info.linelen   = NET_LINELEN;
+  info.buflen    = buflen;
+  info.remaining = buflen;
+  info.offset    = offset;
+
+  /* The whole file is regenerated on each read; the offset skips over the
+   * part that was already returned.
+   */
+
+  flow_sprintf(&info, "%-21s %-21s %3s %-8s %10s %10s\n",
+               "SOURCE", "DESTINATION", "PR", "DEVICE",
+               "PACKETS", "BYTES");
+
+  if (info.totalsize < info.buflen)
+    {
+      ipv4_flow_foreach(flow_entry, &info);
+    }
+
+  return info.totalsize;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * !CONFIG_FS_PROCFS_EXCLUDE_NET && CONFIG_NET_IPFORWARD_FLOWCACHE */
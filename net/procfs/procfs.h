@@ -75,6 +75,9 @@ enum netprocfs_entry_e
   , NETPROCFS_SUBDIR_MLD             /* /proc/net/mld */
 #endif
 #endif
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+  , NETPROCFS_SUBDIR_FLOWS           /* /proc/net/flows */
+#endif
 #ifdef CONFIG_NET_ROUTE
   , NETPROCFS_SUBDIR_ROUTE           /* /proc/net/route */
 #endif
@@ -195,6 +198,29 @@ ssize_t netprocfs_read_mldstats(FAR struct netprocfs_file_s *priv,
                                 FAR char *buffer, size_t buflen);
 #endif
 
+/****************************************************************************
+ * Name: netprocfs_read_flows
+ *
+ * Description:
+ *   Read and format the IPv4 forwarding flow cache.
+ *
+ * Input Parameters:
+ *   priv   - A reference to the network procfs file structure
+ *   buffer - The user-provided buffer into which the flow cache content
+ *            will be returned.
+ *   buflen - The size in bytes of the user provided buffer.
+ *   offset - The file offset of the first byte to return.
+ *
+ * Returned Value:
+ *   The number of bytes returned; zero at the end of the file.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWCACHE
+ssize_t netprocfs_read_flows(FAR struct netprocfs_file_s *priv,
+                             FAR char *buffer, size_t buflen, off_t offset);
+#endif
+
 /****************************************************************************
  * Name: netprocfs_read_routes
  *
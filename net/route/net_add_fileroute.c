@@ -49,6 +49,7 @@
 #include <nuttx/net/ip.h>
 
 #include "route/fileroute.h"
+#include "route/trieroute.h"
 #include "route/route.h"
 
 #if defined(CONFIG_ROUTE_IPv4_FILEROUTE) || defined(CONFIG_ROUTE_IPv6_FILEROUTE)
@@ -99,7 +100,15 @@ int net_addroute_ipv4(in_addr_t target, in_addr_t netmask, in_addr_t router)
   nwritten = net_writeroute_ipv4(&fshandle, &route);
 
   net_closeroute_ipv4(&fshandle);
-  return nwritten >= 0 ? 0 : (int)nwritten;
+  if (nwritten < 0)
+    {
+      return (int)nwritten;
+    }
+
+#ifdef CONFIG_ROUTE_TRIE
+  net_addtrie_ipv4(&route);
+#endif
+  return OK;
 }
 #endif
 
@@ -133,7 +142,15 @@ int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask,
   nwritten = net_writeroute_ipv6(&fshandle, &route);
 
   net_closeroute_ipv6(&fshandle);
-  return nwritten >= 0 ? 0 : (int)nwritten;
+  if (nwritten < 0)
+    {
+      return (int)nwritten;
+    }
+
+#ifdef CONFIG_ROUTE_TRIE
+  net_addtrie_ipv6(&route);
+#endif
+  return OK;
 }
 #endif
 
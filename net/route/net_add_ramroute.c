@@ -50,6 +50,7 @@
 #include <arch/irq.h>
 
 #include "route/ramroute.h"
+#include "route/trieroute.h"
 #include "route/route.h"
 
 #if defined(CONFIG_ROUTE_IPv4_RAMROUTE) || defined(CONFIG_ROUTE_IPv6_RAMROUTE)
@@ -100,6 +101,9 @@ int net_addroute_ipv4(in_addr_t target, in_addr_t netmask, in_addr_t router)
 
   ramroute_ipv4_addlast((FAR struct net_route_ipv4_entry_s *)route,
                         &g_ipv4_routes);
+#ifdef CONFIG_ROUTE_TRIE
+  net_addtrie_ipv4(route);
+#endif
   net_unlock();
   return OK;
 }
@@ -135,6 +139,9 @@ int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask,
 
   ramroute_ipv6_addlast((FAR struct net_route_ipv6_entry_s *)route,
                         &g_ipv6_routes);
+#ifdef CONFIG_ROUTE_TRIE
+  net_addtrie_ipv6(route);
+#endif
   net_unlock();
   return OK;
 }
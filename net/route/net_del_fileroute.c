@@ -40,6 +40,7 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <string.h>
@@ -52,6 +53,7 @@
 #include <nuttx/net/ip.h>
 
 #include "route/fileroute.h"
+#include "route/trieroute.h"
 #include "route/cacheroute.h"
 #include "route/route.h"
 
@@ -198,6 +200,9 @@ int net_delroute_ipv4(in_addr_t target, in_addr_t netmask)
   int nentries;
   int index;
   int ret;
+#ifdef CONFIG_ROUTE_TRIE
+  bool deleted = false;
+#endif
 
   /* We must lock out other accesses to the routing table while we remove
    * entry
@@ -323,12 +328,28 @@ int net_delroute_ipv4(in_addr_t target, in_addr_t netmask)
 
   filesize = (nentries - 1) * sizeof(struct net_route_ipv4_s);
   ret = file_truncate(&fshandle, filesize);
+#ifdef CONFIG_ROUTE_TRIE
+  deleted = (ret >= 0);
+#endif
 
 errout_with_fshandle:
   net_closeroute_ipv4(&fshandle);
 
 errout_with_lock:
   net_unlockroute_ipv4();
+
+#ifdef CONFIG_ROUTE_TRIE
+  /* Update the trie only after the routing table is unlocked.  The
+   * forwarding path takes the routing table lock while holding the network
+   * lock when it rebuilds an empty trie.
+   */
+
+  if (deleted)
+    {
+      net_deltrie_ipv4(target, netmask);
+    }
+#endif
+
   return ret;
 }
 #endif
@@ -346,6 +367,9 @@ int net_delroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask)
   int nentries;
   int index;
   int ret;
+#ifdef CONFIG_ROUTE_TRIE
+  bool deleted = false;
+#endif
 
   /* We must lock out other accesses to the routing table while we remove
    * entry
@@ -472,12 +496,28 @@ int net_delroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask)
 
   filesize = (nentries - 1) * sizeof(struct net_route_ipv6_s);
   ret = file_truncate(&fshandle, filesize);
+#ifdef CONFIG_ROUTE_TRIE
+  deleted = (ret >= 0);
+#endif
 
 errout_with_fshandle:
   net_closeroute_ipv6(&fshandle);
 
 errout_with_lock:
   net_unlockroute_ipv6();
+
+#ifdef CONFIG_ROUTE_TRIE
+  /* Update the trie only after the routing table is unlocked.  The
+   * forwarding path takes the routing table lock while holding the network
+   * lock when it rebuilds an empty trie.
+   */
+
+  if (deleted)
+    {
+      net_deltrie_ipv6(target, netmask);
+    }
+#endif
+
   return ret;
 }
 #endif
@@ -0,0 +1,785 @@
+/****************************************************************************
+ * net/route/net_trieroute.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/ip.h>
+
+#include "route/trieroute.h"
+#include "route/route.h"
+
+#if defined(CONFIG_NET) && defined(CONFIG_ROUTE_TRIE)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Size of the largest key held in a trie node */
+
+#ifdef CONFIG_NET_IPv6
+#  define TRIE_MAXKEY  16
+#else
+#  define TRIE_MAXKEY  4
+#endif
+
+#ifndef MIN
+#  define MIN(a,b)     ((a) < (b) ? (a) : (b))
+#endif
+
+/* Trie states */
+
+#define TRIE_EMPTY     0  /* Not populated; build from routing table on use */
+#define TRIE_VALID     1  /* Mirrors the routing table */
+#define TRIE_FAILED    2  /* Out of memory; unusable until table changes */
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One node of a path-compressed binary (Patricia) trie.  The node covers
+ * the first 'plen' bits of 'key'.  Nodes with nrefs == 0 are glue nodes
+ * that exist only to branch and hold no route.
+ */
+
+struct trie_node_s
+{
+  FAR struct trie_node_s *child[2];  /* Sub-tries for next bit 0 and 1 */
+  uint16_t nrefs;                    /* Routes with exactly this prefix */
+  uint8_t plen;                      /* Prefix length in bits */
+  uint8_t key[TRIE_MAXKEY];          /* Prefix in network order */
+  union
+  {
+#ifdef CONFIG_NET_IPv4
+    struct net_route_ipv4_s ipv4;
+#endif
+#ifdef CONFIG_NET_IPv6
+    struct net_route_ipv6_s ipv6;
+#endif
+  } route;                           /* First route added with this prefix */
+};
+
+struct trie_s
+{
+  FAR struct trie_node_s *root;      /* Root of the trie */
+  unsigned int noncontig;            /* Routes with non-contiguous masks */
+  uint8_t keylen;                    /* Size of an address in bytes */
+  uint8_t state;                     /* See TRIE_* definitions */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static struct trie_s g_ipv4_trie =
+{
+  NULL, 0, sizeof(in_addr_t), TRIE_EMPTY
+};
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static struct trie_s g_ipv6_trie =
+{
+  NULL, 0, sizeof(net_ipv6addr_t), TRIE_EMPTY
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: trie_bit
+ *
+ * Description:
+ *   Return bit 'n' of the key, counting from the most significant bit of
+ *   the first byte.
+ *
+ ****************************************************************************/
+
+static inline int trie_bit(FAR const uint8_t *key, unsigned int n)
+{
+  return (key[n >> 3] >> (7 - (n & 7))) & 1;
+}
+
+/****************************************************************************
+ * Name: trie_common
+ *
+ * Description:
+ *   Return the number of leading bits, up to 'maxbits', that two keys have
+ *   in common.
+ *
+ ****************************************************************************/
+
+static unsigned int trie_common(FAR const uint8_t *a, FAR const uint8_t *b,
+                                unsigned int maxbits)
+{
+  unsigned int nbits;
+  uint8_t diff;
+
+  for (nbits = 0; nbits < maxbits; nbits += 8)
+    {
+      diff = a[nbits >> 3] ^ b[nbits >> 3];
+      if (diff != 0)
+        {
+          while ((diff & 0x80) == 0)
+            {
+              diff <<= 1;
+              nbits++;
+            }
+
+          return MIN(nbits, maxbits);
+        }
+    }
+
+  return maxbits;
+}
+
+/****************************************************************************
+ * Name: trie_prefixlen
+ *
+ * Description:
+ *   Return the prefix length of a network mask, or -EINVAL if the mask is
+ *   not contiguous.
+ *
+ ****************************************************************************/
+
+static int trie_prefixlen(FAR const uint8_t *mask, unsigned int keylen)
+{
+  unsigned int plen = 0;
+  unsigned int i;
+  uint8_t m;
+
+  for (i = 0; i < keylen && mask[i] == 0xff; i++)
+    {
+      plen += 8;
+    }
+
+  if (i < keylen)
+    {
+      for (m = mask[i++]; (m & 0x80) != 0; m <<= 1)
+        {
+          plen++;
+        }
+
+      if (m != 0)
+        {
+          return -EINVAL;
+        }
+
+      for (; i < keylen; i++)
+        {
+          if (mask[i] != 0)
+            {
+              return -EINVAL;
+            }
+        }
+    }
+
+  return plen;
+}
+
+/****************************************************************************
+ * Name: trie_newnode
+ *
+ * Description:
+ *   Allocate a node for the first 'plen' bits of 'key'.  If 'route' is
+ *   not NULL, the node holds that route; otherwise it is a glue node.
+ *
+ ****************************************************************************/
+
+static FAR struct trie_node_s *trie_newnode(FAR struct trie_s *trie,
+                                            FAR const uint8_t *key,
+                                            unsigned int plen,
+                                            FAR const void *route,
+                                            size_t routelen)
+{
+  FAR struct trie_node_s *node;
+  unsigned int i;
+
+  node = (FAR struct trie_node_s *)kmm_zalloc(sizeof(struct trie_node_s));
+  if (node != NULL)
+    {
+      /* Keep only the prefix bits of the key */
+
+      node->plen = plen;
+      for (i = 0; i < trie->keylen && plen > 0; i++)
+        {
+          node->key[i] = key[i];
+          if (plen < 8)
+            {
+              node->key[i] &= (uint8_t)(0xff << (8 - plen));
+              break;
+            }
+
+          plen -= 8;
+        }
+
+      if (route != NULL)
+        {
+          memcpy(&node->route, route, routelen);
+          node->nrefs = 1;
+        }
+    }
+
+  return node;
+}
+
+/****************************************************************************
+ * Name: trie_insert
+ *
+ * Description:
+ *   Insert a route for the first 'plen' bits of 'key'.  If the prefix is
+ *   already present, only its reference count is incremented so that, as
+ *   with the linear routing table search, the first route added wins.
+ *
+ ****************************************************************************/
+
+static int trie_insert(FAR struct trie_s *trie, FAR const uint8_t *key,
+                       unsigned int plen, FAR const void *route,
+                       size_t routelen)
+{
+  FAR struct trie_node_s **pp = &trie->root;
+  FAR struct trie_node_s *node;
+  FAR struct trie_node_s *split;
+  FAR struct trie_node_s *leaf;
+  unsigned int common;
+
+  while ((node = *pp) != NULL)
+    {
+      common = trie_common(node->key, key, MIN(node->plen, plen));
+      if (common < node->plen)
+        {
+          /* The new prefix diverges from this node (or is a shorter prefix
+           * of it).  Insert a node at the point of divergence.
+           */
+
+          if (common == plen)
+            {
+              split = trie_newnode(trie, key, plen, route, routelen);
+              if (split == NULL)
+                {
+                  return -ENOMEM;
+                }
+            }
+          else
+            {
+              split = trie_newnode(trie, key, common, NULL, 0);
+              if (split == NULL)
+                {
+                  return -ENOMEM;
+                }
+
+              leaf = trie_newnode(trie, key, plen, route, routelen);
+              if (leaf == NULL)
+                {
+                  kmm_free(split);
+                  return -ENOMEM;
+                }
+
+              split->child[trie_bit(key, common)] = leaf;
+            }
+
+          split->child[trie_bit(node->key, common)] = node;
+          *pp = split;
+          return OK;
+        }
+
+      if (node->plen == plen)
+        {
+          /* Same prefix.  This may be a glue node that now gets a route */
+
+          if (node->nrefs == 0)
+            {
+              memcpy(&node->route, route, routelen);
+            }
+
+          node->nrefs++;
+          return OK;
+        }
+
+      pp = &node->child[trie_bit(key, node->plen)];
+    }
+
+  leaf = trie_newnode(trie, key, plen, route, routelen);
+  if (leaf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  *pp = leaf;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: trie_remove
+ *
+ * Description:
+ *   Remove one reference to the route for the first 'plen' bits of 'key'.
+ *
+ * Returned Value:
+ *   OK if the prefix was removed; -ENOENT if it was not in the trie.  A
+ *   positive value is returned if other routes with the same prefix
+ *   remain; the route held by the node may then be stale.
+ *
+ ****************************************************************************/
+
+static int trie_remove(FAR struct trie_s *trie, FAR const uint8_t *key,
+                       unsigned int plen)
+{
+  FAR struct trie_node_s **parent = NULL;
+  FAR struct trie_node_s **pp = &trie->root;
+  FAR struct trie_node_s *node;
+  FAR struct trie_node_s *other;
+
+  while ((node = *pp) != NULL)
+    {
+      if (trie_common(node->key, key, MIN(node->plen, plen)) < node->plen)
+        {
+          return -ENOENT;
+        }
+
+      if (node->plen == plen)
+        {
+          break;
+        }
+
+      parent = pp;
+      pp     = &node->child[trie_bit(key, node->plen)];
+    }
+
+  if (node == NULL || node->nrefs == 0)
+    {
+      return -ENOENT;
+    }
+
+  if (--node->nrefs > 0)
+    {
+      return 1;
+    }
+
+  /* The node is now a glue node.  Keep it only if it still branches */
+
+  if (node->child[0] != NULL && node->child[1] != NULL)
+    {
+      return OK;
+    }
+
+  *pp = node->child[0] != NULL ? node->child[0] : node->child[1];
+  kmm_free(node);
+
+  /* If that left the parent as a glue node with a single child, the
+   * parent is no longer needed either.
+   */
+
+  if (*pp == NULL && parent != NULL)
+    {
+      node = *parent;
+      if (node->nrefs == 0)
+        {
+          other   = node->child[0] != NULL ? node->child[0] : node->child[1];
+          *parent = other;
+          kmm_free(node);
+        }
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: trie_lookup
+ *
+ * Description:
+ *   Return the node holding the longest prefix of 'key', or NULL.
+ *
+ ****************************************************************************/
+
+static FAR struct trie_node_s *trie_lookup(FAR struct trie_s *trie,
+                                           FAR const uint8_t *key)
+{
+  FAR struct trie_node_s *node = trie->root;
+  FAR struct trie_node_s *best = NULL;
+
+  while (node != NULL)
+    {
+      if (trie_common(node->key, key, node->plen) < node->plen)
+        {
+          break;
+        }
+
+      if (node->nrefs > 0)
+        {
+          best = node;
+        }
+
+      if (node->plen >= trie->keylen * 8)
+        {
+          break;
+        }
+
+      node = node->child[trie_bit(key, node->plen)];
+    }
+
+  return best;
+}
+
+/****************************************************************************
+ * Name: trie_flush
+ *
+ * Description:
+ *   Free every node in the trie and mark it as needing to be rebuilt.  The
+ *   tree is flattened by rotation so that no recursion is needed.
+ *
+ ****************************************************************************/
+
+static void trie_flush(FAR struct trie_s *trie, uint8_t state)
+{
+  FAR struct trie_node_s *node = trie->root;
+  FAR struct trie_node_s *tmp;
+
+  while (node != NULL)
+    {
+      if (node->child[0] != NULL)
+        {
+          tmp            = node->child[0];
+          node->child[0] = tmp->child[1];
+          tmp->child[1]  = node;
+          node           = tmp;
+        }
+      else
+        {
+          tmp = node->child[1];
+          kmm_free(node);
+          node = tmp;
+        }
+    }
+
+  trie->root      = NULL;
+  trie->noncontig = 0;
+  trie->state     = state;
+}
+
+/****************************************************************************
+ * Name: trie_add
+ *
+ * Description:
+ *   Add one routing table entry to a populated trie.
+ *
+ ****************************************************************************/
+
+static int trie_add(FAR struct trie_s *trie, FAR const void *target,
+                    FAR const void *netmask, FAR const void *route,
+                    size_t routelen)
+{
+  int plen;
+  int ret;
+
+  plen = trie_prefixlen(netmask, trie->keylen);
+  if (plen < 0)
+    {
+      /* The trie cannot represent this route; lookups must fall back to
+       * the linear search while it is in the table.
+       */
+
+      trie->noncontig++;
+      return OK;
+    }
+
+  ret = trie_insert(trie, target, plen, route, routelen);
+  if (ret < 0)
+    {
+      nerr("ERROR: Failed to add route to trie: %d\n", ret);
+      trie_flush(trie, TRIE_FAILED);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: trie_del
+ *
+ * Description:
+ *   Remove one routing table entry from a populated trie.
+ *
+ ****************************************************************************/
+
+static void trie_del(FAR struct trie_s *trie, FAR const void *target,
+                     FAR const void *netmask)
+{
+  int plen;
+
+  plen = trie_prefixlen(netmask, trie->keylen);
+  if (plen < 0)
+    {
+      if (trie->noncontig > 0)
+        {
+          trie->noncontig--;
+        }
+    }
+  else if (trie_remove(trie, target, plen) != OK)
+    {
+      /* Either the trie is out of sync or another route with the same
+       * prefix is now the first one in the table.  Rebuild on next use.
+       */
+
+      trie_flush(trie, TRIE_EMPTY);
+    }
+}
+
+/****************************************************************************
+ * Name: trie_populate_ipv4 and trie_populate_ipv6
+ *
+ * Description:
+ *   net_foreachroute_ipv4/6() callbacks that add each routing table entry
+ *   to the trie.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static int trie_populate_ipv4(FAR struct net_route_ipv4_s *route,
+                              FAR void *arg)
+{
+  return trie_add(&g_ipv4_trie, &route->target, &route->netmask, route,
+                  sizeof(struct net_route_ipv4_s));
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static int trie_populate_ipv6(FAR struct net_route_ipv6_s *route,
+                              FAR void *arg)
+{
+  return trie_add(&g_ipv6_trie, route->target, route->netmask, route,
+                  sizeof(struct net_route_ipv6_s));
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_addtrie_ipv4 and net_addtrie_ipv6
+ *
+ * Description:
+ *   Reflect a route that was just added to the routing table in the lookup
+ *   trie.  Nothing is done if the trie has not yet been populated; it will
+ *   then be built from the routing table on the next lookup.
+ *
+ * Input Parameters:
+ *   route - The new routing table entry
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+void net_addtrie_ipv4(FAR const struct net_route_ipv4_s *route)
+{
+  net_lock();
+  if (g_ipv4_trie.state == TRIE_VALID)
+    {
+      trie_add(&g_ipv4_trie, &route->target, &route->netmask, route,
+               sizeof(struct net_route_ipv4_s));
+    }
+  else
+    {
+      /* Retry a failed build now that the table has changed */
+
+      g_ipv4_trie.state = TRIE_EMPTY;
+    }
+
+  net_unlock();
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+void net_addtrie_ipv6(FAR const struct net_route_ipv6_s *route)
+{
+  net_lock();
+  if (g_ipv6_trie.state == TRIE_VALID)
+    {
+      trie_add(&g_ipv6_trie, route->target, route->netmask, route,
+               sizeof(struct net_route_ipv6_s));
+    }
+  else
+    {
+      g_ipv6_trie.state = TRIE_EMPTY;
+    }
+
+  net_unlock();
+}
+#endif
+
+/****************************************************************************
+ * Name: net_deltrie_ipv4 and net_deltrie_ipv6
+ *
+ * Description:
+ *   Reflect a route that was just removed from the routing table in the
+ *   lookup trie.
+ *
+ * Input Parameters:
+ *   target  - The destination network of the removed route
+ *   netmask - The network mask of the removed route
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+void net_deltrie_ipv4(in_addr_t target, in_addr_t netmask)
+{
+  net_lock();
+  if (g_ipv4_trie.state == TRIE_VALID)
+    {
+      trie_del(&g_ipv4_trie, &target, &netmask);
+    }
+  else
+    {
+      g_ipv4_trie.state = TRIE_EMPTY;
+    }
+
+  net_unlock();
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+void net_deltrie_ipv6(FAR const net_ipv6addr_t target,
+                      FAR const net_ipv6addr_t netmask)
+{
+  net_lock();
+  if (g_ipv6_trie.state == TRIE_VALID)
+    {
+      trie_del(&g_ipv6_trie, target, netmask);
+    }
+  else
+    {
+      g_ipv6_trie.state = TRIE_EMPTY;
+    }
+
+  net_unlock();
+}
+#endif
+
+/****************************************************************************
+ * Name: net_lookuptrie_ipv4 and net_lookuptrie_ipv6
+ *
+ * Description:
+ *   Find the routing table entry with the longest network prefix that
+ *   contains the target address.  The trie is built from the routing table
+ *   on first use.
+ *
+ * Input Parameters:
+ *   target - The address to be routed
+ *   route  - The location to return the matching routing table entry
+ *
+ * Returned Value:
+ *   OK if a route was found; -ENOENT if there is no route for the target.
+ *   -ENOSYS is returned if the trie cannot be used (because the routing
+ *   table holds non-contiguous network masks or memory was exhausted) and
+ *   the caller must fall back to net_foreachroute_ipv4/6().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+int net_lookuptrie_ipv4(in_addr_t target,
+                        FAR struct net_route_ipv4_s *route)
+{
+  FAR struct trie_node_s *node;
+  int ret = -ENOSYS;
+
+  net_lock();
+  if (g_ipv4_trie.state == TRIE_EMPTY)
+    {
+      g_ipv4_trie.state = TRIE_VALID;
+      if (net_foreachroute_ipv4(trie_populate_ipv4, NULL) < 0)
+        {
+          trie_flush(&g_ipv4_trie, TRIE_FAILED);
+        }
+    }
+
+  if (g_ipv4_trie.state == TRIE_VALID && g_ipv4_trie.noncontig == 0)
+    {
+      node = trie_lookup(&g_ipv4_trie, (FAR const uint8_t *)&target);
+      if (node != NULL)
+        {
+          memcpy(route, &node->route.ipv4, sizeof(struct net_route_ipv4_s));
+          ret = OK;
+        }
+      else
+        {
+          ret = -ENOENT;
+        }
+    }
+
+  net_unlock();
+  return ret;
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+int net_lookuptrie_ipv6(FAR const net_ipv6addr_t target,
+                        FAR struct net_route_ipv6_s *route)
+{
+  FAR struct trie_node_s *node;
+  int ret = -ENOSYS;
+
+  net_lock();
+  if (g_ipv6_trie.state == TRIE_EMPTY)
+    {
+      g_ipv6_trie.state = TRIE_VALID;
+      if (net_foreachroute_ipv6(trie_populate_ipv6, NULL) < 0)
+        {
+          trie_flush(&g_ipv6_trie, TRIE_FAILED);
+        }
+    }
+
+  if (g_ipv6_trie.state == TRIE_VALID && g_ipv6_trie.noncontig == 0)
+    {
+      node = trie_lookup(&g_ipv6_trie, (FAR const uint8_t *)target);
+      if (node != NULL)
+        {
+          memcpy(route, &node->route.ipv6, sizeof(struct net_route_ipv6_s));
+          ret = OK;
+        }
+      else
+        {
+          ret = -ENOENT;
+        }
+    }
+
+  net_unlock();
+  return ret;
+}
+#endif
+
+#endif /* CONFIG_NET && CONFIG_ROUTE_TRIE */
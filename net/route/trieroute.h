@@ -0,0 +1,133 @@
+/****************************************************************************
+ * net/route/trieroute.h
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __NET_ROUTE_TRIEROUTE_H
+#define __NET_ROUTE_TRIEROUTE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/net/ip.h>
+
+#include "route/route.h"
+
+#ifdef CONFIG_ROUTE_TRIE
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: net_addtrie_ipv4 and net_addtrie_ipv6
+ *
+ * Description:
+ *   Reflect a route that was just added to the routing table in the lookup
+ *   trie.  Nothing is done if the trie has not yet been populated; it will
+ *   then be built from the routing table on the next lookup.
+ *
+ * Input Parameters:
+ *   route - The new routing table entry
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+void net_addtrie_ipv4(FAR const struct net_route_ipv4_s *route);
+#endif
+
+#ifdef CONFIG_NET_IPv6
+void net_addtrie_ipv6(FAR const struct net_route_ipv6_s *route);
+#endif
+
+/****************************************************************************
+ * Name: net_deltrie_ipv4 and net_deltrie_ipv6
+ *
+ * Description:
+ *   Reflect a route that was just removed from the routing table in the
+ *   lookup trie.
+ *
+ * Input Parameters:
+ *   target  - The destination network of the removed route
+ *   netmask - The network mask of the removed route
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+void net_deltrie_ipv4(in_addr_t target, in_addr_t netmask);
+#endif
+
+#ifdef CONFIG_NET_IPv6
+void net_deltrie_ipv6(FAR const net_ipv6addr_t target,
+                      FAR const net_ipv6addr_t netmask);
+#endif
+
+/****************************************************************************
+ * Name: net_lookuptrie_ipv4 and net_lookuptrie_ipv6
+ *
+ * Description:
+ *   Find the routing table entry with the longest network prefix that
+ *   contains the target address.  The trie is built from the routing table
+ *   on first use.
+ *
+ * Input Parameters:
+ *   target - The address to be routed
+ *   route  - The location to return the matching routing table entry
+ *
+ * Returned Value:
+ *   OK if a route was found; -ENOENT if there is no route for the target.
+ *   -ENOSYS is returned if the trie cannot be used (because the routing
+ *   table holds non-contiguous network masks or memory was exhausted) and
+ *   the caller must fall back to net_foreachroute_ipv4/6().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+int net_lookuptrie_ipv4(in_addr_t target,
+                        FAR struct net_route_ipv4_s *route);
+#endif
+
+#ifdef CONFIG_NET_IPv6
+int net_lookuptrie_ipv6(FAR const net_ipv6addr_t target,
+                        FAR struct net_route_ipv6_s *route);
+#endif
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_ROUTE_TRIE */
+#endif /* __NET_ROUTE_TRIEROUTE_H */
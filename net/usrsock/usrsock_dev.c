@@ -53,7 +53,10 @@
 #include <arch/irq.h>
 
 #include <nuttx/random.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/usrsock.h>
@@ -69,6 +72,39 @@
 #  define CONFIG_NET_USRSOCKDEV_NPOLLWAITERS 1
 #endif
 
+#ifdef CONFIG_NET_USRSOCK_RING
+#  define RING_SLOTSIZE  CONFIG_NET_USRSOCK_RING_SLOTSIZE
+#  define RING_SQSLOTS   CONFIG_NET_USRSOCK_RING_SQSLOTS
+#  define RING_CQSLOTS   CONFIG_NET_USRSOCK_RING_CQSLOTS
+
+#  if (RING_SLOTSIZE & 7) != 0
+#    error "CONFIG_NET_USRSOCK_RING_SLOTSIZE must be a multiple of 8"
+#  endif
+
+/* The slot arrays follow the ring header, 8-byte aligned */
+
+#  define RING_SQOFFSET  ((sizeof(struct usrsock_ring_s) + 7) & ~7)
+#  define RING_CQOFFSET  (RING_SQOFFSET + RING_SQSLOTS * RING_SLOTSIZE)
+#  define RING_SIZE      (RING_CQOFFSET + RING_CQSLOTS * RING_SLOTSIZE)
+
+/* Number of slots occupied by a message of 'len' bytes */
+
+#  define RING_NSLOTS(len) \
+     ((sizeof(struct usrsock_ring_entry_s) + (len) + RING_SLOTSIZE - 1) / \
+      RING_SLOTSIZE)
+
+/* Slot contents must be visible to the other side before the updated
+ * head/tail index.  On a single CPU the daemon can only run after a
+ * context switch, which already orders the accesses.
+ */
+
+#  ifdef CONFIG_SPINLOCK
+#    define RING_BARRIER() SP_DMB()
+#  else
+#    define RING_BARRIER()
+#  endif
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -94,6 +130,15 @@ struct usrsockdev_s
   FAR struct usrsock_conn_s *datain_conn; /* Connection instance to receive
                                            * data buffers. */
   struct pollfd *pollfds[CONFIG_NET_USRSOCKDEV_NPOLLWAITERS];
+
+#ifdef CONFIG_NET_USRSOCK_RING
+  struct
+  {
+    FAR struct usrsock_ring_s *shm; /* Shared ring, kept until unloaded */
+    bool    active;                 /* Ring mode (false: read/write mode) */
+    sem_t   sqsem;                  /* Waits for free submission slots */
+  } ring;
+#endif
 };
 
 /****************************************************************************
@@ -115,6 +160,11 @@ static int usrsockdev_open(FAR struct file *filep);
 
 static int usrsockdev_close(FAR struct file *filep);
 
+#ifdef CONFIG_NET_USRSOCK_RING
+static int usrsockdev_ioctl(FAR struct file *filep, int cmd,
+                            unsigned long arg);
+#endif
+
 static int usrsockdev_poll(FAR struct file *filep, FAR struct pollfd *fds,
                            bool setup);
 
@@ -129,7 +179,11 @@ static const struct file_operations g_usrsockdevops =
   usrsockdev_read,    /* read */
   usrsockdev_write,   /* write */
   usrsockdev_seek,    /* seek */
+#ifdef CONFIG_NET_USRSOCK_RING
+  usrsockdev_ioctl,   /* ioctl */
+#else
   NULL,               /* ioctl */
+#endif
   usrsockdev_poll     /* poll */
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
   , NULL              /* unlink */
@@ -825,40 +879,21 @@ static ssize_t usrsockdev_handle_message(FAR struct usrsockdev_s *dev,
 }
 
 /****************************************************************************
- * Name: usrsockdev_write
+ * Name: usrsockdev_handle_write
+ *
+ * Description:
+ *   Process a buffer of messages and data written by the daemon, either
+ *   through write() or through the completion ring.
+ *
  ****************************************************************************/
 
-static ssize_t usrsockdev_write(FAR struct file *filep,
-                                FAR const char *buffer, size_t len)
+static ssize_t usrsockdev_handle_write(FAR struct usrsockdev_s *dev,
+                                       FAR const char *buffer, size_t len)
 {
-  FAR struct inode *inode = filep->f_inode;
   FAR struct usrsock_conn_s *conn;
-  FAR struct usrsockdev_s *dev;
   size_t origlen = len;
   ssize_t ret = 0;
 
-  if (len == 0)
-    {
-      return 0;
-    }
-
-  if (buffer == NULL)
-    {
-      return -EINVAL;
-    }
-
-  DEBUGASSERT(inode);
-
-  dev = inode->i_private;
-
-  DEBUGASSERT(dev);
-
-  ret = (ssize_t)usrsockdev_semtake(&dev->devsem);
-  if (ret < 0)
-    {
-      return ret;
-    }
-
   if (!dev->datain_conn)
     {
       /* Start of message, buffer length should be at least size of common
@@ -923,10 +958,376 @@ static ssize_t usrsockdev_write(FAR struct file *filep,
     }
 
 errout:
+  return ret;
+}
+
+/****************************************************************************
+ * Name: usrsockdev_write
+ ****************************************************************************/
+
+static ssize_t usrsockdev_write(FAR struct file *filep,
+                                FAR const char *buffer, size_t len)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct usrsockdev_s *dev;
+  ssize_t ret;
+
+  if (len == 0)
+    {
+      return 0;
+    }
+
+  if (buffer == NULL)
+    {
+      return -EINVAL;
+    }
+
+  DEBUGASSERT(inode);
+
+  dev = inode->i_private;
+
+  DEBUGASSERT(dev);
+
+  ret = (ssize_t)usrsockdev_semtake(&dev->devsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  ret = usrsockdev_handle_write(dev, buffer, len);
+
   usrsockdev_semgive(&dev->devsem);
   return ret;
 }
 
+#ifdef CONFIG_NET_USRSOCK_RING
+/****************************************************************************
+ * Name: usrsockdev_ring_wakeup
+ *
+ * Description:
+ *   Wake up all requesters waiting for free submission slots.
+ *
+ ****************************************************************************/
+
+static void usrsockdev_ring_wakeup(FAR struct usrsockdev_s *dev)
+{
+  int sval;
+
+  while (nxsem_get_value(&dev->ring.sqsem, &sval) >= 0 && sval < 0)
+    {
+      nxsem_post(&dev->ring.sqsem);
+    }
+}
+
+/****************************************************************************
+ * Name: usrsockdev_ring_map
+ *
+ * Description:
+ *   Allocate the shared ring on the first mmap() and switch the device to
+ *   ring mode.  The ring is never freed, so a mapping left behind by a
+ *   previous daemon stays valid; it is reset and handed out again instead.
+ *
+ * Assumptions:
+ *   The device semaphore and the network lock are held.
+ *
+ ****************************************************************************/
+
+static int usrsockdev_ring_map(FAR struct usrsockdev_s *dev,
+                               FAR void **addr)
+{
+  FAR struct usrsock_ring_s *shm = dev->ring.shm;
+
+  if (!dev->ring.active)
+    {
+      /* Do not switch transports underneath requests that are queued for
+       * the daemon to read() or responses that are partially written.
+       */
+
+      if (dev->req.nbusy > 0 || dev->datain_conn != NULL)
+        {
+          return -EBUSY;
+        }
+
+      /* The ring is accessed directly by the daemon */
+
+      if (shm == NULL)
+        {
+          shm = (FAR struct usrsock_ring_s *)kumm_malloc(RING_SIZE);
+          if (shm == NULL)
+            {
+              return -ENOMEM;
+            }
+
+          dev->ring.shm = shm;
+        }
+
+      memset(shm, 0, RING_SIZE);
+      shm->magic     = USRSOCK_RING_MAGIC;
+      shm->slotsize  = RING_SLOTSIZE;
+      shm->sq_nslots = RING_SQSLOTS;
+      shm->cq_nslots = RING_CQSLOTS;
+      shm->sq_offset = RING_SQOFFSET;
+      shm->cq_offset = RING_CQOFFSET;
+
+      dev->ring.active = true;
+    }
+
+  *addr = shm;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: usrsockdev_ring_doorbell
+ *
+ * Description:
+ *   Process all messages that the daemon has placed in the completion
+ *   queue.
+ *
+ * Returned Value:
+ *   The number of messages processed, or a negated errno value if the
+ *   queue is corrupt or any of the messages could not be handled.  All
+ *   valid messages are consumed in either case.
+ *
+ * Assumptions:
+ *   The device semaphore and the network lock are held.
+ *
+ ****************************************************************************/
+
+static int usrsockdev_ring_doorbell(FAR struct usrsockdev_s *dev)
+{
+  FAR struct usrsock_ring_s *shm = dev->ring.shm;
+  FAR struct usrsock_ring_entry_s *entry;
+  FAR uint8_t *slots;
+  uint32_t head;
+  uint32_t tail;
+  uint32_t slot;
+  uint32_t len;
+  ssize_t nwritten;
+  int count = 0;
+  int ret = OK;
+
+  if (!dev->ring.active)
+    {
+      return -ENXIO;
+    }
+
+  slots = (FAR uint8_t *)shm + RING_CQOFFSET;
+  head  = shm->cq_head;
+  tail  = shm->cq_tail;
+
+  if (head - tail > RING_CQSLOTS)
+    {
+      nwarn("bad CQ indices, head=%u tail=%u\n", head, tail);
+      shm->cq_tail = head;
+      return -EINVAL;
+    }
+
+  RING_BARRIER();
+
+  while (tail != head)
+    {
+      slot  = tail % RING_CQSLOTS;
+      entry = (FAR struct usrsock_ring_entry_s *)
+              &slots[slot * RING_SLOTSIZE];
+      len   = entry->len;
+
+      if (len == USRSOCK_RING_ENTRY_PAD)
+        {
+          tail += RING_CQSLOTS - slot;
+          continue;
+        }
+
+      if (len < sizeof(struct usrsock_message_common_s) ||
+          len > (RING_CQSLOTS - slot) * RING_SLOTSIZE -
+                sizeof(struct usrsock_ring_entry_s))
+        {
+          nwarn("bad CQ entry, slot=%u len=%u\n", slot, len);
+          tail = head;
+          ret  = -EINVAL;
+          break;
+        }
+
+      /* Responses carry their data payload in the same entry */
+
+      nwritten = usrsockdev_handle_write(dev, (FAR const char *)(entry + 1),
+                                         len);
+      if (nwritten < 0 || (size_t)nwritten != len)
+        {
+          nwarn("bad CQ message, slot=%u len=%u ret=%zd\n",
+                slot, len, nwritten);
+          ret = nwritten < 0 ? (int)nwritten : -EINVAL;
+        }
+
+      if (dev->datain_conn != NULL)
+        {
+          FAR struct usrsock_conn_s *conn = dev->datain_conn;
+
+          nwarn("truncated data response, usockid=%d\n", conn->usockid);
+
+          dev->datain_conn  = NULL;
+          conn->resp.result = -EINVAL;
+          usrsock_event(conn, USRSOCK_EVENT_REQ_COMPLETE);
+          ret = -EINVAL;
+        }
+
+      tail += RING_NSLOTS(len);
+      count++;
+    }
+
+  shm->cq_tail = tail;
+
+  /* The daemon also rings the doorbell after freeing submission slots */
+
+  usrsockdev_ring_wakeup(dev);
+  return ret < 0 ? ret : count;
+}
+
+/****************************************************************************
+ * Name: usrsockdev_ring_submit
+ *
+ * Description:
+ *   Copy a request into the submission queue and signal the daemon if it
+ *   may be waiting for work.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static int usrsockdev_ring_submit(FAR struct usrsockdev_s *dev,
+                                  FAR const struct iovec *iov,
+                                  unsigned int iovcnt)
+{
+  FAR struct usrsock_ring_s *shm;
+  FAR struct usrsock_ring_entry_s *entry;
+  FAR uint8_t *slots;
+  uint32_t nslots;
+  uint32_t head;
+  uint32_t slot;
+  uint32_t pad;
+  size_t len = 0;
+  unsigned int i;
+
+  for (i = 0; i < iovcnt; i++)
+    {
+      len += iov[i].iov_len;
+    }
+
+  nslots = RING_NSLOTS(len);
+  if (nslots > RING_SQSLOTS)
+    {
+      return -EMSGSIZE;
+    }
+
+  for (; ; )
+    {
+      shm = dev->ring.shm;
+      if (!dev->ring.active || !usrsockdev_is_opened(dev))
+        {
+          return -ENETDOWN;
+        }
+
+      /* Messages never wrap around the end of the queue */
+
+      head = shm->sq_head;
+      slot = head % RING_SQSLOTS;
+      pad  = (slot + nslots > RING_SQSLOTS) ? RING_SQSLOTS - slot : 0;
+
+      if (RING_SQSLOTS - (head - shm->sq_tail) >= pad + nslots)
+        {
+          break;
+        }
+
+      /* Wait for the daemon to consume submissions and ring the doorbell */
+
+      net_lockedwait_uninterruptible(&dev->ring.sqsem);
+    }
+
+  slots = (FAR uint8_t *)shm + RING_SQOFFSET;
+
+  if (pad > 0)
+    {
+      entry = (FAR struct usrsock_ring_entry_s *)
+              &slots[slot * RING_SLOTSIZE];
+      entry->len = USRSOCK_RING_ENTRY_PAD;
+      head += pad;
+      slot  = 0;
+    }
+
+  entry = (FAR struct usrsock_ring_entry_s *)&slots[slot * RING_SLOTSIZE];
+  entry->len = len;
+  iovec_get(entry + 1, len, iov, iovcnt, 0);
+
+  RING_BARRIER();
+
+  /* Only the transition from empty needs a wake-up; a daemon that is
+   * still draining the queue will find the new request by itself.
+   */
+
+  if (shm->sq_tail == shm->sq_head)
+    {
+      shm->sq_head = head + nslots;
+      usrsockdev_pollnotify(dev, POLLIN);
+    }
+  else
+    {
+      shm->sq_head = head + nslots;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: usrsockdev_ioctl
+ ****************************************************************************/
+
+static int usrsockdev_ioctl(FAR struct file *filep, int cmd,
+                            unsigned long arg)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct usrsockdev_s *dev;
+  int ret;
+
+  DEBUGASSERT(inode);
+
+  dev = inode->i_private;
+
+  DEBUGASSERT(dev);
+
+  ret = usrsockdev_semtake(&dev->devsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  net_lock();
+
+  switch (cmd)
+    {
+      case FIOC_MMAP:  /* Map the shared ring */
+        {
+          FAR void **addr = (FAR void **)((uintptr_t)arg);
+
+          DEBUGASSERT(addr != NULL);
+          ret = usrsockdev_ring_map(dev, addr);
+        }
+        break;
+
+      case USRSOCKIOC_RING_DOORBELL:  /* Process completions */
+        ret = usrsockdev_ring_doorbell(dev);
+        break;
+
+      default:
+        ret = -ENOTTY;
+        break;
+    }
+
+  net_unlock();
+  usrsockdev_semgive(&dev->devsem);
+  return ret;
+}
+#endif /* CONFIG_NET_USRSOCK_RING */
+
 /****************************************************************************
  * Name: usrsockdev_open
  ****************************************************************************/
@@ -1023,6 +1424,16 @@ static int usrsockdev_close(FAR struct file *filep)
   DEBUGASSERT(dev->ocount == 0);
   ret = OK;
 
+#ifdef CONFIG_NET_USRSOCK_RING
+  /* Leave ring mode and release any requesters waiting for slots.  The
+   * ring itself is not freed: munmap() does not reach the driver, so the
+   * daemon may still have it mapped.  The next mmap() resets and reuses it.
+   */
+
+  dev->ring.active = false;
+  usrsockdev_ring_wakeup(dev);
+#endif
+
   do
     {
       /* Give other threads short time window to complete recently completed
@@ -1137,6 +1548,14 @@ static int usrsockdev_poll(FAR struct file *filep, FAR struct pollfd *fds,
 
       /* Notify the POLLIN event if pending request. */
 
+#ifdef CONFIG_NET_USRSOCK_RING
+      if (dev->ring.active &&
+          dev->ring.shm->sq_head != dev->ring.shm->sq_tail)
+        {
+          eventset |= POLLIN;
+        }
+#endif
+
       if (dev->req.iov != NULL &&
           !(iovec_get(NULL, 0, dev->req.iov,
                       dev->req.iovcnt, dev->req.pos) < 0))
@@ -1211,6 +1630,18 @@ int usrsockdev_do_request(FAR struct usrsock_conn_s *conn,
   conn->resp.xid = req_head->xid;
   conn->resp.result = -EACCES;
 
+#ifdef CONFIG_NET_USRSOCK_RING
+  if (dev->ring.active)
+    {
+      /* The request is copied into the ring, so there is no need to wait
+       * for the daemon to pick it up.  The response is delivered through
+       * the usual connection callbacks.
+       */
+
+      return usrsockdev_ring_submit(dev, iov, iovcnt);
+    }
+#endif
+
   ++dev->req.nbusy; /* net_lock held. */
 
   /* Set outstanding request for daemon to handle. */
@@ -1267,6 +1698,13 @@ void usrsockdev_register(void)
   nxsem_init(&g_usrsockdev.req.acksem, 0, 0);
   nxsem_set_protocol(&g_usrsockdev.req.acksem, SEM_PRIO_NONE);
 
+#ifdef CONFIG_NET_USRSOCK_RING
+  g_usrsockdev.ring.shm = NULL;
+  g_usrsockdev.ring.active = false;
+  nxsem_init(&g_usrsockdev.ring.sqsem, 0, 0);
+  nxsem_set_protocol(&g_usrsockdev.ring.sqsem, SEM_PRIO_NONE);
+#endif
+
   register_driver("/dev/usrsock", &g_usrsockdevops, 0666,
                   &g_usrsockdev);
 }
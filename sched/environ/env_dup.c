@@ -43,6 +43,7 @@
 
 #include <sys/types.h>
 #include <sched.h>
+#include <stdint.h>
 #include <string.h>
 #include <errno.h>
 
@@ -59,13 +60,14 @@
  * Name: env_dup
  *
  * Description:
- *   Copy the internal environment structure of a task.  This is the action
- *   that is performed when a new task is created: The new task has a private,
- *   exact duplicate of the parent task's environment.
+ *   Inherit the internal environment structure of a task.  This is the
+ *   action that is performed when a new task is created: The new task
+ *   shares the parent task's environment until either of them changes it.
+ *   Then that task gets a private, exact duplicate (see env_unshare()).
  *
  * Input Parameters:
- *   group - The child task group to receive the newly allocated copy of the
- *           parent task groups environment structure.
+ *   group - The child task group to receive the parent task groups
+ *           environment structure.
  *
  * Returned Value:
  *   zero on success
@@ -78,8 +80,8 @@
 int env_dup(FAR struct task_group_s *group)
 {
   FAR struct tcb_s *ptcb = this_task();
-  FAR char *envp = NULL;
-  size_t envlen;
+  FAR struct task_group_s *pgroup;
+  FAR struct env_header_s *hdr;
   int ret = OK;
 
   DEBUGASSERT(group != NULL && ptcb != NULL && ptcb->group != NULL);
@@ -92,48 +94,146 @@ int env_dup(FAR struct task_group_s *group)
 
   /* Does the parent task have an environment? */
 
-  if (ptcb->group != NULL && ptcb->group->tg_envp != NULL)
+  pgroup = ptcb->group;
+  if (pgroup != NULL && pgroup->tg_envp != NULL)
     {
-      /* Yes.. The parent task has an environment allocation. */
-
-      envlen = ptcb->group->tg_envsize;
-      envp   = NULL;
-
-      /* A special case is that the parent has an "empty" environment
-       * allocation, i.e., there is an allocation in place but it
-       * contains no variable definitions and, hence, envlen == 0.
-       */
+      /* Yes.. Share it, unless the reference count would overflow */
 
-      if (envlen > 0)
+      hdr = ENV_HEADER(pgroup->tg_envp);
+      if (hdr->eh_crefs < UINT16_MAX)
         {
-          /* There is an environment, duplicate it */
-
-          envp = (FAR char *)kumm_malloc(envlen);
-          if (envp == NULL)
-            {
-              /* The parent's environment can not be inherited due to a
-               * failure in the allocation of the child environment.
-               */
+          hdr->eh_crefs++;
+          group->tg_envsize = pgroup->tg_envsize;
+          group->tg_envp    = pgroup->tg_envp;
+        }
+      else
+        {
+          /* Make a private copy instead.  If it cannot be allocated, the
+           * parent's environment is not inherited.
+           */
 
-              envlen = 0;
-              ret    = -ENOMEM;
-            }
-          else
+          ret = env_realloc(group, pgroup->tg_envsize);
+          if (ret >= 0)
             {
-              /* Duplicate the parent environment. */
-
-              memcpy(envp, ptcb->group->tg_envp, envlen);
+              memcpy(group->tg_envp, pgroup->tg_envp, pgroup->tg_envsize);
             }
         }
+    }
 
-      /* Save the size and child environment allocation. */
+  sched_unlock();
+  return ret;
+}
 
-      group->tg_envsize = envlen;
+/****************************************************************************
+ * Name: env_unshare
+ *
+ * Description:
+ *   Make sure that the environment of the task group is not shared with
+ *   any other task group.  This must be called before the environment
+ *   strings are modified in place.
+ *
+ * Input Parameters:
+ *   group - The task group whose environment will be modified.
+ *
+ * Returned Value:
+ *   Zero on success; -ENOMEM if the private copy cannot be allocated.
+ *
+ * Assumptions:
+ *   - Not called from an interrupt handler
+ *   - Caller has pre-emption disabled
+ *
+ ****************************************************************************/
+
+int env_unshare(FAR struct task_group_s *group)
+{
+  FAR struct env_header_s *hdr;
+  FAR char *envp;
+  size_t envlen;
+  int ret;
+
+  DEBUGASSERT(group != NULL);
+
+  envp = group->tg_envp;
+  if (envp == NULL || ENV_HEADER(envp)->eh_crefs <= 1)
+    {
+      /* Nothing to share or already private */
+
+      return OK;
+    }
+
+  /* Allocate a private copy of the shared environment */
+
+  envlen          = group->tg_envsize;
+  group->tg_envp  = NULL;
+
+  ret = env_realloc(group, envlen);
+  if (ret < 0)
+    {
       group->tg_envp    = envp;
+      group->tg_envsize = envlen;
+      return ret;
     }
 
-  sched_unlock();
-  return ret;
+  memcpy(group->tg_envp, envp, envlen);
+
+  /* And drop this task group's reference to the shared copy */
+
+  hdr = ENV_HEADER(envp);
+  hdr->eh_crefs--;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: env_realloc
+ *
+ * Description:
+ *   Allocate or resize the private environment of the task group.  The
+ *   existing environment strings are preserved up to the new size.
+ *
+ * Input Parameters:
+ *   group   - The task group with the environment to be resized.  Its
+ *             environment must not be shared (see env_unshare()).
+ *   newsize - The new size of the environment strings in bytes.
+ *
+ * Returned Value:
+ *   Zero on success; -ENOMEM if the allocation fails.  The environment is
+ *   unchanged in that case.
+ *
+ * Assumptions:
+ *   - Not called from an interrupt handler
+ *   - Caller has pre-emption disabled
+ *
+ ****************************************************************************/
+
+int env_realloc(FAR struct task_group_s *group, size_t newsize)
+{
+  FAR struct env_header_s *hdr;
+
+  DEBUGASSERT(group != NULL);
+
+  if (group->tg_envp != NULL)
+    {
+      DEBUGASSERT(ENV_HEADER(group->tg_envp)->eh_crefs == 1);
+      hdr = (FAR struct env_header_s *)
+        kumm_realloc(ENV_HEADER(group->tg_envp), ENV_HDRSIZE + newsize);
+    }
+  else
+    {
+      hdr = (FAR struct env_header_s *)kumm_malloc(ENV_HDRSIZE + newsize);
+      if (hdr != NULL)
+        {
+          hdr->eh_crefs = 1;
+        }
+    }
+
+  if (hdr == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  group->tg_envp    = (FAR char *)hdr + ENV_HDRSIZE;
+  group->tg_envsize = newsize;
+  return OK;
 }
 
 #endif /* CONFIG_DISABLE_ENVIRON */
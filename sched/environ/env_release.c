@@ -56,10 +56,11 @@
  * Name: env_release
  *
  * Description:
- *   env_release() is called only from group_leave() when the last member of
- *   a task group exits.  The env_release() function clears the environment
- *   of all name-value pairs and sets the value of the external variable
- *   environ to NULL.
+ *   env_release() is called from group_leave() when the last member of
+ *   a task group exits and from clearenv().  The env_release() function
+ *   clears the environment of all name-value pairs and sets the value of
+ *   the external variable environ to NULL.  The environment strings are
+ *   freed when no other task group shares them.
  *
  * Input Parameters:
  *   group - Identifies the task group containing the environment structure
@@ -77,13 +78,21 @@ void env_release(FAR struct task_group_s *group)
 {
   DEBUGASSERT(group != NULL);
 
-  /* Free any allocate environment strings */
+  /* Free any allocate environment strings that are no longer shared with
+   * another task group.
+   */
 
+  sched_lock();
   if (group->tg_envp)
     {
-      /* Free the environment */
+      FAR struct env_header_s *hdr = ENV_HEADER(group->tg_envp);
+
+      /* Free the environment when the last reference is dropped */
 
-      kumm_free(group->tg_envp);
+      if (--hdr->eh_crefs == 0)
+        {
+          kumm_free(hdr);
+        }
     }
 
   /* In any event, make sure that all environment-related variables in the
@@ -92,6 +101,7 @@ void env_release(FAR struct task_group_s *group)
 
   group->tg_envsize = 0;
   group->tg_envp = NULL;
+  sched_unlock();
 }
 
 #endif /* CONFIG_DISABLE_ENVIRON */
@@ -84,8 +84,7 @@ int setenv(FAR const char *name, FAR const char *value, int overwrite)
   FAR struct tcb_s *rtcb;
   FAR struct task_group_s *group;
   FAR char *pvar;
-  FAR char *newenvp;
-  int newsize;
+  size_t oldsize;
   int varlen;
   int ret = OK;
 
@@ -126,6 +125,7 @@ int setenv(FAR const char *name, FAR const char *value, int overwrite)
 
   /* Check if the variable already exists */
 
+  pvar = NULL;
   if (group->tg_envp && (pvar = env_findvar(group, name)) != NULL)
     {
       /* It does! Do we have permission to overwrite the existing value? */
@@ -137,12 +137,27 @@ int setenv(FAR const char *name, FAR const char *value, int overwrite)
           sched_unlock();
           return OK;
         }
+    }
+
+  /* The environment is about to be changed.  Get a private copy if it is
+   * still shared with another task group.
+   */
+
+  ret = env_unshare(group);
+  if (ret < 0)
+    {
+      ret = -ret;
+      goto errout_with_lock;
+    }
 
-      /* Yes.. just remove the name=value pair from the environment.  It will
-       * be added again below.  Note that we are responsible for reallocating
-       * the environment buffer; this will happen below.
+  if (pvar != NULL)
+    {
+      /* Remove the name=value pair from the (possibly new) environment.  It
+       * will be added again below.  Note that we are responsible for
+       * reallocating the environment buffer; this will happen below.
        */
 
+      pvar = env_findvar(group, name);
       env_removevar(group, pvar);
     }
 
@@ -154,35 +169,15 @@ int setenv(FAR const char *name, FAR const char *value, int overwrite)
 
   /* Then allocate or reallocate the environment buffer */
 
-  if (group->tg_envp)
-    {
-      newsize = group->tg_envsize + varlen;
-      newenvp = (FAR char *)kumm_realloc(group->tg_envp, newsize);
-      if (!newenvp)
-        {
-          ret = ENOMEM;
-          goto errout_with_lock;
-        }
-
-      pvar = &newenvp[group->tg_envsize];
-    }
-  else
+  oldsize = group->tg_envsize;
+  ret = env_realloc(group, oldsize + varlen);
+  if (ret < 0)
     {
-      newsize = varlen;
-      newenvp = (FAR char *)kumm_malloc(varlen);
-      if (!newenvp)
-        {
-          ret = ENOMEM;
-          goto errout_with_lock;
-        }
-
-      pvar = newenvp;
+      ret = -ret;
+      goto errout_with_lock;
     }
 
-  /* Save the new buffer and size */
-
-  group->tg_envp    = newenvp;
-  group->tg_envsize = newsize;
+  pvar = &group->tg_envp[oldsize];
 
   /* Now, put the new name=value string into the environment buffer */
 
@@ -77,8 +77,7 @@ int unsetenv(FAR const char *name)
   FAR struct tcb_s *rtcb = this_task();
   FAR struct task_group_s *group = rtcb->group;
   FAR char *pvar;
-  FAR char *newenvp;
-  int newsize;
+  size_t newsize;
   int ret = OK;
 
   DEBUGASSERT(name && group);
@@ -88,43 +87,42 @@ int unsetenv(FAR const char *name)
   sched_lock();
   if (group && (pvar = env_findvar(group, name)) != NULL)
     {
-      /* It does!  Remove the name=value pair from the environment. */
+      /* It does!  Get a private copy of the environment if it is still
+       * shared with another task group.
+       */
 
+      ret = env_unshare(group);
+      if (ret < 0)
+        {
+          sched_unlock();
+          set_errno(-ret);
+          return ERROR;
+        }
+
+      /* Remove the name=value pair from the environment. */
+
+      pvar = env_findvar(group, name);
       env_removevar(group, pvar);
 
       /* Reallocate the new environment buffer */
 
       newsize = group->tg_envsize;
-      if (newsize <= 0)
+      if (newsize == 0)
         {
           /* Free the old environment (if there was one) */
 
-          if (group->tg_envp != NULL)
-            {
-              kumm_free(group->tg_envp);
-              group->tg_envp = NULL;
-            }
-
-          group->tg_envsize = 0;
+          env_release(group);
         }
       else
         {
           /* Reallocate the environment to reclaim a little memory */
 
-          newenvp = (FAR char *)kumm_realloc(group->tg_envp, newsize);
-          if (newenvp == NULL)
+          ret = env_realloc(group, newsize);
+          if (ret < 0)
             {
-              set_errno(ENOMEM);
+              set_errno(-ret);
               ret = ERROR;
             }
-          else
-            {
-              /* Save the new environment pointer (it might have changed due
-               * to reallocation).
-               */
-
-              group->tg_envp = newenvp;
-            }
         }
     }
 
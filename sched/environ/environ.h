@@ -42,6 +42,9 @@
  ****************************************************************************/
 
 #include <nuttx/config.h>
+
+#include <stdint.h>
+
 #include <nuttx/sched.h>
 
 /****************************************************************************
@@ -53,6 +56,26 @@
 #  define env_release(group) (0)
 #else
 
+/* The environment strings are preceded in their allocation by a header */
+
+#define ENV_HDRSIZE          sizeof(struct env_header_s)
+#define ENV_HEADER(envp)     \
+  ((FAR struct env_header_s *)((FAR char *)(envp) - ENV_HDRSIZE))
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* A new task group shares the environment strings of its parent until one
+ * of them changes its environment.  Only then does that task group get a
+ * private copy.  Most spawned tasks never change their environment.
+ */
+
+struct env_header_s
+{
+  uint16_t eh_crefs;                 /* Number of task groups sharing it */
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -73,9 +96,9 @@ extern "C"
  * Name: env_dup
  *
  * Description:
- *   Copy the internal environment structure of a task.  This is the action
- *   that is performed when a new task is created: The new task has a private,
- *   exact duplicate of the parent task's environment.
+ *   Inherit the internal environment structure of a task.  This is the
+ *   action that is performed when a new task is created: The new task
+ *   shares the parent task's environment until either of them changes it.
  *
  * Input Parameters:
  *   group - The child task group to receive the newly allocated copy of the
@@ -91,14 +114,61 @@ extern "C"
 
 int env_dup(FAR struct task_group_s *group);
 
+/****************************************************************************
+ * Name: env_unshare
+ *
+ * Description:
+ *   Make sure that the environment of the task group is not shared with
+ *   any other task group.  This must be called before the environment
+ *   strings are modified in place.
+ *
+ * Input Parameters:
+ *   group - The task group whose environment will be modified.
+ *
+ * Returned Value:
+ *   Zero on success; -ENOMEM if the private copy cannot be allocated.
+ *
+ * Assumptions:
+ *   - Not called from an interrupt handler
+ *   - Caller has pre-emption disabled
+ *
+ ****************************************************************************/
+
+int env_unshare(FAR struct task_group_s *group);
+
+/****************************************************************************
+ * Name: env_realloc
+ *
+ * Description:
+ *   Allocate or resize the private environment of the task group.  The
+ *   existing environment strings are preserved up to the new size.
+ *
+ * Input Parameters:
+ *   group   - The task group with the environment to be resized.  Its
+ *             environment must not be shared (see env_unshare()).
+ *   newsize - The new size of the environment strings in bytes.
+ *
+ * Returned Value:
+ *   Zero on success; -ENOMEM if the allocation fails.  The environment is
+ *   unchanged in that case.
+ *
+ * Assumptions:
+ *   - Not called from an interrupt handler
+ *   - Caller has pre-emption disabled
+ *
+ ****************************************************************************/
+
+int env_realloc(FAR struct task_group_s *group, size_t newsize);
+
 /****************************************************************************
  * Name: env_release
  *
  * Description:
- *   env_release() is called only from group_leave() when the last member of
- *   a task group exits.  The env_release() function clears the environment
- *   of all name-value pairs and sets the value of the external variable
- *   environ to NULL.
+ *   env_release() is called from group_leave() when the last member of
+ *   a task group exits and from clearenv().  The env_release() function
+ *   clears the environment of all name-value pairs and sets the value of
+ *   the external variable environ to NULL.  The environment strings are
+ *   freed when no other task group shares them.
  *
  * Input Parameters:
  *   group - Identifies the task group containing the environment structure
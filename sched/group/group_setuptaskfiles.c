@@ -74,6 +74,8 @@ static inline void sched_dupfiles(FAR struct task_tcb_s *tcb)
   /* The parent task is the one at the head of the ready-to-run list */
 
   FAR struct tcb_s *rtcb = this_task();
+  FAR struct filelist *plist;
+  FAR struct filelist *clist;
   FAR struct file *parent;
   FAR struct file *child;
   int i;
@@ -88,8 +90,8 @@ static inline void sched_dupfiles(FAR struct task_tcb_s *tcb)
 
   /* Get pointers to the parent and child task file lists */
 
-  parent = rtcb->group->tg_filelist.fl_files;
-  child  = tcb->cmn.group->tg_filelist.fl_files;
+  plist = &rtcb->group->tg_filelist;
+  clist = &tcb->cmn.group->tg_filelist;
 
   /* Check each file in the parent file list */
 
@@ -97,15 +99,23 @@ static inline void sched_dupfiles(FAR struct task_tcb_s *tcb)
     {
       /* Check if this file is opened by the parent.  We can tell if
        * if the file is open because it contain a reference to a non-NULL
-       * i-node structure.
+       * i-node structure.  Descriptors in blocks that the parent never
+       * allocated cannot be open.
        */
 
-      if (parent[i].f_inode &&
-          (parent[i].f_oflags & O_CLOEXEC) == 0)
+      parent = files_fget(plist, i);
+      if (parent != NULL && parent->f_inode &&
+          (parent->f_oflags & O_CLOEXEC) == 0)
         {
-          /* Yes... duplicate it for the child */
-
-          file_dup2(&parent[i], &child[i]);
+          /* Yes... reserve the same descriptor in the child and duplicate
+           * it.
+           */
+
+          if (files_reserve(clist, i, &child) >= 0 &&
+              file_dup2(parent, child) < 0)
+            {
+              files_unreserve(clist, i);
+            }
         }
     }
 }
@@ -139,6 +139,12 @@ void irq_dispatch(int irq, FAR void *context)
   FAR void *arg = NULL;
   unsigned int ndx = irq;
 
+#ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
+  /* Charge the time up to now to the interrupted thread */
+
+  nxsched_irq_cpuload(true);
+#endif
+
 #if NR_IRQS > 0
   if ((unsigned)irq < NR_IRQS)
     {
@@ -189,6 +195,12 @@ void irq_dispatch(int irq, FAR void *context)
   sched_note_irqhandler(irq, vector, false);
 #endif
 
+#ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
+  /* Charge the time spent in the handler to interrupt processing */
+
+  nxsched_irq_cpuload(false);
+#endif
+
   /* Record the new "running" task.  g_running_tasks[] is only used by
    * assertion logic for reporting crashes.
    */
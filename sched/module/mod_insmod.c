@@ -47,6 +47,7 @@
 #include <debug.h>
 
 #include <nuttx/arch.h>
+#include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/module.h>
 #include <nuttx/lib/modlib.h>
@@ -175,6 +176,9 @@ FAR void *insmod(FAR const char *filename, FAR const char *modname)
   struct mod_loadinfo_s loadinfo;
   FAR struct module_s *modp;
   mod_initializer_t initializer;
+#ifdef CONFIG_DEBUG_BINFMT_INFO
+  clock_t start = clock_systime_ticks();
+#endif
   int ret;
 
   DEBUGASSERT(filename != NULL && modname != NULL);
@@ -272,6 +276,9 @@ FAR void *insmod(FAR const char *filename, FAR const char *modname)
 
   modlib_uninitialize(&loadinfo);
   modlib_registry_unlock();
+
+  binfo("Loaded %s in %lu ms\n", modname,
+        (unsigned long)TICK2MSEC(clock_systime_ticks() - start));
   return (FAR void *)modp;
 
 errout_with_load:
@@ -56,6 +56,16 @@ void nxmq_free_msg(FAR struct mqueue_msg_s *mqmsg)
 {
   irqstate_t flags;
 
+#ifdef CONFIG_MQ_ZEROCOPY
+  /* Release a zero-copy buffer that was never handed to a receiver */
+
+  if (mqmsg->buffer != NULL)
+    {
+      kumm_free(mqmsg->buffer);
+      mqmsg->buffer = NULL;
+    }
+#endif
+
   /* If this is a generally available pre-allocated message,
    * then just put it back in the free list.
    */
@@ -101,6 +101,8 @@ int nxmq_verify_receive(mqd_t mqdes, FAR char *msg, size_t msglen)
  *
  * Input Parameters:
  *   mqdes  - Message queue descriptor
+ *   msglen - Size of the caller's buffer in bytes.  A message larger than
+ *            this is left in the queue.
  *   rcvmsg - The caller-provided location in which to return the newly
  *            received message.
  *
@@ -117,7 +119,8 @@ int nxmq_verify_receive(mqd_t mqdes, FAR char *msg, size_t msglen)
  *
  ****************************************************************************/
 
-int nxmq_wait_receive(mqd_t mqdes, FAR struct mqueue_msg_s **rcvmsg)
+int nxmq_wait_receive(mqd_t mqdes, size_t msglen,
+                      FAR struct mqueue_msg_s **rcvmsg)
 {
   FAR struct tcb_s *rtcb;
   FAR struct mqueue_inode_s *msgq;
@@ -146,10 +149,9 @@ int nxmq_wait_receive(mqd_t mqdes, FAR struct mqueue_msg_s **rcvmsg)
 
   msgq = mqdes->msgq;
 
-  /* Get the message from the head of the queue */
+  /* Wait for a message at the head of the queue */
 
-  while ((newmsg = (FAR struct mqueue_msg_s *)sq_remfirst(&msgq->msglist))
-          == NULL)
+  while ((newmsg = (FAR struct mqueue_msg_s *)msgq->msglist.head) == NULL)
     {
       /* The queue is empty!  Should we block until there the above condition
        * has been satisfied?
@@ -198,14 +200,33 @@ int nxmq_wait_receive(mqd_t mqdes, FAR struct mqueue_msg_s **rcvmsg)
         }
     }
 
-  /* If we got message, then decrement the number of messages in
-   * the queue while we are still in the critical section
+  /* Only zero-copy messages may be larger than the maxmsgsize that the
+   * caller's buffer was verified against.  Such a message stays in the
+   * queue if it does not fit.
    */
 
-  if (newmsg)
+  if (newmsg->msglen > msglen)
     {
-      msgq->nmsgs--;
+      return -EMSGSIZE;
+    }
+
+  /* Remove the message and decrement the number of messages in the queue
+   * while we are still in the critical section
+   */
+
+  sq_remfirst(&msgq->msglist);
+  msgq->nmsgs--;
+
+#ifdef CONFIG_MQ_PRIOINDEX
+  if (msgq->priotail[newmsg->priority] == newmsg)
+    {
+      /* That was the last message of its priority */
+
+      msgq->priotail[newmsg->priority] = NULL;
+      msgq->priomap[newmsg->priority >> 5] &=
+        ~((uint32_t)1 << (newmsg->priority & 31));
     }
+#endif
 
   *rcvmsg = newmsg;
   return OK;
@@ -224,7 +245,9 @@ int nxmq_wait_receive(mqd_t mqdes, FAR struct mqueue_msg_s **rcvmsg)
  * Input Parameters:
  *   mqdes - Message queue descriptor
  *   mqmsg   - The message obtained by mq_waitmsg()
- *   ubuffer - The address of the user provided buffer to receive the message
+ *   ubuffer - The address of the user provided buffer to receive the
+ *             message or NULL if the caller already took the zero-copy
+ *             buffer of the message.
  *   prio    - The user-provided location to return the message priority.
  *
  * Returned Value:
@@ -254,7 +277,20 @@ ssize_t nxmq_do_receive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
 
   /* Copy the message into the caller's buffer */
 
-  memcpy(ubuffer, (FAR const void *)mqmsg->mail, rcvmsglen);
+#ifdef CONFIG_MQ_ZEROCOPY
+  if (ubuffer == NULL)
+    {
+      DEBUGASSERT(mqmsg->buffer == NULL);
+    }
+  else if (mqmsg->buffer != NULL)
+    {
+      memcpy(ubuffer, mqmsg->buffer, rcvmsglen);
+    }
+  else
+#endif
+    {
+      memcpy(ubuffer, (FAR const void *)mqmsg->mail, rcvmsglen);
+    }
 
   /* Copy the message priority as well (if a buffer is provided) */
 
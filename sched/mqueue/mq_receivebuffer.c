@@ -0,0 +1,211 @@
+/****************************************************************************
+ * sched/mqueue/mq_receivebuffer.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <mqueue.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mqueue.h>
+#include <nuttx/cancelpt.h>
+
+#include "mqueue/mqueue.h"
+
+#ifdef CONFIG_MQ_ZEROCOPY
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmq_receivebuffer
+ *
+ * Description:
+ *   This function removes the oldest of the highest priority messages
+ *   from the message queue specified by "mqdes" and returns the buffer
+ *   that holds it.  This is an internal OS interface.  It is functionally
+ *   equivalent to mq_receivebuffer() except that:
+ *
+ *   - It is not a cancellation point, and
+ *   - It does not modify the errno value.
+ *
+ *  See comments with mq_receivebuffer() for a more complete description
+ *  of the behavior of this function
+ *
+ * Input Parameters:
+ *   mqdes  - Message Queue Descriptor
+ *   buffer - Location to return the buffer holding the message
+ *   prio   - If not NULL, the location to store message priority.
+ *
+ * Returned Value:
+ *   This is an internal OS interface and should not be used by applications.
+ *   It follows the NuttX internal error return policy:  The length of the
+ *   message is returned on success.  A negated errno value is returned on
+ *   failure.  (see mq_receivebuffer() for the list list valid return
+ *   values).
+ *
+ ****************************************************************************/
+
+ssize_t nxmq_receivebuffer(mqd_t mqdes, FAR void **buffer,
+                           FAR unsigned int *prio)
+{
+  FAR struct mqueue_msg_s *mqmsg;
+  FAR void *ubuffer = NULL;
+  irqstate_t flags;
+  ssize_t ret;
+  bool nomem;
+
+  DEBUGASSERT(up_interrupt_context() == false);
+
+  /* Verify the input parameters.  There is no size limit:  The buffer is
+   * provided with the message.
+   */
+
+  ret = nxmq_verify_receive(mqdes, (FAR char *)buffer, SIZE_MAX);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Get the next message from the message queue.  We will disable
+   * pre-emption until we have completed the message received.
+   */
+
+  sched_lock();
+
+  /* Furthermore, nxmq_wait_receive() expects to have interrupts disabled
+   * because messages can be sent from interrupt level.
+   */
+
+  flags = enter_critical_section();
+  ret = nxmq_wait_receive(mqdes, SIZE_MAX, &mqmsg);
+  leave_critical_section(flags);
+
+  if (ret >= 0)
+    {
+      DEBUGASSERT(mqmsg != NULL);
+
+      if (mqmsg->buffer != NULL)
+        {
+          /* Take the buffer away from the message so that it is not freed
+           * with the message.
+           */
+
+          *buffer       = mqmsg->buffer;
+          mqmsg->buffer = NULL;
+          nomem         = false;
+        }
+      else
+        {
+          /* The message was sent with mq_send() and is held in the message
+           * itself.  Allocate a buffer for it.  The message is lost if that
+           * is not possible.
+           */
+
+          ubuffer = kumm_malloc(mqmsg->msglen > 0 ? mqmsg->msglen : 1);
+          *buffer = ubuffer;
+          nomem   = (ubuffer == NULL);
+        }
+
+      /* Let nxmq_do_receive() copy a message sent with mq_send(), free the
+       * message, and wake up any sender waiting for space.
+       */
+
+      ret = nxmq_do_receive(mqdes, mqmsg, ubuffer, prio);
+      if (nomem)
+        {
+          ret = -ENOMEM;
+        }
+    }
+
+  sched_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mq_receivebuffer
+ *
+ * Description:
+ *   This function removes the oldest of the highest priority messages
+ *   from the message queue specified by "mqdes" and returns the buffer
+ *   that holds it in "buffer."  The caller becomes the owner of the buffer
+ *   and must release it with free().
+ *
+ *   A message sent with mq_sendbuffer() is returned without copying.  A
+ *   message sent with mq_send() is copied into a newly allocated buffer.
+ *
+ *   If the message queue is empty and O_NONBLOCK was not set,
+ *   mq_receivebuffer() will block until a message is added to the message
+ *   queue.  If the queue is empty and O_NONBLOCK is set, ERROR will be
+ *   returned.
+ *
+ * Input Parameters:
+ *   mqdes  - Message Queue Descriptor
+ *   buffer - Location to return the buffer holding the message
+ *   prio   - If not NULL, the location to store message priority.
+ *
+ * Returned Value:
+ *   One success, the length of the selected message in bytes is returned.
+ *   On failure, -1 (ERROR) is returned and the errno is set appropriately:
+ *
+ *   EAGAIN   The queue was empty, and the O_NONBLOCK flag was set
+ *            for the message queue description referred to by 'mqdes'.
+ *   EPERM    Message queue opened not opened for reading.
+ *   ENOMEM   No buffer could be allocated for a message sent with
+ *            mq_send().  That message is discarded.
+ *   EINTR    The call was interrupted by a signal handler.
+ *   EINVAL   Invalid 'buffer' or 'mqdes'
+ *
+ ****************************************************************************/
+
+ssize_t mq_receivebuffer(mqd_t mqdes, FAR void **buffer,
+                         FAR unsigned int *prio)
+{
+  ssize_t ret;
+
+  /* mq_receivebuffer() is a cancellation point */
+
+  enter_cancellation_point();
+
+  /* Let nxmq_receivebuffer do all of the work */
+
+  ret = nxmq_receivebuffer(mqdes, buffer, prio);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
+
+#endif /* CONFIG_MQ_ZEROCOPY */
@@ -0,0 +1,186 @@
+/****************************************************************************
+ * sched/mqueue/mq_sendbuffer.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <mqueue.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/mqueue.h>
+#include <nuttx/cancelpt.h>
+
+#include "mqueue/mqueue.h"
+
+#ifdef CONFIG_MQ_ZEROCOPY
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmq_sendbuffer
+ *
+ * Description:
+ *   This function adds the specified buffer to the message queue (mqdes)
+ *   without copying its content.  This is an internal OS interface.  It is
+ *   functionally equivalent to mq_sendbuffer() except that:
+ *
+ *   - It is not a cancellation point, and
+ *   - It does not modify the errno value.
+ *
+ *  See comments with mq_sendbuffer() for a more complete description of
+ *  the behavior of this function
+ *
+ * Input Parameters:
+ *   mqdes  - Message queue descriptor
+ *   buffer - Buffer holding the message, allocated with malloc()
+ *   buflen - The length of the message in bytes
+ *   prio   - The priority of the message
+ *
+ * Returned Value:
+ *   This is an internal OS interface and should not be used by applications.
+ *   It follows the NuttX internal error return policy:  Zero (OK) is
+ *   returned on success.  A negated errno value is returned on failure.
+ *   (see mq_sendbuffer() for the list list valid return values).
+ *
+ ****************************************************************************/
+
+int nxmq_sendbuffer(mqd_t mqdes, FAR void *buffer, size_t buflen,
+                    unsigned int prio)
+{
+  FAR struct mqueue_inode_s *msgq;
+  FAR struct mqueue_msg_s *mqmsg = NULL;
+  irqstate_t flags;
+  int ret;
+
+  /* Verify the input parameters.  The size of a zero-copy message is not
+   * limited by the maxmsgsize of the message queue.
+   */
+
+  ret = nxmq_verify_send(mqdes, buffer, 0, prio);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Get a pointer to the message queue */
+
+  sched_lock();
+  msgq = mqdes->msgq;
+
+  /* Allocate a message structure:
+   * - Immediately if we are called from an interrupt handler.
+   * - Immediately if the message queue is not full, or
+   * - After successfully waiting for the message queue to become
+   *   non-FULL.  This would fail with EAGAIN or EINTR.
+   */
+
+  flags = enter_critical_section();
+  if (!up_interrupt_context() && msgq->nmsgs >= msgq->maxmsgs)
+    {
+      ret = nxmq_wait_send(mqdes);
+    }
+
+  leave_critical_section(flags);
+  if (ret >= 0)
+    {
+      mqmsg = nxmq_alloc_msg();
+      ret   = (mqmsg == NULL) ? -ENOMEM : OK;
+    }
+
+  if (mqmsg != NULL)
+    {
+      /* Attach the buffer to the message.  From here on, the buffer belongs
+       * to the message queue and nxmq_do_send() will not copy it.
+       */
+
+      mqmsg->buffer = buffer;
+      ret = nxmq_do_send(mqdes, mqmsg, buffer, buflen, prio);
+    }
+
+  sched_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: mq_sendbuffer
+ *
+ * Description:
+ *   This function adds the specified buffer to the message queue (mqdes)
+ *   without copying its content.  The buffer must have been allocated with
+ *   malloc().  On success, the ownership of the buffer passes to the
+ *   message queue and then to the task that receives it.  On failure, the
+ *   caller still owns the buffer.
+ *
+ *   Unlike mq_send(), "buflen" is not limited by the maximum message length
+ *   from the mq_getattr().  Otherwise the message is queued and the caller
+ *   is blocked exactly as with mq_send().
+ *
+ * Input Parameters:
+ *   mqdes  - Message queue descriptor
+ *   buffer - Buffer holding the message, allocated with malloc()
+ *   buflen - The length of the message in bytes
+ *   prio   - The priority of the message
+ *
+ * Returned Value:
+ *   On success, mq_sendbuffer() returns 0 (OK); on error, -1 (ERROR)
+ *   is returned, with errno set to indicate the error:
+ *
+ *   EAGAIN   The queue was full and the O_NONBLOCK flag was set for the
+ *            message queue description referred to by mqdes.
+ *   EINVAL   Either buffer or mqdes is NULL or the value of prio is
+ *            invalid.
+ *   EPERM    Message queue opened not opened for writing.
+ *   ENOMEM   No message structure could be allocated.
+ *   EINTR    The call was interrupted by a signal handler.
+ *
+ ****************************************************************************/
+
+int mq_sendbuffer(mqd_t mqdes, FAR void *buffer, size_t buflen,
+                  unsigned int prio)
+{
+  int ret;
+
+  /* mq_sendbuffer() is a cancellation point */
+
+  enter_cancellation_point();
+
+  /* Let nxmq_sendbuffer() do all of the work */
+
+  ret = nxmq_sendbuffer(mqdes, buffer, buflen, prio);
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      ret = ERROR;
+    }
+
+  leave_cancellation_point();
+  return ret;
+}
+
+#endif /* CONFIG_MQ_ZEROCOPY */
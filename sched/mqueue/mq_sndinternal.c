@@ -26,6 +26,7 @@
 
 #include <sys/types.h>
 #include <stdint.h>
+#include <strings.h>
 #include <fcntl.h>
 #include <mqueue.h>
 #include <string.h>
@@ -42,6 +43,73 @@
 #include "sched/sched.h"
 #include "mqueue/mqueue.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmq_insert_msg
+ *
+ * Description:
+ *   Insert a message in the message list after all messages of the same or
+ *   of higher priority.  The list is kept in descending priority order.
+ *
+ * Assumptions:
+ *   Executes within a critical section established by the caller.
+ *
+ ****************************************************************************/
+
+static void nxmq_insert_msg(FAR struct mqueue_inode_s *msgq,
+                            FAR struct mqueue_msg_s *mqmsg)
+{
+  FAR struct mqueue_msg_s *prev = NULL;
+#ifdef CONFIG_MQ_PRIOINDEX
+  uint32_t bits;
+  int prio = mqmsg->priority;
+  int i;
+
+  /* The new message goes after the last message of the lowest priority
+   * that is still greater than or equal to its own.  Find that priority
+   * in the bitmap rather than walking the list.
+   */
+
+  for (i = prio; i <= MQ_PRIO_MAX; i = (i | 31) + 1)
+    {
+      bits = msgq->priomap[i >> 5] & (UINT32_MAX << (i & 31));
+      if (bits != 0)
+        {
+          prev = msgq->priotail[(i & ~31) + ffs((int)bits) - 1];
+          break;
+        }
+    }
+
+  msgq->priotail[prio]     = mqmsg;
+  msgq->priomap[prio >> 5] |= (uint32_t)1 << (prio & 31);
+#else
+  FAR struct mqueue_msg_s *next;
+
+  /* Search the message list to find the location to insert the new
+   * message. Each is list is maintained in ascending priority order.
+   */
+
+  for (next = (FAR struct mqueue_msg_s *)msgq->msglist.head;
+       next && mqmsg->priority <= next->priority;
+       prev = next, next = next->next);
+#endif
+
+  /* Add the message at the right place */
+
+  if (prev)
+    {
+      sq_addafter((FAR sq_entry_t *)prev, (FAR sq_entry_t *)mqmsg,
+                  &msgq->msglist);
+    }
+  else
+    {
+      sq_addfirst((FAR sq_entry_t *)mqmsg, &msgq->msglist);
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -178,6 +246,13 @@ FAR struct mqueue_msg_s *nxmq_alloc_msg(void)
         }
     }
 
+#ifdef CONFIG_MQ_ZEROCOPY
+  if (mqmsg != NULL)
+    {
+      mqmsg->buffer = NULL;
+    }
+#endif
+
   return mqmsg;
 }
 
@@ -325,8 +400,6 @@ int nxmq_do_send(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
 {
   FAR struct tcb_s *btcb;
   FAR struct mqueue_inode_s *msgq;
-  FAR struct mqueue_msg_s *next;
-  FAR struct mqueue_msg_s *prev;
   irqstate_t flags;
 
   /* Get a pointer to the message queue */
@@ -339,33 +412,21 @@ int nxmq_do_send(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
   mqmsg->priority = prio;
   mqmsg->msglen   = msglen;
 
-  /* Copy the message data into the message */
+  /* Copy the message data into the message.  A zero-copy message already
+   * refers to the caller's buffer.
+   */
 
-  memcpy((FAR void *)mqmsg->mail, (FAR const void *)msg, msglen);
+#ifdef CONFIG_MQ_ZEROCOPY
+  if (mqmsg->buffer == NULL)
+#endif
+    {
+      memcpy((FAR void *)mqmsg->mail, (FAR const void *)msg, msglen);
+    }
 
   /* Insert the new message in the message queue */
 
   flags = enter_critical_section();
-
-  /* Search the message list to find the location to insert the new
-   * message. Each is list is maintained in ascending priority order.
-   */
-
-  for (prev = NULL, next = (FAR struct mqueue_msg_s *)msgq->msglist.head;
-       next && prio <= next->priority;
-       prev = next, next = next->next);
-
-  /* Add the message at the right place */
-
-  if (prev)
-    {
-      sq_addafter((FAR sq_entry_t *)prev, (FAR sq_entry_t *)mqmsg,
-                  &msgq->msglist);
-    }
-  else
-    {
-      sq_addfirst((FAR sq_entry_t *)mqmsg, &msgq->msglist);
-    }
+  nxmq_insert_msg(msgq, mqmsg);
 
   /* Increment the count of messages in the queue */
 
@@ -213,7 +213,7 @@ ssize_t nxmq_timedreceive(mqd_t mqdes, FAR char *msg, size_t msglen,
 
   /* Get the message from the message queue */
 
-  ret = nxmq_wait_receive(mqdes, &mqmsg);
+  ret = nxmq_wait_receive(mqdes, msglen, &mqmsg);
 
   /* Stop the watchdog timer (this is not harmful in the case where
    * it was never started)
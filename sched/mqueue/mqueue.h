@@ -77,7 +77,10 @@ struct mqueue_msg_s
   FAR struct mqueue_msg_s *next;  /* Forward link to next message */
   uint8_t type;                   /* (Used to manage allocations) */
   uint8_t priority;               /* priority of message */
-#if MQ_MAX_BYTES < 256
+#if defined(CONFIG_MQ_ZEROCOPY)
+  size_t msglen;                  /* Message data length */
+  FAR void *buffer;               /* Queued buffer or NULL if data in mail */
+#elif MQ_MAX_BYTES < 256
   uint8_t msglen;                 /* Message data length */
 #else
   uint16_t msglen;                /* Message data length */
@@ -136,7 +139,8 @@ void nxmq_wait_irq(FAR struct tcb_s *wtcb, int errcode);
 /* mq_rcvinternal.c *************************************************************/
 
 int nxmq_verify_receive(mqd_t mqdes, FAR char *msg, size_t msglen);
-int nxmq_wait_receive(mqd_t mqdes, FAR struct mqueue_msg_s **rcvmsg);
+int nxmq_wait_receive(mqd_t mqdes, size_t msglen,
+                      FAR struct mqueue_msg_s **rcvmsg);
 ssize_t nxmq_do_receive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
                         FAR char *ubuffer, FAR unsigned int *prio);
 
@@ -0,0 +1,268 @@
+/****************************************************************************
+ * sched/pthread/pthread_futex.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <queue.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/pthread.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_PTHREAD_FUTEX
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define FUTEX_HASH(a) \
+  ((((uintptr_t)(a)) >> 2) % CONFIG_PTHREAD_FUTEX_NHASH)
+
+/* With address environments, the same virtual address may refer to
+ * different memory in different task groups, so the task group is part of
+ * the key.  Otherwise all tasks share one address space and a futex in
+ * memory shared by two tasks must match on the address alone.
+ */
+
+#ifdef CONFIG_ARCH_ADDRENV
+#  define FUTEX_MATCH(w,a,g)   ((w)->addr == (a) && (w)->group == (g))
+#else
+#  define FUTEX_MATCH(w,a,g)   ((w)->addr == (a))
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One of these lives on the stack of each thread blocked in futex_wait().
+ * The futex is identified by its address and, with address environments,
+ * by the task group of the waiter.
+ */
+
+struct futex_waiter_s
+{
+  dq_entry_t node;                      /* Link in the hash bucket */
+  FAR volatile uint32_t *addr;          /* The futex word */
+#ifdef CONFIG_ARCH_ADDRENV
+  FAR struct task_group_s *group;       /* Owner of the address space */
+#endif
+  sem_t sem;                            /* Waiter blocks here */
+  bool woken;                           /* Removed from the bucket by waker */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Hash buckets of waiting threads.  Protected by the critical section. */
+
+static dq_queue_t g_futex_hash[CONFIG_PTHREAD_FUTEX_NHASH];
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: futex_wait
+ *
+ * Description:
+ *   Atomically check that the 32-bit word at 'addr' still holds 'val' and,
+ *   if so, sleep until futex_wake() is called for the same address, until
+ *   the absolute timeout expires, or until a signal is received.  The
+ *   comparison and the enqueueing of the caller are performed together in
+ *   a critical section so a wakeup issued after the word was changed can
+ *   never be lost.
+ *
+ * Input Parameters:
+ *   addr    - The futex word in the caller's address space.
+ *   val     - The value that the futex word is expected to hold.
+ *   clockid - The clock used to interpret 'abstime'.
+ *   abstime - Absolute timeout or NULL to wait forever.
+ *   flags   - FUTEX_CANCELPT:  Wake up on a deferred cancellation request
+ *             as at a cancellation point, but return ECANCELED instead of
+ *             acting on it.  The caller must first restore the state
+ *             protected by the futex (e.g., reacquire a mutex) and then
+ *             act on the cancellation with pthread_testcancel().
+ *
+ * Returned Value:
+ *   Like the pthread interfaces, this returns zero (OK) when the caller was
+ *   awakened by futex_wake() or a positive errno value otherwise:
+ *
+ *   EAGAIN    - The futex word did not hold 'val'.
+ *   ETIMEDOUT - The timeout expired.
+ *   EINTR     - The wait was interrupted by a signal.
+ *   ECANCELED - A cancellation is pending (FUTEX_CANCELPT only).
+ *   EINVAL    - 'addr' is NULL or misaligned.
+ *
+ *   Spurious returns are possible; callers must always re-check the state
+ *   protected by the futex.
+ *
+ ****************************************************************************/
+
+int futex_wait(FAR volatile uint32_t *addr, uint32_t val,
+               clockid_t clockid, FAR const struct timespec *abstime,
+               int flags)
+{
+  struct futex_waiter_s waiter;
+  FAR dq_queue_t *bucket;
+#ifdef CONFIG_CANCELLATION_POINTS
+  FAR struct tcb_s *rtcb = this_task();
+  bool cancelpt = false;
+#endif
+  irqstate_t irqflags;
+  int ret;
+
+  if (addr == NULL || ((uintptr_t)addr & 3) != 0)
+    {
+      return EINVAL;
+    }
+
+  waiter.addr  = addr;
+#ifdef CONFIG_ARCH_ADDRENV
+  waiter.group = this_task()->group;
+#endif
+  waiter.woken = false;
+
+  nxsem_init(&waiter.sem, 0, 0);
+  nxsem_set_protocol(&waiter.sem, SEM_PRIO_NONE);
+
+  bucket = &g_futex_hash[FUTEX_HASH(addr)];
+
+  irqflags = enter_critical_section();
+  if (*addr != val)
+    {
+      leave_critical_section(irqflags);
+      nxsem_destroy(&waiter.sem);
+      return EAGAIN;
+    }
+
+#ifdef CONFIG_CANCELLATION_POINTS
+  /* Make a deferred cancellation request wake us up.  Raising the nesting
+   * level of cancellation points directly (rather than with
+   * enter_cancellation_point()) assures that the cancellation is never
+   * acted upon here.
+   */
+
+  if ((flags & FUTEX_CANCELPT) != 0 &&
+      (rtcb->flags & TCB_FLAG_NONCANCELABLE) == 0 &&
+      (rtcb->flags & TCB_FLAG_CANCEL_DEFERRED) != 0)
+    {
+      if ((rtcb->flags & TCB_FLAG_CANCEL_PENDING) != 0)
+        {
+          leave_critical_section(irqflags);
+          nxsem_destroy(&waiter.sem);
+          return ECANCELED;
+        }
+
+      rtcb->cpcount++;
+      cancelpt = true;
+    }
+#endif
+
+  dq_addlast(&waiter.node, bucket);
+
+  if (abstime != NULL)
+    {
+      ret = nxsem_clockwait(&waiter.sem, clockid, abstime);
+    }
+  else
+    {
+      ret = nxsem_wait(&waiter.sem);
+    }
+
+  /* If we were not awakened by futex_wake(), then we are still queued */
+
+  if (!waiter.woken)
+    {
+      dq_rem(&waiter.node, bucket);
+    }
+
+#ifdef CONFIG_CANCELLATION_POINTS
+  if (cancelpt)
+    {
+      rtcb->cpcount--;
+    }
+#endif
+
+  leave_critical_section(irqflags);
+  nxsem_destroy(&waiter.sem);
+
+  return waiter.woken ? OK : -ret;
+}
+
+/****************************************************************************
+ * Name: futex_wake
+ *
+ * Description:
+ *   Wake up at most 'nwake' threads sleeping in futex_wait() on 'addr'.
+ *   The caller is expected to have changed the futex word before calling
+ *   this.
+ *
+ * Input Parameters:
+ *   addr  - The futex word in the caller's address space.
+ *   nwake - The maximum number of threads to wake.  INT_MAX wakes all.
+ *
+ * Returned Value:
+ *   The number of threads that were awakened.
+ *
+ ****************************************************************************/
+
+int futex_wake(FAR volatile uint32_t *addr, int nwake)
+{
+#ifdef CONFIG_ARCH_ADDRENV
+  FAR struct task_group_s *group = this_task()->group;
+#endif
+  FAR struct futex_waiter_s *waiter;
+  FAR dq_entry_t *curr;
+  FAR dq_entry_t *next;
+  FAR dq_queue_t *bucket;
+  irqstate_t flags;
+  int nwoken = 0;
+
+  bucket = &g_futex_hash[FUTEX_HASH(addr)];
+
+  flags = enter_critical_section();
+  for (curr = dq_peek(bucket); curr != NULL && nwoken < nwake; curr = next)
+    {
+      next   = dq_next(curr);
+      waiter = (FAR struct futex_waiter_s *)curr;
+
+      if (FUTEX_MATCH(waiter, addr, group))
+        {
+          dq_rem(curr, bucket);
+          waiter->woken = true;
+          nxsem_post(&waiter->sem);
+          nwoken++;
+        }
+    }
+
+  leave_critical_section(flags);
+  return nwoken;
+}
+
+#endif /* CONFIG_PTHREAD_FUTEX */
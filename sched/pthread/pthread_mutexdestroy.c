@@ -70,9 +70,22 @@ int pthread_mutex_destroy(FAR pthread_mutex_t *mutex)
 
       sched_lock();
 
+#ifdef CONFIG_PTHREAD_FUTEX
+      /* Is the mutex locked in user space? */
+
+      if (mutex->futex != 0)
+        {
+          ret = EBUSY;
+        }
+
+      /* Is the mutex available? */
+
+      else if (mutex->pid >= 0)
+#else
       /* Is the mutex available? */
 
       if (mutex->pid >= 0)
+#endif
         {
           /* < 0: available, >0 owned, ==0 error */
 
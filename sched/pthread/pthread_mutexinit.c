@@ -133,6 +133,12 @@ int pthread_mutex_init(FAR pthread_mutex_t *mutex,
       mutex->type   = type;
       mutex->nlocks = 0;
 #endif
+
+#ifdef CONFIG_PTHREAD_FUTEX
+      /* Unlocked if the mutex is locked in user space */
+
+      mutex->futex  = 0;
+#endif
     }
 
   sinfo("Returning %d\n", ret);
@@ -47,6 +47,7 @@
 #include <debug.h>
 
 #include <nuttx/sched.h>
+#include <nuttx/pthread.h>
 
 #include "pthread/pthread.h"
 
@@ -90,8 +91,13 @@
  *
  ****************************************************************************/
 
+#ifdef CONFIG_PTHREAD_FUTEX
+int nx_pthread_mutex_timedlock(FAR pthread_mutex_t *mutex,
+                               FAR const struct timespec *abs_timeout)
+#else
 int pthread_mutex_timedlock(FAR pthread_mutex_t *mutex,
                             FAR const struct timespec *abs_timeout)
+#endif
 {
   int mypid = (int)getpid();
   int ret = EINVAL;
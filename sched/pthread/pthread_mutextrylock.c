@@ -31,6 +31,8 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/pthread.h>
+
 #include "pthread/pthread.h"
 
 /****************************************************************************
@@ -66,7 +68,11 @@
  *
  ****************************************************************************/
 
+#ifdef CONFIG_PTHREAD_FUTEX
+int nx_pthread_mutex_trylock(FAR pthread_mutex_t *mutex)
+#else
 int pthread_mutex_trylock(FAR pthread_mutex_t *mutex)
+#endif
 {
   int status;
   int ret = EINVAL;
@@ -55,6 +55,12 @@
 #define MAX_TASKS_MASK           (CONFIG_MAX_TASKS-1)
 #define PIDHASH(pid)             ((pid) & MAX_TASKS_MASK)
 
+/* The exact CPU load measurement accumulates 64-bit times */
+
+#if defined(CONFIG_SCHED_CPULOAD_CRITMONITOR) && !defined(CONFIG_HAVE_LONG_LONG)
+#  error CONFIG_SCHED_CPULOAD_CRITMONITOR requires CONFIG_HAVE_LONG_LONG
+#endif
+
 /* These are macros to access the current CPU and the current task on a CPU.
  * These macros are intended to support a future SMP implementation.
  * NOTE: this_task() for SMP is implemented in sched_thistask.c
@@ -118,7 +124,9 @@ struct pidhash_s
 {
   FAR struct tcb_s *tcb;       /* TCB assigned to this PID */
   pid_t pid;                   /* The full PID value */
-#ifdef CONFIG_SCHED_CPULOAD
+#ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
+  uint64_t ticks;              /* Time on this thread (critmon units) */
+#elif defined(CONFIG_SCHED_CPULOAD)
   uint32_t ticks;              /* Number of ticks on this thread */
 #endif
 };
@@ -275,8 +283,12 @@ extern const struct tasklist_s g_tasklisttable[NUM_TASK_STATES];
  * 'denominator' for all CPU load calculations.
  */
 
+#ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
+extern volatile uint64_t g_cpuload_total;
+#else
 extern volatile uint32_t g_cpuload_total;
 #endif
+#endif
 
 /* Declared in sched_lock.c *************************************************/
 
@@ -435,6 +447,12 @@ void nxsched_unlock_tasklist(irqstate_t lock);
 void weak_function nxsched_process_cpuload(void);
 #endif
 
+#ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
+void nxsched_suspend_cpuload(FAR struct tcb_s *tcb);
+void nxsched_resume_cpuload(FAR struct tcb_s *tcb);
+void nxsched_irq_cpuload(bool state);
+#endif
+
 /* Critical section monitor */
 
 #ifdef CONFIG_SCHED_CRITMONITOR
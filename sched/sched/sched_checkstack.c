@@ -0,0 +1,117 @@
+/****************************************************************************
+ * sched/sched/sched_checkstack.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/sched.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_STACK_USAGE_CACHE
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_check_tcbstack
+ *
+ * Description:
+ *   Determine (approximately) how much stack a thread has used, like
+ *   up_check_tcbstack().  The stack is only scanned again if the thread
+ *   has run since it was last measured:  A thread that does not run cannot
+ *   touch more of its stack.  nxsched_resume_scheduler() invalidates the
+ *   cached value each time the thread is resumed.
+ *
+ * Input Parameters:
+ *   tcb - The TCB of the thread to be measured.
+ *
+ * Returned Value:
+ *   The estimated amount of stack space used.
+ *
+ ****************************************************************************/
+
+size_t nxsched_check_tcbstack(FAR struct tcb_s *tcb)
+{
+  irqstate_t flags;
+  size_t used;
+  bool running;
+
+  DEBUGASSERT(tcb != NULL);
+
+  flags = enter_critical_section();
+  if ((tcb->flags & TCB_FLAG_STACK_VALID) != 0)
+    {
+      used = tcb->stack_used;
+      leave_critical_section(flags);
+      return used;
+    }
+
+  /* Note that a scan is in progress.  If the thread is resumed before the
+   * scan completes, the flag will be cleared.
+   */
+
+  tcb->flags |= TCB_FLAG_STACK_SCAN;
+  running = (tcb->task_state == TSTATE_TASK_RUNNING);
+  leave_critical_section(flags);
+
+  /* Scan the stack without holding up the rest of the system */
+
+  used = up_check_tcbstack(tcb);
+
+  flags = enter_critical_section();
+
+  /* The high water mark only rises, so keep the highest value found by
+   * any scan.
+   */
+
+  if (used > tcb->stack_used)
+    {
+      tcb->stack_used = used;
+    }
+  else
+    {
+      used = tcb->stack_used;
+    }
+
+  /* The result remains valid only if the thread did not run at all while
+   * its stack was being scanned.
+   */
+
+  if (!running && (tcb->flags & TCB_FLAG_STACK_SCAN) != 0)
+    {
+      tcb->flags |= TCB_FLAG_STACK_VALID;
+    }
+
+  tcb->flags &= ~TCB_FLAG_STACK_SCAN;
+  leave_critical_section(flags);
+  return used;
+}
+
+#endif /* CONFIG_STACK_USAGE_CACHE */
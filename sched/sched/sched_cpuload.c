@@ -39,9 +39,12 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+#include <time.h>
 #include <errno.h>
 #include <assert.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/clock.h>
 #include <nuttx/irq.h>
 
@@ -82,6 +85,59 @@
       CPULOAD_TICKSPERSEC)
 #endif
 
+/* With CONFIG_SCHED_CPULOAD_CRITMONITOR, the rate of up_critmon_gettime()
+ * is unknown at build time.  It is measured once by converting this many
+ * counts into nanoseconds.
+ */
+
+#define CPULOAD_CALIBRATE_SHIFT 24
+#define CPULOAD_CALIBRATE_COUNT (UINT32_C(1) << CPULOAD_CALIBRATE_SHIFT)
+#define CPULOAD_CALIBRATE_MASK  (CPULOAD_CALIBRATE_COUNT - 1)
+
+#ifdef CONFIG_SMP
+#  define CPULOAD_NCPUS CONFIG_SMP_NCPUS
+#else
+#  define CPULOAD_NCPUS 1
+#endif
+
+/* The interrupt path updates the per-CPU times of its own CPU without
+ * taking the critical section.  In the SMP case, another CPU that folds
+ * them into the load average reads them under a sequence count.
+ */
+
+#if defined(CONFIG_SCHED_CPULOAD_CRITMONITOR) && defined(CONFIG_SMP)
+#  define CPULOAD_WRITE_BEGIN(c) do { (c)->seq++; SP_DMB(); } while (0)
+#  define CPULOAD_WRITE_END(c)   do { SP_DMB(); (c)->seq++; } while (0)
+#else
+#  define CPULOAD_WRITE_BEGIN(c)
+#  define CPULOAD_WRITE_END(c)
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
+/* Per-CPU accounting state.  'last', 'irqstart', 'nesting', 'runtime' and
+ * 'irqtime' are only written by the owning CPU with interrupts disabled.
+ * 'foldrun' and 'foldirq' are protected by the critical section.
+ */
+
+struct cpuload_cpu_s
+{
+#ifdef CONFIG_SMP
+  volatile uint32_t seq;  /* Odd while 'runtime' or 'irqtime' changes */
+#endif
+  uint32_t last;          /* Time of the last accounting event */
+  uint32_t irqstart;      /* Entry time of the outermost interrupt */
+  uint8_t nesting;        /* Interrupt nesting level */
+  uint64_t runtime;       /* Thread time accumulated on this CPU */
+  uint64_t irqtime;       /* Time spent in interrupt handlers */
+  uint64_t foldrun;       /* Part of 'runtime' folded into g_pidhash[] */
+  uint64_t foldirq;       /* Part of 'irqtime' folded into the total */
+};
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -99,12 +155,259 @@
  * each would have a load of 25% of the total.
  */
 
+#ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
+volatile uint64_t g_cpuload_total;
+#else
 volatile uint32_t g_cpuload_total;
+#endif
+
+#ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
+/* Accounting state of each CPU */
+
+static struct cpuload_cpu_s g_cpuload_cpu[CPULOAD_NCPUS];
+
+/* The part of g_cpuload_total spent in interrupt handlers on all CPUs.
+ * This is scaled together with the counts in g_pidhash[].
+ */
+
+static uint64_t g_cpuload_irqticks;
+
+/* Nanoseconds per CPULOAD_CALIBRATE_COUNT counts and the value of
+ * g_cpuload_total that corresponds to the time constant.  Zero means not
+ * yet calibrated.
+ */
+
+static uint64_t g_cpuload_nsec;
+static uint64_t g_cpuload_timeconstant;
+#endif
 
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
+/****************************************************************************
+ * Name: nxsched_cpuload_calibrate
+ *
+ * Description:
+ *   Determine the rate of up_critmon_gettime() and the time constant for
+ *   the scaling of the accumulated times.
+ *
+ ****************************************************************************/
+
+static void nxsched_cpuload_calibrate(void)
+{
+  struct timespec ts;
+
+  up_critmon_convert(CPULOAD_CALIBRATE_COUNT, &ts);
+  g_cpuload_nsec = (uint64_t)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+  if (g_cpuload_nsec == 0)
+    {
+      g_cpuload_nsec = 1;
+    }
+
+  g_cpuload_timeconstant = (uint64_t)CPULOAD_NCPUS *
+                           CONFIG_SCHED_CPULOAD_TIMECONSTANT *
+                           NSEC_PER_SEC * CPULOAD_CALIBRATE_COUNT /
+                           g_cpuload_nsec;
+  if (g_cpuload_timeconstant == 0)
+    {
+      g_cpuload_timeconstant = 1;
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_cpuload_convert
+ *
+ * Description:
+ *   Convert an accumulated time in units of up_critmon_gettime() to a
+ *   timespec.  up_critmon_convert() cannot be used directly because it
+ *   only accepts a 32-bit elapsed time.
+ *
+ ****************************************************************************/
+
+static void nxsched_cpuload_convert(uint64_t elapsed,
+                                    FAR struct timespec *ts)
+{
+  uint64_t nsec;
+
+  if (g_cpuload_nsec == 0)
+    {
+      nxsched_cpuload_calibrate();
+    }
+
+  nsec = (elapsed >> CPULOAD_CALIBRATE_SHIFT) * g_cpuload_nsec +
+         (((elapsed & CPULOAD_CALIBRATE_MASK) * g_cpuload_nsec) >>
+          CPULOAD_CALIBRATE_SHIFT);
+
+  ts->tv_sec  = nsec / NSEC_PER_SEC;
+  ts->tv_nsec = nsec - (uint64_t)ts->tv_sec * NSEC_PER_SEC;
+}
+
+/****************************************************************************
+ * Name: nxsched_cpuload_snapshot
+ *
+ * Description:
+ *   Read the thread and interrupt times accumulated on 'cpu'.  In the SMP
+ *   case, the interrupt path of that CPU may be updating them right now.
+ *
+ ****************************************************************************/
+
+static void nxsched_cpuload_snapshot(int cpu, FAR uint64_t *runtime,
+                                     FAR uint64_t *irqtime)
+{
+  FAR struct cpuload_cpu_s *cpuload = &g_cpuload_cpu[cpu];
+#ifdef CONFIG_SMP
+  uint32_t seq;
+
+  do
+    {
+      seq = cpuload->seq;
+      SP_DMB();
+      *runtime = cpuload->runtime;
+      *irqtime = cpuload->irqtime;
+      SP_DMB();
+    }
+  while ((seq & 1) != 0 || seq != cpuload->seq);
+#else
+  *runtime = cpuload->runtime;
+  *irqtime = cpuload->irqtime;
+#endif
+}
+
+/****************************************************************************
+ * Name: nxsched_cpuload_accrue
+ *
+ * Description:
+ *   Add the time since the last accounting event on this CPU to the thread
+ *   time of the CPU.  It is charged to the running thread when it is
+ *   folded.
+ *
+ * Assumptions:
+ *   Called on the CPU that owns 'cpuload' with interrupts disabled and
+ *   outside of interrupt handlers.
+ *
+ ****************************************************************************/
+
+static void nxsched_cpuload_accrue(FAR struct cpuload_cpu_s *cpuload,
+                                   uint32_t now)
+{
+  /* Zero means that the timer is not ready */
+
+  if (now != 0 && cpuload->last != 0)
+    {
+      CPULOAD_WRITE_BEGIN(cpuload);
+      cpuload->runtime += now - cpuload->last;
+      CPULOAD_WRITE_END(cpuload);
+    }
+
+  cpuload->last = now;
+}
+
+/****************************************************************************
+ * Name: nxsched_cpuload_fold
+ *
+ * Description:
+ *   Charge the times accumulated on 'cpu' since the last fold to the
+ *   thread 'tcb' running on that CPU and to the interrupt handling time.
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+static void nxsched_cpuload_fold(int cpu, FAR struct tcb_s *tcb)
+{
+  FAR struct cpuload_cpu_s *cpuload = &g_cpuload_cpu[cpu];
+  uint64_t runtime;
+  uint64_t irqtime;
+  uint64_t elapsed;
+
+  nxsched_cpuload_snapshot(cpu, &runtime, &irqtime);
+
+  /* NOTE that the load average is still taken from g_pidhash so that
+   * clock_cpuload() works the same way in both modes.
+   */
+
+  elapsed           = runtime - cpuload->foldrun;
+  cpuload->foldrun  = runtime;
+  tcb->run_time    += elapsed;
+  g_pidhash[PIDHASH(tcb->pid)].ticks += elapsed;
+  g_cpuload_total  += elapsed;
+
+  elapsed             = irqtime - cpuload->foldirq;
+  cpuload->foldirq    = irqtime;
+  g_cpuload_irqticks += elapsed;
+  g_cpuload_total    += elapsed;
+}
+
+/****************************************************************************
+ * Name: nxsched_cpuload_foldall
+ *
+ * Description:
+ *   Fold the times accumulated on all CPUs, including the time of the
+ *   thread running on this CPU.
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+static void nxsched_cpuload_foldall(void)
+{
+  FAR struct cpuload_cpu_s *cpuload = &g_cpuload_cpu[this_cpu()];
+  int i;
+
+  if (cpuload->nesting == 0)
+    {
+      nxsched_cpuload_accrue(cpuload, up_critmon_gettime());
+    }
+
+  for (i = 0; i < CPULOAD_NCPUS; i++)
+    {
+      nxsched_cpuload_fold(i, current_task(i));
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_cpuload_decay
+ *
+ * Description:
+ *   If the accumulated time exceeds the time constant, then shift the
+ *   accumulators and recalculate the total.
+ *
+ * Assumptions:
+ *   Called within a critical section.
+ *
+ ****************************************************************************/
+
+static void nxsched_cpuload_decay(void)
+{
+  uint64_t total;
+  int i;
+
+  if (g_cpuload_timeconstant == 0)
+    {
+      nxsched_cpuload_calibrate();
+    }
+
+  while (g_cpuload_total > g_cpuload_timeconstant)
+    {
+      g_cpuload_irqticks >>= 1;
+      total = g_cpuload_irqticks;
+
+      for (i = 0; i < CONFIG_MAX_TASKS; i++)
+        {
+          g_pidhash[i].ticks >>= 1;
+          total += g_pidhash[i].ticks;
+        }
+
+      g_cpuload_total = total;
+    }
+}
+
+#else
+
 /****************************************************************************
  * Name: nxsched_cpu_process_cpuload
  *
@@ -146,11 +449,157 @@ static inline void nxsched_cpu_process_cpuload(int cpu)
 
   g_cpuload_total++;
 }
+#endif /* CONFIG_SCHED_CPULOAD_CRITMONITOR */
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+#ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
+/****************************************************************************
+ * Name: nxsched_suspend_cpuload
+ *
+ * Description:
+ *   Called when a thread suspends execution.  The time since the last
+ *   accounting event is charged to the thread.
+ *
+ * Assumptions:
+ *   - Called within a critical section.
+ *   - Might be called from an interrupt handler
+ *
+ ****************************************************************************/
+
+void nxsched_suspend_cpuload(FAR struct tcb_s *tcb)
+{
+  int cpu = this_cpu();
+  FAR struct cpuload_cpu_s *cpuload = &g_cpuload_cpu[cpu];
+
+  /* Within an interrupt handler, the time of the thread was accrued when
+   * the handler was entered.
+   */
+
+  if (cpuload->nesting == 0)
+    {
+      nxsched_cpuload_accrue(cpuload, up_critmon_gettime());
+    }
+
+  nxsched_cpuload_fold(cpu, tcb);
+}
+
+/****************************************************************************
+ * Name: nxsched_resume_cpuload
+ *
+ * Description:
+ *   Called when a thread resumes execution.  The thread is charged from
+ *   this time on.  The time since the last accounting event has either
+ *   been charged when the previous thread was suspended or belongs to a
+ *   thread that has exited.
+ *
+ * Assumptions:
+ *   - Called within a critical section.
+ *   - Might be called from an interrupt handler
+ *
+ ****************************************************************************/
+
+void nxsched_resume_cpuload(FAR struct tcb_s *tcb)
+{
+  FAR struct cpuload_cpu_s *cpuload = &g_cpuload_cpu[this_cpu()];
+
+  /* Within an interrupt handler, the time is charged to the interrupt when
+   * the handler returns.
+   */
+
+  if (cpuload->nesting == 0)
+    {
+      cpuload->last = up_critmon_gettime();
+    }
+
+  /* Discard any time of an exited thread that has not been folded yet */
+
+  cpuload->foldrun = cpuload->runtime;
+}
+
+/****************************************************************************
+ * Name: nxsched_irq_cpuload
+ *
+ * Description:
+ *   Called by irq_dispatch() when an interrupt handler is entered (state ==
+ *   true) or left (state == false).  On entry to the outermost handler, the
+ *   time up to the entry is accrued for the interrupted thread.  On exit,
+ *   the time spent in the handler is added to the interrupt handling time
+ *   of the CPU.
+ *
+ *   Only the per-CPU accumulators are updated here, without the critical
+ *   section.  They are folded into the load average on context switches,
+ *   on the timer tick and in clock_cpuload().
+ *
+ * Assumptions:
+ *   Called from an interrupt handler with interrupts disabled.
+ *
+ ****************************************************************************/
+
+void nxsched_irq_cpuload(bool state)
+{
+  FAR struct cpuload_cpu_s *cpuload = &g_cpuload_cpu[this_cpu()];
+  uint32_t now;
+
+  if (state)
+    {
+      if (cpuload->nesting++ == 0)
+        {
+          now = up_critmon_gettime();
+          nxsched_cpuload_accrue(cpuload, now);
+          cpuload->irqstart = now;
+        }
+    }
+  else
+    {
+      DEBUGASSERT(cpuload->nesting > 0);
+      if (--cpuload->nesting == 0)
+        {
+          now = up_critmon_gettime();
+          if (now != 0 && cpuload->irqstart != 0)
+            {
+              CPULOAD_WRITE_BEGIN(cpuload);
+              cpuload->irqtime += now - cpuload->irqstart;
+              CPULOAD_WRITE_END(cpuload);
+            }
+
+          cpuload->last = now;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_process_cpuload
+ *
+ * Description:
+ *   Called on each timer tick.  Fold the times accumulated on all CPUs
+ *   into the load average and scale it back if it exceeds the time
+ *   constant.
+ *
+ * Assumptions/Limitations:
+ *   This function is called from a timer interrupt handler with all
+ *   interrupts disabled.
+ *
+ ****************************************************************************/
+
+void weak_function nxsched_process_cpuload(void)
+{
+#ifdef CONFIG_SMP
+  irqstate_t flags = enter_critical_section();
+#endif
+
+  nxsched_cpuload_foldall();
+  nxsched_cpuload_decay();
+
+#ifdef CONFIG_SMP
+  leave_critical_section(flags);
+#endif
+}
+
+#else
+
 /****************************************************************************
  * Name: nxsched_process_cpuload
  *
@@ -221,6 +670,7 @@ void weak_function nxsched_process_cpuload(void)
   leave_critical_section(flags);
 #endif
 }
+#endif /* CONFIG_SCHED_CPULOAD_CRITMONITOR */
 
 /****************************************************************************
  * Name:  clock_cpuload
@@ -272,8 +722,36 @@ int clock_cpuload(int pid, FAR struct cpuload_s *cpuload)
 
   if (g_pidhash[hash_index].tcb && g_pidhash[hash_index].pid == pid)
     {
+#ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
+      uint64_t total;
+      uint64_t active;
+
+      /* Bring the load average up to date.  Without a timer tick, it is
+       * also scaled back here.
+       */
+
+      nxsched_cpuload_foldall();
+      nxsched_cpuload_decay();
+
+      total  = g_cpuload_total;
+      active = g_pidhash[hash_index].ticks;
+
+      /* Scale the times down so that callers can still compute
+       * 1000 * active / total in 32-bit arithmetic.
+       */
+
+      while (total > UINT32_MAX / 1000)
+        {
+          total  >>= 1;
+          active >>= 1;
+        }
+
+      cpuload->total  = (uint32_t)total;
+      cpuload->active = (uint32_t)active;
+#else
       cpuload->total  = g_cpuload_total;
       cpuload->active = g_pidhash[hash_index].ticks;
+#endif
       ret = OK;
     }
 
@@ -281,4 +759,89 @@ int clock_cpuload(int pid, FAR struct cpuload_s *cpuload)
   return ret;
 }
 
+#ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
+/****************************************************************************
+ * Name:  clock_cpuload_runtime
+ *
+ * Description:
+ *   Return the total time that the selected thread has executed since it
+ *   was started.  Time spent in interrupt handlers is not included.
+ *
+ * Input Parameters:
+ *   pid - The task ID of the thread of interest.  pid == 0 is the IDLE
+ *         thread.
+ *   runtime - The location to return the execution time
+ *
+ * Returned Value:
+ *   OK (0) on success; a negated errno value on failure.  The only reason
+ *   that this function can fail is if 'pid' no longer refers to a valid
+ *   thread.
+ *
+ ****************************************************************************/
+
+int clock_cpuload_runtime(int pid, FAR struct timespec *runtime)
+{
+  irqstate_t flags;
+  uint64_t elapsed;
+  int hash_index = PIDHASH(pid);
+
+  DEBUGASSERT(runtime);
+
+  /* Charge the time accumulated on all CPUs.  The 64-bit time may be
+   * updated by another CPU while we read it.
+   */
+
+  flags = enter_critical_section();
+  if (g_pidhash[hash_index].tcb == NULL || g_pidhash[hash_index].pid != pid)
+    {
+      leave_critical_section(flags);
+      return -ESRCH;
+    }
+
+  nxsched_cpuload_foldall();
+  elapsed = g_pidhash[hash_index].tcb->run_time;
+  leave_critical_section(flags);
+
+  nxsched_cpuload_convert(elapsed, runtime);
+  return OK;
+}
+
+/****************************************************************************
+ * Name:  clock_cpuload_irqtime
+ *
+ * Description:
+ *   Return the total time that the selected CPU has spent in interrupt
+ *   handlers.
+ *
+ * Input Parameters:
+ *   cpu - The index of the CPU of interest.
+ *   irqtime - The location to return the interrupt handling time
+ *
+ * Returned Value:
+ *   OK (0) on success; -EINVAL if 'cpu' is not a valid CPU index.
+ *
+ ****************************************************************************/
+
+int clock_cpuload_irqtime(int cpu, FAR struct timespec *irqtime)
+{
+  irqstate_t flags;
+  uint64_t runtime;
+  uint64_t elapsed;
+
+  DEBUGASSERT(irqtime);
+
+  if (cpu < 0 || cpu >= CPULOAD_NCPUS)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+  nxsched_cpuload_snapshot(cpu, &runtime, &elapsed);
+  leave_critical_section(flags);
+
+  nxsched_cpuload_convert(elapsed, irqtime);
+  return OK;
+}
+#endif /* CONFIG_SCHED_CPULOAD_CRITMONITOR */
+
 #endif /* CONFIG_SCHED_CPULOAD */
@@ -95,11 +95,20 @@ void nxsched_resume_scheduler(FAR struct tcb_s *tcb)
     }
 #endif
 
+#ifdef CONFIG_STACK_USAGE_CACHE
+  /* The thread may use more of its stack once it runs again */
+
+  tcb->flags &= ~(TCB_FLAG_STACK_SCAN | TCB_FLAG_STACK_VALID);
+#endif
+
   /* Indicate the task has been resumed */
 
 #ifdef CONFIG_SCHED_CRITMONITOR
   nxsched_resume_critmon(tcb);
 #endif
+#ifdef CONFIG_SCHED_CPULOAD_CRITMONITOR
+  nxsched_resume_cpuload(tcb);
+#endif
 #ifdef CONFIG_SCHED_INSTRUMENTATION
   sched_note_resume(tcb);
 #endif
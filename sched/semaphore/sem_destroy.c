@@ -87,10 +87,7 @@ int nxsem_destroy (FAR sem_t *sem)
        * leave the count unchanged but still return OK.
        */
 
-      if (sem->semcount >= 0)
-        {
-          sem->semcount = 1;
-        }
+      nxsem_setcount(sem, 1);
 
       /* Release holders of the semaphore */
 
@@ -0,0 +1,169 @@
+/****************************************************************************
+ * sched/semaphore/sem_fastpath.c
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <limits.h>
+#include <semaphore.h>
+#include <assert.h>
+
+#include <nuttx/arch.h>
+
+#include "semaphore/semaphore.h"
+
+#ifdef CONFIG_SEM_FASTPATH
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsem_trytake
+ *
+ * Description:
+ *   Atomically take one count from the semaphore if a count is available.
+ *   The critical section is not entered and no holder is recorded.
+ *
+ * Input Parameters:
+ *   sem - Semaphore descriptor
+ *
+ * Returned Value:
+ *   true if a count was taken; false if the semaphore is not available.
+ *
+ ****************************************************************************/
+
+bool nxsem_trytake(FAR sem_t *sem)
+{
+  int16_t count;
+
+  while ((count = sem->semcount) > 0)
+    {
+      if (up_cmpxchg16(&sem->semcount, count, count - 1))
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: nxsem_trygive
+ *
+ * Description:
+ *   Atomically give one count to the semaphore if no thread is waiting for
+ *   it.  The critical section is not entered and no holder is released.
+ *
+ * Input Parameters:
+ *   sem - Semaphore descriptor
+ *
+ * Returned Value:
+ *   true if the count was given; false if a waiting thread must be woken
+ *   up or if the count would overflow.  The caller must then use the
+ *   slow path.
+ *
+ ****************************************************************************/
+
+bool nxsem_trygive(FAR sem_t *sem)
+{
+  int16_t count;
+
+  while ((count = sem->semcount) >= 0 && count < SEM_VALUE_MAX)
+    {
+      if (up_cmpxchg16(&sem->semcount, count, count + 1))
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: nxsem_addcount
+ *
+ * Description:
+ *   Atomically add 'value' to the semaphore count.  The slow paths use this
+ *   within the critical section because nxsem_trytake() and
+ *   nxsem_trygive() may modify a non-negative count concurrently on
+ *   another CPU.
+ *
+ * Input Parameters:
+ *   sem   - Semaphore descriptor
+ *   value - The value to add to the count
+ *
+ * Returned Value:
+ *   The new semaphore count.
+ *
+ ****************************************************************************/
+
+int16_t nxsem_addcount(FAR sem_t *sem, int16_t value)
+{
+  int16_t count;
+
+  do
+    {
+      count = sem->semcount;
+    }
+  while (!up_cmpxchg16(&sem->semcount, count, count + value));
+
+  return count + value;
+}
+
+/****************************************************************************
+ * Name: nxsem_setcount
+ *
+ * Description:
+ *   Atomically replace a non-negative semaphore count with 'value'.  A
+ *   negative count (i.e., threads are waiting) is left unchanged.  The
+ *   slow paths use this because nxsem_trytake() and nxsem_trygive() may
+ *   modify a non-negative count concurrently on another CPU.
+ *
+ * Input Parameters:
+ *   sem   - Semaphore descriptor
+ *   value - The new, non-negative count
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void nxsem_setcount(FAR sem_t *sem, int16_t value)
+{
+  int16_t count;
+
+  DEBUGASSERT(value >= 0);
+
+  while ((count = sem->semcount) >= 0)
+    {
+      if (up_cmpxchg16(&sem->semcount, count, value))
+        {
+          break;
+        }
+    }
+}
+
+#endif /* CONFIG_SEM_FASTPATH */
@@ -71,8 +71,21 @@ int nxsem_post(FAR sem_t *sem)
 {
   FAR struct tcb_s *stcb = NULL;
   irqstate_t flags;
+  int16_t count;
   int ret = -EINVAL;
 
+#ifdef CONFIG_SEM_FASTPATH
+  /* If no thread is waiting and no holders need to be tracked, then just
+   * give the count.  The critical section is only needed if we have to
+   * wake up a waiting thread.
+   */
+
+  if (sem != NULL && nxsem_noholders(sem) && nxsem_trygive(sem))
+    {
+      return OK;
+    }
+#endif
+
   /* Make sure we were supplied with a valid semaphore. */
 
   if (sem != NULL)
@@ -110,7 +123,7 @@ int nxsem_post(FAR sem_t *sem)
        */
 
       nxsem_release_holder(sem);
-      sem->semcount++;
+      count = nxsem_addcount(sem, 1);
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
       /* Don't let any unblocked tasks run until we complete any priority
@@ -127,7 +140,7 @@ int nxsem_post(FAR sem_t *sem)
        * there must be some task waiting for the semaphore.
        */
 
-      if (sem->semcount <= 0)
+      if (count <= 0)
         {
           /* Check if there are any tasks in the waiting for semaphore
            * task list that are waiting for this semaphore. This is a
@@ -108,13 +108,12 @@ int nxsem_reset(FAR sem_t *sem, int16_t count)
    * (i.e., with sem->semcount >= 0).  In this case, 'count' holds the
    * the new value of the semaphore count.  OR (2) with threads still
    * waiting but all of the semaphore counts exhausted:  The current
-   * value of sem->semcount is already correct in this case.
+   * value of sem->semcount is already correct in this case.  The count
+   * is replaced atomically because the fast path may modify a
+   * non-negative count on another CPU.
    */
 
-  if (sem->semcount >= 0)
-    {
-      sem->semcount = count;
-    }
+  nxsem_setcount(sem, count);
 
   /* Allow any pending context switches to occur now */
 
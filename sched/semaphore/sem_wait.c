@@ -77,6 +77,18 @@ int nxsem_wait(FAR sem_t *sem)
 
   DEBUGASSERT(sem != NULL && up_interrupt_context() == false);
 
+#ifdef CONFIG_SEM_FASTPATH
+  /* If the semaphore is available and no holders need to be tracked, then
+   * just take the count.  The critical section is only needed if we have
+   * to block.
+   */
+
+  if (sem != NULL && nxsem_noholders(sem) && nxsem_trytake(sem))
+    {
+      return OK;
+    }
+#endif
+
   /* The following operations must be performed with interrupts
    * disabled because nxsem_post() may be called from an interrupt
    * handler.
@@ -88,13 +100,14 @@ int nxsem_wait(FAR sem_t *sem)
 
   if (sem != NULL)
     {
-      /* Check if the lock is available */
+      /* Take the count.  The lock was available if the count was
+       * positive.
+       */
 
-      if (sem->semcount > 0)
+      if (nxsem_addcount(sem, -1) >= 0)
         {
-          /* It is, let the task take the semaphore. */
+          /* It was, let the task take the semaphore. */
 
-          sem->semcount--;
           nxsem_add_holder(sem);
           rtcb->waitsem = NULL;
           ret = OK;
@@ -112,10 +125,6 @@ int nxsem_wait(FAR sem_t *sem)
 
           DEBUGASSERT(rtcb->waitsem == NULL);
 
-          /* Handle the POSIX semaphore (but don't set the owner yet) */
-
-          sem->semcount--;
-
           /* Save the waited on semaphore in the TCB */
 
           rtcb->waitsem = sem;
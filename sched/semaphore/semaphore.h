@@ -34,6 +34,37 @@
 #include <sched.h>
 #include <queue.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Semaphores that track holders for priority inheritance cannot use the
+ * fast path.
+ */
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+#  define nxsem_noholders(s) (((s)->flags & PRIOINHERIT_FLAGS_DISABLE) != 0)
+#else
+#  define nxsem_noholders(s) (true)
+#endif
+
+/* Without the fast path, the count is only modified within the critical
+ * section and needs no atomic operation.
+ */
+
+#ifndef CONFIG_SEM_FASTPATH
+#  define nxsem_addcount(s,v) ((s)->semcount += (v))
+#  define nxsem_setcount(s,v) \
+  do \
+    { \
+      if ((s)->semcount >= 0) \
+        { \
+          (s)->semcount = (v); \
+        } \
+    } \
+  while (0)
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -54,6 +85,15 @@ void nxsem_initialize(void);
 #  define nxsem_initialize()
 #endif
 
+/* Atomic fast path for uncontended semaphores */
+
+#ifdef CONFIG_SEM_FASTPATH
+bool nxsem_trytake(FAR sem_t *sem);
+bool nxsem_trygive(FAR sem_t *sem);
+int16_t nxsem_addcount(FAR sem_t *sem, int16_t value);
+void nxsem_setcount(FAR sem_t *sem, int16_t value);
+#endif
+
 /* Wake up a thread that is waiting on semaphore */
 
 void nxsem_wait_irq(FAR struct tcb_s *wtcb, int errcode);
@@ -40,9 +40,12 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdbool.h>
+#include <string.h>
 #include <sched.h>
 #include <assert.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/spinlock.h>
 #include <nuttx/sched_note.h>
 #include <arch/irq.h>
@@ -51,6 +54,176 @@
 
 #ifdef CONFIG_SPINLOCK
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Layout of the read/write spinlock state */
+
+#define RW_WRITER      0x8000  /* A writer holds the lock */
+#define RW_PENDING     0x4000  /* A writer waits, hold off new readers */
+#define RW_READERS     0x3fff  /* Number of readers holding the lock */
+
+#ifdef CONFIG_SPINLOCK_STATS
+/* Readers of a read/write lock update its statistics concurrently, so the
+ * counters are incremented atomically.
+ */
+
+#define SPINLOCK_STATS_INC(c) up_fetchadd32((FAR volatile int32_t *)(c), 1)
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_STATS
+/* List of registered lock statistics and the lock that protects it */
+
+static FAR struct spinlock_stats_s *g_spinlock_stats;
+static spinlock_t g_spinlock_stats_lock;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+#ifdef CONFIG_SPINLOCK_STATS
+/****************************************************************************
+ * Name: spinlock_stats_update
+ *
+ * Description:
+ *   Account one wait or hold time in a histogram and the matching maximum.
+ *   There is no 32-bit compare-and-exchange to update the maximum with, so
+ *   concurrent readers may lose a new maximum to each other.  It is exact
+ *   for exclusive owners.
+ *
+ ****************************************************************************/
+
+static void spinlock_stats_update(FAR uint32_t *hist, FAR uint32_t *max,
+                                  uint32_t elapsed)
+{
+  unsigned int bucket = 0;
+
+  if (elapsed > *max)
+    {
+      *max = elapsed;
+    }
+
+  while ((elapsed >>= 1) != 0 && bucket < SPINLOCK_STATS_NHIST - 1)
+    {
+      bucket++;
+    }
+
+  SPINLOCK_STATS_INC(&hist[bucket]);
+}
+
+/****************************************************************************
+ * Name: spinlock_stats_acquired
+ *
+ * Description:
+ *   Called with the lock held.  'start' is the time at which the caller
+ *   started to spin, or zero if the lock was free.
+ *
+ ****************************************************************************/
+
+static void spinlock_stats_acquired(FAR struct spinlock_stats_s *stats,
+                                    uint32_t start, bool exclusive)
+{
+  uint32_t now = up_critmon_gettime();
+
+  SPINLOCK_STATS_INC(&stats->nacquired);
+  if (start != 0)
+    {
+      SPINLOCK_STATS_INC(&stats->ncontended);
+      spinlock_stats_update(stats->wait, &stats->maxwait, now - start);
+    }
+
+  if (exclusive)
+    {
+      stats->start = now;
+    }
+}
+
+/****************************************************************************
+ * Name: spinlock_stats_released
+ *
+ * Description:
+ *   Called by an exclusive owner before releasing the lock.
+ *
+ ****************************************************************************/
+
+static void spinlock_stats_released(FAR struct spinlock_stats_s *stats)
+{
+  spinlock_stats_update(stats->hold, &stats->maxhold,
+                        up_critmon_gettime() - stats->start);
+}
+
+/* A non-zero start time marks an acquisition that had to spin */
+
+#  define SPINLOCK_STATS_START() (up_critmon_gettime() | 1)
+#else
+#  define SPINLOCK_STATS_START() 1
+#  define spinlock_stats_acquired(s,t,e)
+#  define spinlock_stats_released(s)
+#endif
+
+#ifdef HAVE_TICKET_SPINLOCK
+/****************************************************************************
+ * Name: rwlock_tryread
+ ****************************************************************************/
+
+static bool rwlock_tryread(FAR rwlock_t *lock)
+{
+  uint16_t state = (uint16_t)lock->state;
+
+  while ((state & (RW_WRITER | RW_PENDING)) == 0)
+    {
+      DEBUGASSERT((state & RW_READERS) != RW_READERS);
+
+      if (up_cmpxchg16(&lock->state, (int16_t)state,
+                       (int16_t)(state + 1)))
+        {
+          SP_DMB();
+          return true;
+        }
+
+      state = (uint16_t)lock->state;
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: rwlock_trywrite
+ *
+ * Description:
+ *   Take the lock for writing if there are neither readers nor a writer.
+ *   Otherwise, if 'pend' is true, announce the waiting writer.
+ *
+ ****************************************************************************/
+
+static bool rwlock_trywrite(FAR rwlock_t *lock, bool pend)
+{
+  uint16_t state = (uint16_t)lock->state;
+
+  if ((state & ~RW_PENDING) == 0)
+    {
+      if (up_cmpxchg16(&lock->state, (int16_t)state, (int16_t)RW_WRITER))
+        {
+          SP_DMB();
+          return true;
+        }
+    }
+  else if (pend && (state & RW_PENDING) == 0)
+    {
+      up_cmpxchg16(&lock->state, (int16_t)state,
+                   (int16_t)(state | RW_PENDING));
+    }
+
+  return false;
+}
+#endif /* HAVE_TICKET_SPINLOCK */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -395,4 +568,407 @@ void spin_clrbit(FAR volatile cpu_set_t *set, unsigned int cpu,
 }
 #endif
 
+#ifdef HAVE_TICKET_SPINLOCK
+/****************************************************************************
+ * Name: ticket_spin_lock
+ *
+ * Description:
+ *   Take a ticket and spin until the lock is handed over to that ticket.
+ *   Unlike spin_lock(), waiters are served in first-come, first-served
+ *   order so no CPU can be starved under contention.
+ *
+ * Input Parameters:
+ *   lock - A reference to the ticket spinlock object to lock.
+ *
+ * Returned Value:
+ *   None.  When the function returns, the spinlock was successfully locked
+ *   by this CPU.
+ *
+ ****************************************************************************/
+
+void ticket_spin_lock(FAR ticket_spinlock_t *lock)
+{
+  uint32_t start = 0;
+  uint16_t ticket;
+
+  /* up_fetchadd16() returns the incremented value.  Compare tickets as
+   * unsigned 16-bit values so that wrap-around is harmless.
+   */
+
+  ticket = (uint16_t)(up_fetchadd16(&lock->next, 1) - 1);
+  if ((uint16_t)lock->owner != ticket)
+    {
+      start = SPINLOCK_STATS_START();
+      while ((uint16_t)lock->owner != ticket)
+        {
+          SP_DSB();
+        }
+    }
+
+  SP_DMB();
+  spinlock_stats_acquired(&lock->stats, start, true);
+  UNUSED(start);
+}
+
+/****************************************************************************
+ * Name: ticket_spin_trylock
+ *
+ * Description:
+ *   Take the ticket spinlock only if it is free and nobody is waiting.
+ *
+ * Input Parameters:
+ *   lock - A reference to the ticket spinlock object to lock.
+ *
+ * Returned Value:
+ *   SP_LOCKED - Failure, the spinlock was already locked
+ *   SP_UNLOCKED - Success, the spinlock was successfully locked
+ *
+ ****************************************************************************/
+
+spinlock_t ticket_spin_trylock(FAR ticket_spinlock_t *lock)
+{
+  int16_t owner = lock->owner;
+
+  if (lock->next != owner ||
+      !up_cmpxchg16(&lock->next, owner, (int16_t)(owner + 1)))
+    {
+      SP_DSB();
+      return SP_LOCKED;
+    }
+
+  SP_DMB();
+  spinlock_stats_acquired(&lock->stats, 0, true);
+  return SP_UNLOCKED;
+}
+
+/****************************************************************************
+ * Name: ticket_spin_unlock
+ *
+ * Description:
+ *   Hand the ticket spinlock over to the next waiter, if any.  Only the
+ *   lock holder modifies the owner field so no atomic operation is needed.
+ *
+ * Input Parameters:
+ *   lock - A reference to the ticket spinlock object to unlock.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void ticket_spin_unlock(FAR ticket_spinlock_t *lock)
+{
+  spinlock_stats_released(&lock->stats);
+
+  SP_DMB();
+  lock->owner = (int16_t)(lock->owner + 1);
+  SP_DSB();
+}
+
+/****************************************************************************
+ * Name: read_lock
+ *
+ * Description:
+ *   Take a read/write spinlock for reading.  Spins while a writer holds
+ *   the lock or is waiting for it.
+ *
+ * Input Parameters:
+ *   lock - A reference to the read/write spinlock object.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void read_lock(FAR rwlock_t *lock)
+{
+  uint32_t start = 0;
+
+  if (!rwlock_tryread(lock))
+    {
+      start = SPINLOCK_STATS_START();
+      while (!rwlock_tryread(lock))
+        {
+          SP_DSB();
+        }
+    }
+
+  spinlock_stats_acquired(&lock->stats, start, false);
+  UNUSED(start);
+}
+
+/****************************************************************************
+ * Name: read_trylock
+ *
+ * Description:
+ *   Take a read/write spinlock for reading if no writer holds or waits for
+ *   it.
+ *
+ * Input Parameters:
+ *   lock - A reference to the read/write spinlock object.
+ *
+ * Returned Value:
+ *   SP_LOCKED - Failure, a writer holds or waits for the lock
+ *   SP_UNLOCKED - Success, the lock is held for reading
+ *
+ ****************************************************************************/
+
+spinlock_t read_trylock(FAR rwlock_t *lock)
+{
+  if (!rwlock_tryread(lock))
+    {
+      SP_DSB();
+      return SP_LOCKED;
+    }
+
+  spinlock_stats_acquired(&lock->stats, 0, false);
+  return SP_UNLOCKED;
+}
+
+/****************************************************************************
+ * Name: read_unlock
+ *
+ * Description:
+ *   Release a read/write spinlock held for reading.
+ *
+ * Input Parameters:
+ *   lock - A reference to the read/write spinlock object.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void read_unlock(FAR rwlock_t *lock)
+{
+  DEBUGASSERT(((uint16_t)lock->state & RW_READERS) != 0);
+
+  SP_DMB();
+  up_fetchsub16(&lock->state, 1);
+  SP_DSB();
+}
+
+/****************************************************************************
+ * Name: write_lock
+ *
+ * Description:
+ *   Take a read/write spinlock for writing.  While waiting for the readers
+ *   to leave, new readers are held off.
+ *
+ * Input Parameters:
+ *   lock - A reference to the read/write spinlock object.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void write_lock(FAR rwlock_t *lock)
+{
+  uint32_t start = 0;
+
+  if (!rwlock_trywrite(lock, true))
+    {
+      start = SPINLOCK_STATS_START();
+      while (!rwlock_trywrite(lock, true))
+        {
+          SP_DSB();
+        }
+    }
+
+  spinlock_stats_acquired(&lock->stats, start, true);
+  UNUSED(start);
+}
+
+/****************************************************************************
+ * Name: write_trylock
+ *
+ * Description:
+ *   Take a read/write spinlock for writing if it is not held.
+ *
+ * Input Parameters:
+ *   lock - A reference to the read/write spinlock object.
+ *
+ * Returned Value:
+ *   SP_LOCKED - Failure, the lock is held
+ *   SP_UNLOCKED - Success, the lock is held for writing
+ *
+ ****************************************************************************/
+
+spinlock_t write_trylock(FAR rwlock_t *lock)
+{
+  if (!rwlock_trywrite(lock, false))
+    {
+      SP_DSB();
+      return SP_LOCKED;
+    }
+
+  spinlock_stats_acquired(&lock->stats, 0, true);
+  return SP_UNLOCKED;
+}
+
+/****************************************************************************
+ * Name: write_unlock
+ *
+ * Description:
+ *   Release a read/write spinlock held for writing.  A writer that is
+ *   waiting may have set the pending flag in the meantime; it is kept.
+ *
+ * Input Parameters:
+ *   lock - A reference to the read/write spinlock object.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void write_unlock(FAR rwlock_t *lock)
+{
+  uint16_t state;
+
+  DEBUGASSERT(((uint16_t)lock->state & RW_WRITER) != 0);
+  spinlock_stats_released(&lock->stats);
+
+  SP_DMB();
+  do
+    {
+      state = (uint16_t)lock->state;
+    }
+  while (!up_cmpxchg16(&lock->state, (int16_t)state,
+                       (int16_t)(state & ~RW_WRITER)));
+
+  SP_DSB();
+}
+#endif /* HAVE_TICKET_SPINLOCK */
+
+#ifdef CONFIG_SPINLOCK_STATS
+/****************************************************************************
+ * Name: spinlock_stats_register
+ *
+ * Description:
+ *   Add the statistics of a lock to the list reported by /proc/spinlocks.
+ *
+ * Input Parameters:
+ *   stats - The statistics embedded in the lock
+ *   name  - Name of the lock.  The string must persist.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void spinlock_stats_register(FAR struct spinlock_stats_s *stats,
+                             FAR const char *name)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(stats != NULL && name != NULL);
+
+  flags = up_irq_save();
+  spin_lock(&g_spinlock_stats_lock);
+
+  stats->name       = name;
+  stats->flink      = g_spinlock_stats;
+  g_spinlock_stats  = stats;
+
+  spin_unlock(&g_spinlock_stats_lock);
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Name: spinlock_stats_unregister
+ *
+ * Description:
+ *   Remove the statistics of a lock from the list reported by
+ *   /proc/spinlocks.  Must be called before the lock memory is released.
+ *
+ * Input Parameters:
+ *   stats - The statistics embedded in the lock
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void spinlock_stats_unregister(FAR struct spinlock_stats_s *stats)
+{
+  FAR struct spinlock_stats_s **prev;
+  irqstate_t flags;
+
+  flags = up_irq_save();
+  spin_lock(&g_spinlock_stats_lock);
+
+  for (prev = &g_spinlock_stats; *prev != NULL; prev = &(*prev)->flink)
+    {
+      if (*prev == stats)
+        {
+          *prev        = stats->flink;
+          stats->flink = NULL;
+          break;
+        }
+    }
+
+  spin_unlock(&g_spinlock_stats_lock);
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Name: spinlock_stats_snapshot
+ *
+ * Description:
+ *   Copy the statistics of the most contended registered locks, most
+ *   contended first.
+ *
+ * Input Parameters:
+ *   buffer - Location to receive the copies
+ *   nmax   - Maximum number of entries in buffer
+ *
+ * Returned Value:
+ *   The number of entries copied.
+ *
+ ****************************************************************************/
+
+int spinlock_stats_snapshot(FAR struct spinlock_stats_s *buffer, int nmax)
+{
+  FAR struct spinlock_stats_s *stats;
+  irqstate_t flags;
+  int nused = 0;
+  int i;
+
+  flags = up_irq_save();
+  spin_lock(&g_spinlock_stats_lock);
+
+  /* Insertion sort into the caller's buffer, keeping the top 'nmax' */
+
+  for (stats = g_spinlock_stats; stats != NULL; stats = stats->flink)
+    {
+      for (i = nused; i > 0; i--)
+        {
+          if (buffer[i - 1].ncontended >= stats->ncontended)
+            {
+              break;
+            }
+
+          if (i < nmax)
+            {
+              buffer[i] = buffer[i - 1];
+            }
+        }
+
+      if (i < nmax)
+        {
+          buffer[i] = *stats;
+          if (nused < nmax)
+            {
+              nused++;
+            }
+        }
+    }
+
+  spin_unlock(&g_spinlock_stats_lock);
+  up_irq_restore(flags);
+  return nused;
+}
+#endif /* CONFIG_SPINLOCK_STATS */
+
 #endif /* CONFIG_SPINLOCK */